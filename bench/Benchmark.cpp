@@ -0,0 +1,138 @@
+#include "Benchmark.hpp"
+#include "JsonUtil.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <exception>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+    using Clock = chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return chrono::duration<double, milli>(Clock::now() - start).count();
+    }
+
+    string compilerName() {
+#if defined(__clang__)
+        return "clang " + to_string(__clang_major__) + "." + to_string(__clang_minor__);
+#elif defined(__GNUC__)
+        return "gcc " + to_string(__GNUC__) + "." + to_string(__GNUC_MINOR__);
+#elif defined(_MSC_VER)
+        return "msvc " + to_string(_MSC_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+    string resultJson(const BenchmarkResult& result) {
+        JsonObject json;
+        json.add("name", result.name).add("students", result.students).add("repetitions", result.repetitions);
+        json.add("minMs", result.minMs).add("medianMs", result.medianMs).add("p99Ms", result.p99Ms);
+        json.add("meanMs", result.meanMs).add("opsPerSec", result.opsPerSec).add("bytesPerSec", result.bytesPerSec);
+        json.add("bytes", static_cast<size_t>(result.bytes));
+        if (!result.error.empty()) json.add("error", result.error);
+        return json.str();
+    }
+}
+
+double Benchmark::percentile(std::vector<double> samples, double percent) {
+    if (samples.empty()) return 0.0;
+    sort(samples.begin(), samples.end());
+    double rank = ceil(percent / 100.0 * static_cast<double>(samples.size()));
+    size_t index = rank < 1.0 ? 0 : static_cast<size_t>(rank) - 1;
+    return samples[min(index, samples.size() - 1)];
+}
+
+BenchmarkResult Benchmark::run(const std::string& name, size_t students, const BenchmarkOptions& options,
+                               const Body& body) {
+    BenchmarkResult result;
+    result.name = name;
+    result.students = students;
+
+    Clock::time_point caseStart = Clock::now();
+    double budgetMs = options.maxSecondsPerCase * 1000.0;
+    vector<double> samples;
+    try {
+        for (int i = 0; i < options.warmup && millisecondsSince(caseStart) < budgetMs; ++i) {
+            body();
+        }
+        for (int i = 0; i < options.repetitions; ++i) {
+            if (!samples.empty() && millisecondsSince(caseStart) >= budgetMs) break;
+            Clock::time_point start = Clock::now();
+            result.bytes = body();
+            samples.push_back(millisecondsSince(start));
+        }
+    } catch (const exception& e) {
+        result.error = e.what();
+    }
+
+    result.repetitions = static_cast<int>(samples.size());
+    if (samples.empty()) return result;
+
+    result.minMs = *min_element(samples.begin(), samples.end());
+    result.medianMs = percentile(samples, 50.0);
+    result.p99Ms = percentile(samples, 99.0);
+    result.meanMs = accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+    if (result.medianMs > 0.0) {
+        double seconds = result.medianMs / 1000.0;
+        result.opsPerSec = static_cast<double>(students) / seconds;
+        result.bytesPerSec = static_cast<double>(result.bytes) / seconds;
+    }
+    return result;
+}
+
+std::string Benchmark::toJson(const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options) {
+    JsonObject settings;
+    settings.add("compiler", compilerName());
+#ifdef NDEBUG
+    settings.add("optimized", true);
+#else
+    settings.add("optimized", false);
+#endif
+    settings.add("threads", TaskScheduler::shared().threadCount());
+    settings.add("warmup", options.warmup).add("repetitions", options.repetitions);
+    settings.add("maxSecondsPerCase", options.maxSecondsPerCase);
+
+    string out = "{\n  \"benchmark\": " + settings.str() + ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        out += "    " + resultJson(results[i]);
+        out += (i + 1 < results.size()) ? ",\n" : "\n";
+    }
+    out += "  ]\n}\n";
+    return out;
+}
+
+std::string Benchmark::tableHeader() {
+    ostringstream out;
+    out << left << setw(22) << "Case" << right << setw(10) << "Students" << setw(6) << "Reps" << setw(12) << "Median ms"
+        << setw(12) << "p99 ms" << setw(14) << "Students/s" << setw(10) << "MB/s" << "\n";
+    return out.str();
+}
+
+std::string Benchmark::tableRow(const BenchmarkResult& result) {
+    ostringstream out;
+    out << fixed << setprecision(2);
+    out << left << setw(22) << result.name << right << setw(10) << result.students;
+    if (!result.error.empty() && result.repetitions == 0) {
+        out << "  failed: " << result.error << "\n";
+        return out.str();
+    }
+    out << setw(6) << result.repetitions << setw(12) << result.medianMs << setw(12) << result.p99Ms
+        << setw(14) << setprecision(0) << result.opsPerSec << setprecision(2) << setw(10)
+        << result.bytesPerSec / (1024.0 * 1024.0);
+    if (!result.error.empty()) out << "  (then failed: " << result.error << ")";
+    out << "\n";
+    return out.str();
+}
+
+std::string Benchmark::toTable(const std::vector<BenchmarkResult>& results) {
+    string out = tableHeader();
+    for (const auto& result : results) out += tableRow(result);
+    return out;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct BenchmarkOptions {
+    int warmup = 1;                    // unmeasured runs before the repetitions
+    int repetitions = 5;
+    double maxSecondsPerCase = 60.0;   // fewer repetitions (at least one) once spent
+};
+
+struct BenchmarkResult {
+    std::string name;
+    size_t students = 0;
+    int repetitions = 0;               // measured runs actually made
+    double minMs = 0.0;
+    double medianMs = 0.0;
+    double p99Ms = 0.0;                // nearest rank; the slowest run when there are few
+    double meanMs = 0.0;
+    double opsPerSec = 0.0;            // students handled per second, at the median
+    double bytesPerSec = 0.0;          // bytes read or written per second, at the median; 0 if none
+    std::uint64_t bytes = 0;           // per run
+    std::string error;                 // empty unless a run threw
+};
+
+// Microbenchmark runner: warm up, time each repetition with a steady
+// clock, then summarize. A body performs one run over the whole roster
+// and returns the bytes it read or wrote (0 when it has no I/O); its
+// setup belongs outside, so only the work itself is timed.
+class Benchmark {
+public:
+    using Body = std::function<std::uint64_t()>;
+
+    static BenchmarkResult run(const std::string& name, size_t students, const BenchmarkOptions& options,
+                               const Body& body);
+
+    // Nearest-rank percentile (0-100) of the samples
+    static double percentile(std::vector<double> samples, double percent);
+
+    // {"benchmark": ..., "results": [...]} with one result per line, in
+    // run order, so two runs can be compared with diff
+    static std::string toJson(const std::vector<BenchmarkResult>& results, const BenchmarkOptions& options);
+
+    // Aligned table for the terminal, or its lines one at a time
+    static std::string toTable(const std::vector<BenchmarkResult>& results);
+    static std::string tableHeader();
+    static std::string tableRow(const BenchmarkResult& result);
+};
@@ -0,0 +1,316 @@
+// scoreme_bench: times the roster hot paths at several roster sizes and
+// writes the results as JSON. Run from a release build, e.g.
+//
+//   scoreme_bench --sizes 1k,100k,1m --out bench_results.json
+//
+// Cases run in the order below; the rosters are synthetic but fixed (same
+// seed every run), so two result files compare like for like.
+#include "Admin.hpp"
+#include "Benchmark.hpp"
+#include "ExcelUtil.hpp"
+#include "MenuUtils.hpp"
+#include "SortEngine.hpp"
+#include "Student.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+
+using namespace std;
+
+namespace {
+    const size_t SUBJECT_COUNT = 7;
+    const unsigned ROSTER_SEED = 20240601;
+
+    const vector<string> CASES = {
+        "updateAllGrades",
+        "sortStudentsByScore",
+        "displayTable",
+        "writeExcel",
+        "readExcelToVector"
+    };
+
+    struct BenchSettings {
+        BenchmarkOptions options;
+        vector<size_t> sizes = {1000, 100000, 1000000};
+        vector<string> cases = CASES;
+        string outPath;                      // stdout when empty
+        string workDirectory = "bench_data";
+    };
+
+    // Counts what displayTable writes instead of sending it to the terminal
+    class CountingBuffer : public streambuf {
+    public:
+        uint64_t count = 0;
+
+    protected:
+        int_type overflow(int_type c) override {
+            if (!traits_type::eq_int_type(c, traits_type::eof())) count++;
+            return traits_type::not_eof(c);
+        }
+        streamsize xsputn(const char*, streamsize n) override {
+            count += static_cast<uint64_t>(n);
+            return n;
+        }
+    };
+
+    vector<string> splitList(const string& text) {
+        vector<string> items;
+        stringstream stream(text);
+        string item;
+        while (getline(stream, item, ',')) {
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    }
+
+    // "1000", "100k", "1m"
+    size_t parseSize(string text) {
+        size_t multiplier = 1;
+        if (!text.empty() && (text.back() == 'k' || text.back() == 'K')) multiplier = 1000;
+        if (!text.empty() && (text.back() == 'm' || text.back() == 'M')) multiplier = 1000000;
+        if (multiplier != 1) text.pop_back();
+        size_t used = 0;
+        unsigned long long value = 0;
+        try {
+            value = stoull(text, &used);
+        } catch (const exception&) {
+            used = 0;
+        }
+        if (used == 0 || used != text.size() || value == 0) {
+            throw invalid_argument("bad roster size '" + text + "'");
+        }
+        return static_cast<size_t>(value) * multiplier;
+    }
+
+    double parsePositive(const string& text, const string& what) {
+        size_t used = 0;
+        double value = 0.0;
+        try {
+            value = stod(text, &used);
+        } catch (const exception&) {
+            used = 0;
+        }
+        if (used == 0 || used != text.size() || value < 0.0) {
+            throw invalid_argument(what + " expects a non-negative number, got '" + text + "'");
+        }
+        return value;
+    }
+
+    string usage() {
+        return "Usage: scoreme_bench [--sizes 1k,100k,1m] [--cases name,...] [--warmup N] [--repetitions N]\n"
+               "                     [--max-seconds S] [--threads N] [--dir <work dir>] [--out <results.json>]\n"
+               "Cases: updateAllGrades, sortStudentsByScore, displayTable, writeExcel, readExcelToVector\n";
+    }
+
+    BenchSettings parseArguments(const vector<string>& args) {
+        BenchSettings settings;
+        for (size_t i = 0; i < args.size(); ++i) {
+            const string& flag = args[i];
+            if (flag == "--help" || flag == "-h") throw invalid_argument("");
+            if (i + 1 >= args.size()) throw invalid_argument(flag + " needs a value");
+            const string& value = args[++i];
+
+            if (flag == "--sizes") {
+                settings.sizes.clear();
+                for (const auto& item : splitList(value)) settings.sizes.push_back(parseSize(item));
+            } else if (flag == "--cases") {
+                settings.cases = splitList(value);
+                for (const auto& name : settings.cases) {
+                    if (find(CASES.begin(), CASES.end(), name) == CASES.end()) {
+                        throw invalid_argument("unknown case '" + name + "'");
+                    }
+                }
+            } else if (flag == "--warmup") {
+                settings.options.warmup = static_cast<int>(parsePositive(value, flag));
+            } else if (flag == "--repetitions") {
+                settings.options.repetitions = max(1, static_cast<int>(parsePositive(value, flag)));
+            } else if (flag == "--max-seconds") {
+                settings.options.maxSecondsPerCase = parsePositive(value, flag);
+            } else if (flag == "--threads") {
+                double threads = parsePositive(value, flag);
+                if (threads < 1 || threads != floor(threads)) throw invalid_argument("--threads expects a positive whole number");
+                TaskScheduler::setThreadCount(static_cast<size_t>(threads));
+            } else if (flag == "--dir") {
+                settings.workDirectory = value;
+            } else if (flag == "--out") {
+                settings.outPath = value;
+            } else {
+                throw invalid_argument("unknown option " + flag);
+            }
+        }
+        if (settings.sizes.empty() || settings.cases.empty()) throw invalid_argument("nothing to run");
+        return settings;
+    }
+
+    // Deterministic roster: the same count always gives the same students
+    vector<Student> makeRoster(size_t count) {
+        static const vector<string> firstNames = {
+            "Theara", "Sophanny", "Nodiya", "Sarah", "Dara", "Lisa", "Sitha", "Thida", "Ravuth", "Sovanna",
+            "Bopha", "Chenda", "Kosal", "Malis", "Piseth", "Rachana", "Sokha", "Vanna", "Visal", "Chantrea"
+        };
+        static const vector<string> lastNames = {
+            "Lavy", "Nai", "Phong", "Davis", "Chan", "Sarun", "Nat", "Tep", "Rong", "Phy",
+            "Keo", "Heng", "Chea", "Sok", "Meas", "Ouk", "Pen", "Sam", "Yim", "Long"
+        };
+        static const vector<string> genders = {"Male", "Female"};
+
+        mt19937 random(ROSTER_SEED);
+        normal_distribution<double> score(68.0, 15.0);
+        uniform_int_distribution<int> age(17, 24);
+        uniform_int_distribution<int> month(1, 12);
+        uniform_int_distribution<int> day(1, 28);
+
+        vector<Student> students;
+        students.reserve(count);
+        vector<double> scores(SUBJECT_COUNT);
+        for (size_t i = 0; i < count; ++i) {
+            const string& first = firstNames[random() % firstNames.size()];
+            const string& last = lastNames[random() % lastNames.size()];
+            for (auto& value : scores) {
+                value = round(min(100.0, max(0.0, score(random))) * 10.0) / 10.0;
+            }
+            int studentAge = age(random);
+            string email = first + last + to_string(i + 1) + "@gmail.com";
+            transform(email.begin(), email.end(), email.begin(), ::tolower);
+            char dateOfBirth[11];
+            snprintf(dateOfBirth, sizeof(dateOfBirth), "%04d-%02d-%02d", 2025 - studentAge, month(random), day(random));
+
+            students.emplace_back(Admin::formatStudentId(static_cast<int>(i + 1)), first + " " + last, studentAge,
+                                  genders[i % genders.size()], dateOfBirth, email, scores);
+        }
+        return students;
+    }
+
+    uint64_t fileSize(const string& path) {
+        return static_cast<uint64_t>(filesystem::file_size(path));
+    }
+
+    BenchmarkResult runCase(const string& name, vector<Student>& students, const BenchSettings& settings,
+                            bool& workbookCurrent) {
+        const BenchmarkOptions& options = settings.options;
+        size_t count = students.size();
+        string workbook = (filesystem::path(settings.workDirectory) / "bench_roster.xlsx").string();
+
+        if (name == "updateAllGrades") {
+            return Benchmark::run(name, count, options, [&students] {
+                for (auto& student : students) student.updateAllGrades();
+                return uint64_t(0);
+            });
+        }
+        if (name == "sortStudentsByScore") {
+            // The order Admin::sortStudentsByScore shows: average, then name
+            return Benchmark::run(name, count, options, [&students] {
+                vector<uint32_t> order = SortEngine::sortedPermutation(students, {
+                    {SortKey::AverageScore, true},
+                    {SortKey::Name, false}
+                });
+                if (order.size() != students.size()) throw runtime_error("sort lost rows");
+                return uint64_t(0);
+            });
+        }
+        if (name == "displayTable") {
+            return Benchmark::run(name, count, options, [&students] {
+                CountingBuffer sink;
+                streambuf* terminal = cout.rdbuf(&sink);
+                try {
+                    MenuUtils::displayTable(students);
+                } catch (...) {
+                    cout.rdbuf(terminal);
+                    throw;
+                }
+                cout.rdbuf(terminal);
+                return sink.count;
+            });
+        }
+        if (name == "writeExcel") {
+            BenchmarkResult result = Benchmark::run(name, count, options, [&students, &workbook] {
+                ExcelUtils::writeExcel(workbook, students);
+                return fileSize(workbook);
+            });
+            workbookCurrent = result.repetitions > 0;
+            return result;
+        }
+        if (name == "readExcelToVector") {
+            if (!workbookCurrent) {
+                ExcelUtils::writeExcel(workbook, students);   // input only; not timed
+                workbookCurrent = true;
+            }
+            return Benchmark::run(name, count, options, [&workbook, count] {
+                vector<Student> loaded = ExcelUtils::readExcelToVector(workbook);
+                if (loaded.size() != count) {
+                    throw runtime_error("read " + to_string(loaded.size()) + " students, expected " + to_string(count));
+                }
+                return fileSize(workbook);
+            });
+        }
+        throw invalid_argument("unknown case '" + name + "'");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchSettings settings;
+    try {
+        settings = parseArguments(vector<string>(argv + 1, argv + argc));
+    } catch (const invalid_argument& e) {
+        if (*e.what()) cerr << "error: " << e.what() << "\n";
+        cerr << usage();
+        return 2;
+    }
+
+    // No screens, pagers or colors; status messages go to stderr
+    MenuUtils::setHeadless(true);
+
+    vector<BenchmarkResult> results;
+    try {
+        filesystem::create_directories(settings.workDirectory);
+        for (size_t size : settings.sizes) {
+            cerr << "Building a roster of " << size << " students...\n";
+            vector<Student> students = makeRoster(size);
+            bool workbookCurrent = false;
+            cerr << Benchmark::tableHeader();
+
+            for (const auto& name : CASES) {
+                if (find(settings.cases.begin(), settings.cases.end(), name) == settings.cases.end()) continue;
+
+                // Messages printed by the code under test are held until the case is done
+                MenuUtils::setDeferredOutput(true);
+                BenchmarkResult result = runCase(name, students, settings, workbookCurrent);
+                MenuUtils::setDeferredOutput(false);
+                MenuUtils::flushDeferredMessages();
+
+                cerr << Benchmark::tableRow(result);
+                results.push_back(result);
+            }
+        }
+    } catch (const exception& e) {
+        MenuUtils::setDeferredOutput(false);
+        MenuUtils::flushDeferredMessages();
+        cerr << "error: " << e.what() << "\n";
+        return 1;
+    }
+
+    cerr << "\n" << Benchmark::toTable(results);
+
+    string json = Benchmark::toJson(results, settings.options);
+    if (settings.outPath.empty()) {
+        cout << json;
+    } else {
+        ofstream out(settings.outPath, ios::binary);
+        out << json;
+        if (!out) {
+            cerr << "error: could not write " << settings.outPath << "\n";
+            return 1;
+        }
+        cerr << "Results written to " << settings.outPath << "\n";
+    }
+
+    bool failed = any_of(results.begin(), results.end(), [](const BenchmarkResult& r) { return !r.error.empty(); });
+    return failed ? 1 : 0;
+}
@@ -1,17 +1,41 @@
 #pragma once
 #include "Person.hpp"
 #include "Student.hpp"
+#include "SearchIndex.hpp"
+#include "RosterStore.hpp"
+#include "TaskScheduler.hpp"
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 
+struct ValidationReport;
+
 class Admin : public Person {
 private:
     static const std::string DEFAULT_ADMIN_USERNAME;
     static const std::string DEFAULT_ADMIN_PASSWORD;
+    SearchIndex searchIndex;   // rows of the roster passed to showMenuWithData
+    RosterStore* rosterStore = nullptr;   // published after every dashboard action when attached
+    JobQueue backgroundJobs;   // one job at a time: backups and exports share files
+    
+    // Queues job against the published version; its messages are shown the
+    // next time the dashboard is drawn
+    void runInBackground(const std::string& description,
+                         std::function<void(const std::vector<Student>&)> job);
 
 public:
     // Constructors
     Admin();
     Admin(const std::string& username, const std::string& password, const std::string& name);
+    ~Admin();
+    
+    // Reports, exports and backups then run on a snapshot in the background
+    void attachRosterStore(RosterStore& store);
+    // Builds the search index ahead of the first dashboard, e.g. while the
+    // welcome screen is up; not thread-safe with the dashboard itself
+    void prepareSearchIndex(const std::vector<Student>& students);
+    void waitForBackgroundJobs();
     
     // Override virtual methods from Person
     bool login() override;
@@ -28,9 +52,23 @@ public:
     void searchStudent(const std::vector<Student>& students);
     void showFailingStudents(const std::vector<Student>& students);
     void sortStudentsByScore(std::vector<Student>& students);
+    void queryStudents(const std::vector<Student>& students);
+    
+    // Analytics and reporting
+    void showAnalyticsMenu(std::vector<Student>& students);
+    void showArchivePercentiles();
+    void showCohortBreakdown(const std::vector<Student>& students);
+    void showRegradeSimulator(const std::vector<Student>& students);
+    void showStudentHistory(const std::vector<Student>& students);
+    void generateReportCards(const std::vector<Student>& students);
+    
+    // Terms and transcripts
+    void manageTerms(std::vector<Student>& students);
     
     // ENHANCED: Data management methods with file dialog support
     void importExcelData(std::vector<Student>& students, const std::string& filename);
+    void validateRoster(const std::vector<Student>& students);
+    void showValidationReport(const ValidationReport& report);
     void exportData(const std::vector<Student>& students, const std::string& filename);
     void backupData(const std::vector<Student>& students);
     
@@ -40,12 +78,15 @@ public:
     
     // Enhanced functionality methods
     std::string generateNextStudentId(const std::vector<Student>& students);
-    bool isValidGmail(const std::string& email);
-    bool isValidName(const std::string& name);
-    bool isValidGender(const std::string& gender);
-    bool isValidDate(const std::string& date);
+    static bool isValidGmail(const std::string& email);
+    static bool isValidName(const std::string& name);
+    static bool isValidGender(const std::string& gender);
+    static bool isValidDate(const std::string& date);
     void saveCredentialsToExcel(const std::vector<Student>& students);
     void reorderStudentIds(std::vector<Student>& students);
+    static void renumberStudents(std::vector<Student>& students);   // reorderStudentIds without the search index
+    void reassignSequentialIds(std::vector<Student>& students);
+    static std::string formatStudentId(int number);
     
     // Utility methods
     bool isValidStudentId(const std::string& id, const std::vector<Student>& students);
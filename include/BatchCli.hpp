@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Process exit codes for batch commands
+enum class BatchExitCode : int {
+    Ok = 0,
+    Failed = 1,         // unexpected error while running the command
+    Usage = 2,          // unknown command or bad arguments
+    InputError = 3,     // input workbook missing, unreadable or empty
+    OutputError = 4,    // result could not be written
+    Invalid = 5         // validate: the roster broke at least one rule
+};
+
+// Non-interactive command interface for scheduled runs:
+//
+//   ScoreME_Generator <command> [arguments] [--data <roster.xlsx>] [--threads N]
+//
+// Every command runs headless (no prompts, screen clears or animations),
+// prints one JSON object on stdout and returns a BatchExitCode. Status
+// messages go to stderr. The roster is read through the credential-free
+// fast path, except by import, merge and backup: those also read logins
+// from student_credentials.xlsx beside the roster, and import and merge
+// rewrite it together with the roster.
+class BatchCli {
+public:
+    static bool isBatchCommand(const std::string& argument);
+    static int run(const std::vector<std::string>& arguments);   // arguments[0] is the command
+    static std::string usage();
+
+    static const std::string DEFAULT_ROSTER;
+};
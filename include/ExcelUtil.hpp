@@ -1,4 +1,5 @@
 #pragma once
+#include <functional>
 #include <string>
 #include <vector>
 #include <map>
@@ -9,23 +10,60 @@ namespace xlnt {
     class worksheet;
 }
 
+struct ExportRow;
+struct SubjectStatistics;
+struct Transcript;
+struct ValidationReport;
+
+// One worksheet cell as read off disk, before it is interpreted
+struct SheetCell {
+    std::string text;
+    double number = 0.0;
+    bool numeric = false;
+    bool present = false;
+};
+
+struct SheetRow {
+    int row;                              // 1-based sheet row
+    std::vector<SheetCell> cells;         // by column; missing trailing cells are blank
+};
+
 class ExcelUtils {
 public:
     // Main Excel operations
     static void writeExcel(const std::string& filename, const std::vector<Student>& students);
     static std::vector<Student> readExcelToVector(const std::string& filename);
     static void readExcel(const std::string& filename);
+    static std::vector<Student> readStudentRows(const std::string& filename); // No credentials, no sample fallback
     static void writeCredentialsExcel(const std::string& filename, const std::vector<Student>& students);
     
     // Enhanced Excel operations
     static void writeExcelWithTimestamp(const std::string& baseFilename, const std::vector<Student>& students);
     static void createBackup(const std::string& sourceFilename, const std::vector<Student>& students);
     static void exportGradeReport(const std::string& filename, const std::vector<Student>& students);
+    static void exportTranscripts(const std::string& filename, const std::vector<Transcript>& transcripts);
+    static void exportValidationReport(const std::string& filename, const ValidationReport& report);
+    static void writeCsv(const std::string& filename, const std::vector<Student>& students);   // same columns as writeExcel
+    
+    // The same files from rows RosterExport formatted once; these throw on
+    // failure and print nothing, so several can run side by side
+    static void writeExcelRows(const std::string& filename, const std::vector<ExportRow>& rows);
+    static void writeCredentialRows(const std::string& filename, const std::vector<ExportRow>& rows);
+    static void writeGradeReportRows(const std::string& filename, const std::vector<ExportRow>& rows,
+                                     const std::vector<Student>& students);   // students feed the statistics sheets
+    static void writeCsvRows(const std::string& filename, const std::vector<ExportRow>& rows);
     
     // Import operations
-    static bool importStudentData(const std::string& filename, std::vector<Student>& students);
+    static bool importStudentData(const std::string& filename, std::vector<Student>& students,
+                                  ValidationReport* validation = nullptr);   // filled with the import's validation report
     static bool validateExcelFormat(const std::string& filename);
     
+    // Streaming read of the active sheet for ImportPipeline: emit gets each
+    // batch of up to batchRows data rows and returns false to stop reading
+    static void streamSheetRows(const std::string& filename, size_t batchRows,
+                                const std::function<bool(std::vector<SheetRow>&&, const std::string& sheetTitle)>& emit);
+    static Student decodeStudentRow(const SheetRow& row, const std::string& sheetTitle);
+    
     // Utility methods
     static std::string generateTimestampFilename(const std::string& baseFilename);
     static std::string getCurrentTimestamp();
@@ -39,6 +77,7 @@ public:
 private:
     // Helper methods for Excel formatting
     static void formatExcelHeader(xlnt::worksheet& ws);
-    static void writeStudentToExcel(xlnt::worksheet& ws, const Student& student, int row);
-    static Student readStudentFromExcel(xlnt::worksheet& ws, int row);
+    static void writeSubjectStatisticsSheet(xlnt::worksheet& ws, const std::vector<SubjectStatistics>& statistics);
+    static void writeCohortSheet(xlnt::worksheet& ws, const std::vector<Student>& students);
+    static void writeRowToExcel(xlnt::worksheet& ws, const ExportRow& exportRow, int row);
 };
\ No newline at end of file
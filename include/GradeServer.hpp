@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Student.hpp"
+
+struct ServerOptions {
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    std::string socketPath;                          // Unix socket instead of TCP when set (not on Windows)
+    size_t connectionThreads = 0;                    // 0: twice the core count, at least 8
+    std::string rosterFile = "data/students.xlsx";
+};
+
+// Immutable view of the roster that requests read from. Per-student JSON
+// and the class statistics are rendered once when the snapshot is built,
+// so a lookup is a hash probe and a string copy.
+struct RosterSnapshot {
+    std::vector<Student> students;
+    std::vector<std::string> studentJson;            // by row
+    std::unordered_map<std::string, std::uint32_t> rowById;
+    std::unordered_map<std::string, std::vector<std::uint32_t>> rowsByUsername;   // roster order; usernames repeat
+    std::string statisticsJson;
+    std::uint64_t version = 0;
+    std::time_t loadedAt = 0;
+};
+
+struct HttpRequest {
+    std::string method;
+    std::string path;                                // without the query string
+    std::unordered_map<std::string, std::string> query;
+    std::unordered_map<std::string, std::string> headers;   // names lowercased
+    std::string body;
+};
+
+struct HttpResponse {
+    int status = 200;
+    std::string body;
+};
+
+// Local HTTP/1.1 JSON service over a resident roster:
+//
+//   POST /api/login              {"username": ..., "password": ...} -> bearer token
+//   GET  /api/me                 the signed-in student's grades
+//   GET  /api/stats              class statistics
+//   GET  /api/students?q=QUERY   admin: RosterQuery filter (all students without q)
+//   GET  /api/students/ID        admin: one student
+//   POST /api/reload             admin: re-read the roster workbook
+//   GET  /api/health
+//
+// Requests read a shared_ptr to the current RosterSnapshot, taken atomically,
+// so they never wait on each other; a reload builds a new snapshot and
+// swaps the pointer, and requests already running finish on the old one.
+class GradeServer {
+public:
+    explicit GradeServer(const ServerOptions& options);
+    ~GradeServer();
+
+    void loadRoster();                               // throws on an unreadable workbook
+    std::shared_ptr<const RosterSnapshot> snapshot() const;
+
+    // Blocks serving connections until stop becomes true
+    void run(const std::atomic<bool>& stop);
+
+    HttpResponse handle(const HttpRequest& request);
+
+    std::uint64_t requestCount() const;
+    std::string endpoint() const;
+
+    static const size_t MAX_HEADER_BYTES;
+    static const size_t MAX_BODY_BYTES;
+    static const int SESSION_SECONDS;
+
+private:
+    // A student session names a row of one roster version. Student IDs are
+    // positions that a reload may renumber, so student sessions end with
+    // the version they were issued on; admin sessions survive reloads.
+    struct Session {
+        bool admin;
+        std::uint32_t row;
+        std::uint64_t rosterVersion;
+        std::time_t expires;
+    };
+
+    ServerOptions options;
+    std::shared_ptr<const RosterSnapshot> current;   // read and replaced with std::atomic_load / atomic_store
+    std::mutex reloadMutex;
+
+    mutable std::shared_mutex sessionMutex;
+    std::unordered_map<std::string, Session> sessions;
+    std::mutex tokenMutex;
+
+    std::atomic<std::uint64_t> requests{0};
+
+    std::string createSession(bool admin, std::uint32_t row, std::uint64_t rosterVersion);
+    bool findSession(const HttpRequest& request, Session& session) const;
+    void endStudentSessions();
+    std::string newToken();             // 128 bits from std::random_device, the OS generator
+
+    HttpResponse login(const HttpRequest& request);
+    HttpResponse studentGrades(const HttpRequest& request);
+    HttpResponse statistics(const HttpRequest& request);
+    HttpResponse listStudents(const HttpRequest& request);
+    HttpResponse findStudent(const HttpRequest& request, const std::string& studentId);
+    HttpResponse reload(const HttpRequest& request);
+};
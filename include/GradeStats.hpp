@@ -0,0 +1,40 @@
+#pragma once
+#include <array>
+#include <string>
+#include <vector>
+#include "Student.hpp"
+
+// Distribution summary of a single subject column
+struct SubjectStatistics {
+    std::string subjectName;
+    size_t count = 0;
+    double mean = 0.0;
+    double standardDeviation = 0.0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    double firstQuartile = 0.0;
+    double median = 0.0;
+    double thirdQuartile = 0.0;
+    std::array<double, 9> deciles{};      // P10, P20, ..., P90
+    std::array<size_t, 10> histogram{};   // 0-9, 10-19, ..., 90-100
+};
+
+class GradeStats {
+public:
+    // Per-subject statistics for every name in GradeUtil::getSubjectNames()
+    static std::vector<SubjectStatistics> computeSubjectStatistics(const std::vector<Student>& students);
+
+    // Quantile (0..1) with linear interpolation, using selection instead of a full sort.
+    // The values are partially reordered.
+    static double selectQuantile(std::vector<double>& values, double quantile);
+
+    // Display helpers
+    static std::string histogramBinLabel(size_t bin);
+    static std::string formatValue(double value);
+
+    static const size_t HISTOGRAM_BINS;
+    static const double HISTOGRAM_BIN_WIDTH;
+
+private:
+    static void computeQuantiles(std::vector<double>& column, SubjectStatistics& stats);
+};
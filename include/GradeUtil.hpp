@@ -1,4 +1,6 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -6,6 +8,7 @@ class GradeUtil {
 public:
     // Grade calculation methods
     static double calculateAverage(const std::vector<double>& scores);
+    static double calculateAverage(const std::vector<double>& scores, std::uint32_t presentMask);   // absent subjects skipped
     static std::string assignLetterGrade(double average);
     static double calculateGpa(double average);
     static std::string assignRemark(double average);
@@ -14,6 +17,9 @@ public:
     static bool isValidScore(double score);
     static bool isPassingGrade(double average);
     
+    // Lower bounds of A, B, C, D and E (E is the pass mark)
+    static std::array<double, 5> getGradeThresholds();
+    
     // Subject names
     static std::vector<std::string> getSubjectNames();
     
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Student.hpp"
+
+// Running totals for one student across closed terms
+struct CumulativeRecord {
+    double credits = 0.0;
+    double qualityPoints = 0.0;   // sum of term GPA x term credits
+    size_t terms = 0;
+
+    double gpa() const;
+};
+
+struct TermSummary {
+    std::string term;
+    size_t students;
+    double meanAverage;
+    double meanGpa;
+};
+
+struct TranscriptEntry {
+    std::string term;
+    double average;
+    std::string letterGrade;
+    double gpa;
+    double credits;
+    std::vector<double> subjectScores;
+    std::uint32_t scoreMask;                // subjects taken that term
+};
+
+struct Transcript {
+    std::string studentId;                  // in the latest term that has the student
+    std::string name;
+    std::vector<TranscriptEntry> entries;   // in term order
+    CumulativeRecord cumulative;
+};
+
+// Closed terms live in data/terms/: one workbook per term plus a small
+// ledger of each student's GPA and credits per term. Loading the current
+// roster only reads the ledger; term workbooks are read when transcripts
+// are generated. Cumulative records are adjusted by the difference a term
+// makes, so adding or correcting a term never re-reads the others.
+// Students are matched across terms by Student::identityKey(), since IDs
+// are renumbered whenever the roster changes order. A ledger from before
+// that is re-keyed from the term workbooks the first time it is opened.
+class Gradebook {
+public:
+    static Gradebook open(const std::string& directory = DEFAULT_DIRECTORY);
+
+    // Snapshot the roster as a term. Recording an existing term name replaces
+    // it (a correction); returns true in that case.
+    bool recordTerm(const std::string& term, const std::vector<Student>& students);
+
+    bool hasTerm(const std::string& term) const;
+    const std::vector<std::string>& terms() const;
+    std::vector<TermSummary> termSummaries() const;
+    const CumulativeRecord* cumulative(const Student& student) const;
+
+    // Copies cumulative GPA and credits onto the roster
+    void applyTo(std::vector<Student>& students) const;
+
+    // One pass over the term workbooks, each read once, for every student in the ledger
+    std::vector<Transcript> buildTranscripts() const;
+
+    static double termCredits(const Student& student);
+
+    static const std::string DEFAULT_DIRECTORY;
+    static const double CREDITS_PER_SUBJECT;
+
+private:
+    struct TermContribution {
+        double average;
+        double gpa;
+        double credits;
+    };
+
+    std::string directory;
+    std::vector<std::string> termNames;
+    std::vector<std::unordered_map<std::string, TermContribution>> contributions;   // per term, by identity key
+    std::unordered_map<std::string, CumulativeRecord> records;
+
+    std::string termFilename(size_t termIndex) const;
+    std::string ledgerFilename() const;
+    void saveLedger() const;
+    void rekeyFromWorkbooks();
+    void addTerm(size_t termIndex, const std::vector<Student>& students);
+    void addContribution(const std::string& identity, const TermContribution& contribution);
+    void removeContribution(const std::string& identity, const TermContribution& contribution);
+};
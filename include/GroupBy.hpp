@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Student.hpp"
+
+enum class GroupKey {
+    Gender,
+    Age,
+    LetterGrade,
+    ClassName,
+    BirthYear
+};
+
+// Aggregates for one cohort
+struct GroupSummary {
+    std::string label;
+    size_t count = 0;
+    double meanAverage = 0.0;
+    double passRate = 0.0;                // percent of the group passing
+    std::vector<double> subjectMeans;     // GradeUtil::getSubjectNames() order
+};
+
+// Cohort breakdowns by hash aggregation. Each worker folds its slice of the
+// roster into its own hash table; the partial tables are merged at the end.
+class GroupBy {
+public:
+    static std::vector<GroupSummary> aggregate(const std::vector<Student>& students, GroupKey key);
+
+    static std::string groupLabel(const Student& student, GroupKey key);
+    static std::string keyName(GroupKey key);
+    static const std::vector<GroupKey>& allKeys();
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "RosterValidator.hpp"
+#include "Student.hpp"
+
+struct ImportOptions {
+    std::string filename;
+    std::string credentialsFile;          // empty: students keep blank credentials
+    size_t batchRows = 512;
+    size_t queueDepth = 4;                // batches read ahead of the workers
+    size_t workers = 0;                   // batches processed at once; 0 (or more than the pool has): all threads
+};
+
+struct ImportRejection {
+    int row;                              // 1-based sheet row
+    std::string reason;
+};
+
+struct ImportStageTiming {
+    std::string name;
+    size_t workers = 0;
+    size_t batches = 0;
+    double busyMs = 0.0;                  // summed over workers, time blocked on a queue excluded
+};
+
+struct ImportResult {
+    std::vector<Student> students;        // sheet order, grades current, credentials attached
+    std::vector<std::uint32_t> sheetRows; // sheet row of each student
+    std::vector<ImportRejection> rejected;
+    ValidationReport validation;          // RosterValidator rules; flagged rows are still imported
+    std::vector<ImportStageTiming> stages;
+    double wallMs = 0.0;
+
+    const ImportStageTiming& slowestStage() const;   // by busy time per worker
+};
+
+// Roster import as a chain of stages over batches of rows:
+//
+//   xlsx decode -> row decode -> validate -> index
+//
+// xlsx decode streams cells off the archive on the calling thread (xlnt
+// readers are not thread-safe), after the credentials workbook has been
+// read. Each batch then runs the middle stages as one TaskScheduler task:
+// row decode builds the students (grading them as it goes) and validate
+// applies RosterValidator's row rules to the raw cells. Index, also on the
+// caller, restores sheet order, attaches credentials and finds duplicate
+// IDs and emails. Reading pauses while workers + queueDepth batches are in
+// flight, so memory stays bounded.
+class ImportPipeline {
+public:
+    // Throws when the workbook cannot be read; bad rows are rejected, not thrown
+    static ImportResult run(const ImportOptions& options);
+
+    // Writes the roster workbook, then the credentials workbook, on the calling
+    // thread; throws if either cannot be written
+    static void persist(const std::vector<Student>& students,
+                        const std::string& rosterFile, const std::string& credentialsFile);
+
+    // "N rows in X ms; slowest stage: ..." for status messages
+    static std::string summary(const ImportResult& result);
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+#include "RegradeSimulator.hpp"
+#include "Student.hpp"
+
+struct ValidationReport;
+
+// Object builder; fields are written in insertion order
+class JsonObject {
+public:
+    JsonObject& add(const std::string& key, const std::string& value);
+    JsonObject& add(const std::string& key, const char* value);
+    JsonObject& add(const std::string& key, double value);
+    JsonObject& add(const std::string& key, size_t value);
+    JsonObject& add(const std::string& key, int value);
+    JsonObject& add(const std::string& key, bool value);
+    JsonObject& raw(const std::string& key, const std::string& json);   // value already encoded
+    std::string str() const;
+
+private:
+    std::string body;
+};
+
+// JSON text for the batch CLI and the HTTP service
+class JsonUtil {
+public:
+    static std::string quote(const std::string& value);
+    static std::string number(double value);                     // NaN and infinities become null
+    static std::string array(const std::vector<std::string>& items);
+
+    // Flat object of scalars, e.g. a login body. Values come back as text:
+    // strings unescaped, numbers and literals as written. Throws
+    // std::invalid_argument on anything else.
+    static std::map<std::string, std::string> parseObject(const std::string& text);
+
+    // One student's record and grades; credentials are never included
+    static std::string student(const Student& student);
+
+    // Roster totals, letter-grade counts and per-subject statistics
+    static std::string rosterStatistics(const std::vector<Student>& students);
+
+    // Issue counts by rule and the first maxIssues issues as {row, column, rule}
+    static std::string validationReport(const ValidationReport& report, size_t maxIssues);
+
+    // {"A": n, ..., "F": n}
+    static std::string gradeCounts(const std::array<size_t, GradeScale::GRADE_COUNT>& counts);
+};
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <future>
 #include <vector>
 #include <string>
 #include "Student.hpp"
@@ -8,17 +10,46 @@ namespace tabulate {
     enum class Color;
 }
 
+struct SubjectStatistics;
+struct GroupSummary;
+struct GradeScale;
+struct Curve;
+struct RegradeOutcome;
+struct SweepPoint;
+struct AnomalyReport;
+struct TrendPoint;
+struct TrendSummary;
+struct TermSummary;
+struct ValidationReport;
+enum class GroupKey;
+class ScoreSketches;
+
 class MenuUtils {
 public:
     // Display methods
     static void displayTable(const std::vector<Student>& students);
+    static void displayTable(const std::vector<Student>& students, const std::vector<std::uint32_t>& rows);
+    static std::string formatTable(const std::vector<Student>& students, const std::vector<std::uint32_t>& rows,
+                                   size_t begin, size_t end);   // rows[begin, end) as displayTable draws them
     static void displayStudentDetails(const Student& student);
     static void displayGradeReport(const std::vector<Student>& students);
-    static void displayFailingStudents(const std::vector<Student>& students);
+    static void displayFailingStudents(const std::vector<Student>& students, const std::vector<std::uint32_t>& rows);
+    static void displaySubjectStatistics(const std::vector<SubjectStatistics>& statistics);
+    static void displayArchivePercentiles(const ScoreSketches& archive, size_t snapshotCount);
+    static void displayGroupSummaries(const std::vector<GroupSummary>& groups, GroupKey key);
+    static void displayRegradeOutcome(const std::vector<Student>& students, const RegradeOutcome& outcome,
+                                      const GradeScale& scale, const Curve& curve);
+    static void displayPassMarkSweep(const std::vector<SweepPoint>& points, double currentPassRate);
+    static void displayAnomalyReport(const std::vector<Student>& students, const AnomalyReport& report);
+    static void displayAnomalySummary(const AnomalyReport& report);
+    static void displayStudentHistory(const std::string& title, const std::vector<TrendPoint>& history,
+                                      const TrendSummary& summary);
+    static void displayTermSummaries(const std::vector<TermSummary>& terms);
+    static void displayValidationReport(const ValidationReport& report, size_t maxIssues = 20);
     
     // Menu display methods
     static void printMenu(const std::vector<std::string>& items);
-    static void printWelcome();
+    static void printWelcome(const std::shared_future<void>& loading = {});   // waits briefly for loading
     static void printMainMenu();
     static void printAdminMenu();
     static void printStudentMenu();
@@ -26,8 +57,12 @@ public:
     // Enhanced UI methods
     static void printAdminDashboard();
     static void printStudentDashboard();
-    static void printThankYou();
-    static void showLoadingAnimation(const std::string& message = "Initializing", int duration = 2000);
+    static void printThankYou(const std::shared_future<void>& saving = {});
+    // The animations run only while their work does and end as soon as it
+    // completes; with no work they are drawn complete at once
+    static void showLoadingAnimation(const std::string& message = "Initializing",
+                                     const std::shared_future<void>& work = {});
+    static void printLoginSuccess();
 
     // Colored output methods
     static void printColored(const std::string& text, const std::string& color);
@@ -38,6 +73,7 @@ public:
     
     // Color and display methods
     static void printColorLegend();
+    static std::string colorLegend();
     static tabulate::Color getGradeColor(const std::string& grade);
     
     // Input methods
@@ -54,6 +90,21 @@ public:
     static void printSeparator();
     static void printHeader(const std::string& title);
     
+    // Both stdin and stdout are a terminal, and not in headless mode
+    static bool isInteractive();
+    static bool isTerminalOutput();   // stdout only; colors and flushing follow it
+    
+    // Headless (batch) mode: status messages go to stderr without colors or
+    // emoji, and screen clears, pauses and animations are skipped
+    static void setHeadless(bool enabled);
+    static bool isHeadless();
+
+    // Background jobs: messages printed on a deferred thread are queued and
+    // shown by the next flushDeferredMessages on the UI thread, so they never
+    // land in the middle of a prompt
+    static void setDeferredOutput(bool enabled);   // this thread only
+    static void flushDeferredMessages();
+    
     // Color codes
     static const std::string RESET;
     static const std::string RED;
@@ -64,4 +115,7 @@ public:
     static const std::string CYAN;
     static const std::string WHITE;
     static const std::string BOLD;
+
+private:
+    static bool headless;
 };
\ No newline at end of file
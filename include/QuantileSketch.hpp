@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "Student.hpp"
+
+// KLL-style mergeable quantile sketch. Memory stays O(k log(n/k)) and the
+// normalized rank error of any query is about 1.7/k with high probability,
+// no matter how many sketches were merged to build it.
+class QuantileSketch {
+public:
+    explicit QuantileSketch(size_t k = DEFAULT_K);
+
+    void update(double value);
+    void merge(const QuantileSketch& other);
+
+    // Queries
+    double quantile(double fraction) const;   // value at rank fraction (0..1)
+    double rank(double value) const;          // fraction of values <= value
+    std::uint64_t count() const;
+    double minimum() const;
+    double maximum() const;
+    size_t retainedItems() const;
+    double rankErrorBound() const;
+
+    // Plain-text persistence
+    void write(std::ostream& out) const;
+    static QuantileSketch read(std::istream& in);
+
+    static const size_t DEFAULT_K;
+
+private:
+    size_t k;
+    std::uint64_t totalCount;
+    double minValue;
+    double maxValue;
+    std::uint64_t coinState;
+    std::vector<std::vector<double>> levels;   // items at level h weigh 2^h
+    std::vector<size_t> capacities;
+    size_t capacityTotal;
+    size_t retained;
+
+    void refreshCapacities();
+    void compress();
+    bool flipCoin();
+};
+
+// One sketch per score column ("Average" plus each subject) for a workbook
+class ScoreSketches {
+public:
+    std::vector<std::string> columnNames;
+    std::vector<QuantileSketch> sketches;
+
+    ScoreSketches();
+
+    static ScoreSketches fromStudents(const std::vector<Student>& students);
+    void merge(const ScoreSketches& other);
+    const QuantileSketch* find(const std::string& columnName) const;
+
+    void save(const std::string& filename) const;
+    static ScoreSketches load(const std::string& filename);
+
+    // "data/backups/backup_students_x.xlsx" -> "data/backups/backup_students_x.sketch"
+    static std::string sketchFilenameFor(const std::string& workbookFilename);
+
+    // Merge every sketch in a backup directory. Backup workbooks without a
+    // sketch are read once and their sketch is written for next time.
+    static ScoreSketches loadArchive(const std::string& backupDirectory, size_t& snapshotCount);
+
+    static const std::string AVERAGE_COLUMN;
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Student.hpp"
+
+// Candidate letter-grade boundaries (lower bounds of A..E; E is the pass mark)
+struct GradeScale {
+    std::array<double, 5> thresholds;
+
+    static GradeScale current();
+    bool isValid() const;                 // within 0-100 and strictly descending
+    int gradeIndex(double average) const; // 0 = A ... 5 = F
+    static std::string gradeLetter(int index);
+
+    static const int GRADE_COUNT = 6;
+};
+
+enum class CurveType {
+    None,
+    LinearShift,    // every average moves by shift points
+    ZScore,         // rescale to targetMean / targetStdDev
+    BellCurve       // rank-based: a student's percentile maps onto a normal distribution
+};
+
+struct Curve {
+    CurveType type = CurveType::None;
+    double shift = 0.0;
+    double targetMean = 70.0;
+    double targetStdDev = 10.0;
+
+    std::string describe() const;
+};
+
+struct GradeChange {
+    std::uint32_t row;
+    double oldAverage;
+    double newAverage;
+    int oldGrade;
+    int newGrade;
+};
+
+struct RegradeOutcome {
+    std::array<size_t, GradeScale::GRADE_COUNT> currentCounts{};
+    std::array<size_t, GradeScale::GRADE_COUNT> simulatedCounts{};
+    double currentMean = 0.0;
+    double simulatedMean = 0.0;
+    double currentPassRate = 0.0;      // percent
+    double simulatedPassRate = 0.0;    // percent
+    size_t promoted = 0;
+    size_t demoted = 0;
+    std::vector<GradeChange> changes;  // students whose letter grade moves
+};
+
+struct SweepPoint {
+    double passMark;
+    size_t passing;
+    double passRate;                   // percent
+};
+
+// What-if regrading over a copy of the average column; the roster itself is
+// never modified. Averages are extracted once, so repeated simulations and
+// threshold sweeps only touch a flat array.
+class RegradeSimulator {
+public:
+    explicit RegradeSimulator(const std::vector<Student>& students);
+
+    RegradeOutcome simulate(const GradeScale& scale, const Curve& curve) const;
+
+    // Pass rate at each candidate pass mark after the curve, via one sort
+    // and a binary search per mark
+    std::vector<SweepPoint> sweepPassMarks(const Curve& curve, double from, double to, double step) const;
+
+    size_t size() const;
+
+private:
+    std::vector<double> averages;
+
+    std::vector<double> applyCurve(const Curve& curve) const;
+    static double inverseNormal(double probability);
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Student.hpp"
+#include "TaskScheduler.hpp"
+
+enum class ReportCardFormat {
+    Text,
+    Html,
+    Xlsx
+};
+
+struct ReportCardOptions {
+    std::string directory = "data/report_cards";
+    ReportCardFormat format = ReportCardFormat::Html;
+    size_t cardsPerTask = 64;             // files per scheduler task (per progress step for xlsx)
+};
+
+struct ReportCardResult {
+    std::string directory;
+    size_t written = 0;
+    size_t failed = 0;
+    std::vector<std::string> failures;    // "file: reason", the first few only
+    double elapsedMs = 0.0;
+};
+
+// One report card file per student, named after the student ID. Rows are
+// formatted once (RosterExport::formatRows), then shards of text and HTML
+// cards are written on the shared TaskScheduler; xlsx cards are written
+// one at a time on the calling thread. Each shard keeps one output buffer
+// and the format's template pieces and styles, and every file goes to
+// disk in a single write.
+class ReportCards {
+public:
+    // Throws when the directory cannot be created; a card that cannot be
+    // written is counted in failed and the rest carry on
+    static ReportCardResult generate(const std::vector<Student>& students, const ReportCardOptions& options,
+                                     const ProgressCallback& progress = nullptr);
+
+    static bool parseFormat(const std::string& text, ReportCardFormat& format);   // "text", "html" or "xlsx"
+    static std::string formatName(ReportCardFormat format);
+    static std::string extension(ReportCardFormat format);
+};
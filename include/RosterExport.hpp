@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Student.hpp"
+
+// One student's export cells, formatted once and shared by every writer
+struct ExportRow {
+    std::string studentId;
+    std::string name;
+    int age = 0;
+    std::string gender;
+    std::string dateOfBirth;
+    std::string email;
+    std::vector<double> scores;
+    std::uint32_t scoreMask = 0;           // bit i set: subject i taken
+    std::vector<std::string> scoreText;    // "%.10g", empty when not taken
+    double average = 0.0;
+    std::string averageText;
+    std::string letterGrade;
+    double gpa = 0.0;
+    std::string gpaText;
+    std::string remark;
+    std::string lastUpdated;               // "YYYY-MM-DD HH:MM:SS"
+    std::string className;
+    std::string username;
+    std::string password;
+    bool passing = false;
+
+    bool hasScore(size_t subject) const { return subject < 32 && ((scoreMask >> subject) & 1u); }
+};
+
+// Files to produce in one export; an empty name skips that file
+struct ExportTargets {
+    std::string gradeReport;               // ExcelUtils::exportGradeReport layout
+    std::string workbook;                  // ExcelUtils::writeExcel layout
+    std::string credentials;               // ExcelUtils::writeCredentialsExcel layout
+    std::string csv;
+    std::string json;
+};
+
+struct ExportFileResult {
+    std::string kind;                      // "grade report", "workbook", ...
+    std::string filename;
+    double elapsedMs = 0.0;
+    std::string error;                     // empty when the file was written
+};
+
+// Single-pass roster export: the roster is walked once into ExportRows,
+// then every requested file is written from those rows. CSV and JSON are
+// written as tasks on the shared TaskScheduler while the xlsx workbooks
+// are written one after another on the calling thread.
+class RosterExport {
+public:
+    // Rows are formatted in parallel, in roster order
+    static std::vector<ExportRow> formatRows(const std::vector<Student>& students);
+
+    // Writers do not print; one failed file does not stop the others
+    static std::vector<ExportFileResult> run(const std::vector<Student>& students, const ExportTargets& targets);
+
+    // JSON array of the export columns, credentials left out
+    static void writeJson(const std::string& filename, const std::vector<ExportRow>& rows);
+
+    static bool succeeded(const std::vector<ExportFileResult>& results);
+};
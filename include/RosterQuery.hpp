@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SortEngine.hpp"
+#include "Student.hpp"
+
+enum class QueryField {
+    Average,
+    Gpa,
+    Age,
+    Subject,
+    Gender,
+    Grade,
+    Remark,
+    Name,
+    StudentId,
+    Email,
+    DateOfBirth
+};
+
+enum class CompareOp {
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Contains
+};
+
+struct QueryPredicate {
+    QueryField field;
+    size_t subjectIndex;     // QueryField::Subject only
+    CompareOp op;
+    double number;           // numeric fields
+    std::string text;        // text fields, lowercased
+};
+
+// Numeric columns a query reads, pulled out of the roster once per run so
+// every predicate scans a flat array
+struct RosterColumns {
+    std::vector<double> average;
+    std::vector<double> gpa;
+    std::vector<double> age;
+    std::vector<std::vector<double>> subjects;
+
+    static RosterColumns extract(const std::vector<Student>& students, const std::vector<QueryPredicate>& predicates);
+    const std::vector<double>& column(const QueryPredicate& predicate) const;
+};
+
+// Ad-hoc roster filter, e.g.
+//   avg < 50 and gender = Female and Mathematics >= 80 order by avg desc limit 20
+// Conditions combine with "and" (binding tighter) and "or". The text is parsed
+// once into OR-ed groups of AND-ed predicates; running it narrows a selection
+// vector of row indices, so students are never copied.
+class RosterQuery {
+public:
+    RosterQuery();
+
+    static RosterQuery parse(const std::string& text);   // throws std::invalid_argument
+    std::vector<std::uint32_t> run(const std::vector<Student>& students) const;
+
+    static std::string syntaxHelp();
+
+private:
+    std::vector<std::vector<QueryPredicate>> groups;
+    std::vector<SortSpec> order;
+    size_t limit;
+    bool hasLimit;
+
+    static std::vector<std::uint32_t> filter(const std::vector<Student>& students, const RosterColumns& columns,
+                                             const std::vector<QueryPredicate>& group);
+    static void narrow(const std::vector<Student>& students, const RosterColumns& columns,
+                       const QueryPredicate& predicate, std::vector<std::uint32_t>& selection);
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Student.hpp"
+
+// One immutable version of the roster, split into fixed-size chunks that
+// consecutive versions share when their students did not change. Every
+// student's grades are computed before the version is published, so any
+// number of threads may read it at once.
+class RosterVersion {
+public:
+    using Chunk = std::vector<Student>;
+
+    size_t size() const;
+    bool empty() const;
+    const Student& operator[](size_t row) const;
+    std::uint64_t number() const;
+    size_t chunkCount() const;
+    size_t sharedChunks() const;                       // reused unchanged from the previous version
+
+    // Copy for code that takes a roster vector (exports, backups)
+    std::vector<Student> toVector() const;
+
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const auto& chunk : chunks) {
+            for (const auto& student : *chunk) visit(student);
+        }
+    }
+
+private:
+    friend class RosterStore;
+
+    std::vector<std::shared_ptr<const Chunk>> chunks;
+    size_t count = 0;
+    std::uint64_t versionNumber = 0;
+    size_t reused = 0;
+};
+
+// Multi-version roster: readers take the current version with one
+// std::atomic_load of a shared_ptr and keep it as long as they like; writers
+// publish a whole new version, copying only the chunks whose students
+// changed. Old versions are freed when their last reader lets go of them.
+//
+// That load is not lock-free: libstdc++ guards shared_ptr atomics with a
+// small pool of mutexes hashed by address, and MSVC with one spinlock,
+// held only to copy the pointer and bump its reference count. Readers never
+// wait for the writer mutex or for a publish to finish building a version.
+class RosterStore {
+public:
+    RosterStore();
+
+    std::shared_ptr<const RosterVersion> current() const;
+
+    // Publishes the roster as the next version; returns its number. Chunks
+    // equal to the same chunk of the current version are shared, so an
+    // edit to one student copies CHUNK_SIZE students, not the roster.
+    std::uint64_t publish(const std::vector<Student>& students);
+
+    static const size_t CHUNK_SIZE;
+
+private:
+    std::shared_ptr<const RosterVersion> latest;       // std::atomic_load / atomic_store only (internally locked, see above)
+    std::mutex writerMutex;                            // one publisher at a time; readers never take it
+};
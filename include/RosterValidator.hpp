@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Student.hpp"
+
+struct SheetRow;
+
+enum class ValidationRule : std::uint8_t {
+    Name,                  // Admin::isValidName
+    Email,                 // Admin::isValidGmail
+    Gender,                // Admin::isValidGender
+    DateOfBirth,           // Admin::isValidDate
+    Score,                 // GradeUtil::isValidScore, or a score cell that is not a number
+    DuplicateId,
+    DuplicateEmail
+};
+
+// One broken cell; column indexes ExcelUtils::getExcelHeaders()
+struct ValidationIssue {
+    std::uint32_t row;     // 1-based sheet row
+    std::uint16_t column;
+    ValidationRule rule;
+};
+
+struct ValidationReport {
+    static const size_t RULE_COUNT = 7;
+
+    std::vector<ValidationIssue> issues;          // by row, then column
+    std::array<size_t, RULE_COUNT> countByRule{};
+    size_t rowsChecked = 0;
+    double elapsedMs = 0.0;
+
+    bool clean() const { return issues.empty(); }
+    size_t count(ValidationRule rule) const { return countByRule[static_cast<size_t>(rule)]; }
+    size_t rowsWithIssues() const;
+};
+
+// Remembers every student ID and email seen so far, so duplicates can be
+// found one batch at a time as rows stream in (ImportPipeline's index stage)
+class DuplicateTracker {
+public:
+    void check(const Student& student, std::uint32_t row, std::vector<ValidationIssue>& issues);
+    void checkId(const Student& student, std::uint32_t row, std::vector<ValidationIssue>& issues);
+    void checkEmail(const Student& student, std::uint32_t row, std::vector<ValidationIssue>& issues);
+
+private:
+    std::unordered_map<std::string, std::uint32_t> firstRowById;
+    std::unordered_map<std::string, std::uint32_t> firstRowByEmail;   // lowercased
+};
+
+// Rule-based checks for whole rosters: the interactive validators from
+// Admin and GradeUtil applied to every row, plus duplicate IDs and emails.
+class RosterValidator {
+public:
+    // Row rules run in parallel on the shared TaskScheduler, with the ID and
+    // email duplicate scans as two more tasks beside them. sheetRows gives
+    // each student's sheet row; without it rows are numbered as writeExcel
+    // lays them out (from 2).
+    static ValidationReport validate(const std::vector<Student>& students,
+                                     const std::vector<std::uint32_t>& sheetRows = {});
+
+    // Row rules for one student. When the raw sheet row is at hand (import),
+    // its score cells are checked too, so values the decoder dropped as
+    // "not taken" are still reported.
+    static void checkStudent(const Student& student, std::uint32_t row,
+                             std::vector<ValidationIssue>& issues, const SheetRow* sheetRow = nullptr);
+
+    // Sorts the issues and fills in the counts
+    static void finish(ValidationReport& report);
+
+    static std::string ruleName(ValidationRule rule);
+    static std::string ruleDescription(ValidationRule rule);
+    static std::string columnName(const ValidationIssue& issue);
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Student.hpp"
+
+// A subject score that stands out from the student's own profile or the cohort
+struct ScoreOutlier {
+    std::uint32_t row;
+    size_t subjectIndex;
+    double score;
+    double cohortZ;     // robust z of the score within its subject
+    double profileZ;    // robust z of (score - student's median score) within its subject
+};
+
+struct PerfectScoreSpike {
+    size_t subjectIndex;
+    size_t perfectCount;        // scores of exactly 100
+    size_t neighbourhoodCount;  // scores in [95, 100)
+};
+
+struct AnomalyReport {
+    std::vector<std::string> subjects;
+    std::vector<std::vector<double>> correlation;   // subjects x subjects, Pearson
+    std::vector<ScoreOutlier> outliers;             // strongest first
+    size_t flaggedScores = 0;                       // before truncating to the top list
+    std::vector<PerfectScoreSpike> spikes;
+    double elapsedMilliseconds = 0.0;
+};
+
+// Correlation and outlier pass over the subject columns. Scores are copied
+// into column-major arrays once; the correlation matrix is accumulated over
+// row blocks so each block's tile stays in cache for all subject pairs.
+// Subjects a student did not take are masked out of every statistic.
+// Robust z-scores use median and MAD, so a few bad rows cannot hide
+// themselves by inflating the spread.
+class ScoreAnalysis {
+public:
+    static AnomalyReport analyze(const std::vector<Student>& students, size_t topOutliers = 20);
+
+    // Exact median (mean of the middle two for an even count); 0 when empty
+    static double median(const std::vector<double>& values);
+
+    static const double OUTLIER_THRESHOLD;   // |robust z| above this is flagged
+
+private:
+    static std::vector<std::vector<double>> correlationMatrix(const std::vector<std::vector<double>>& columns,
+                                                              const std::vector<std::vector<double>>& presence);
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Terminal control with ANSI escape sequences, in process rather than by
+// running clear/cls. When stdout is not a terminal nothing is cleared and
+// frames are simply written out, so pipes and logs get plain text.
+class Screen {
+public:
+    // Clears the terminal and homes the cursor; does nothing off a terminal
+    static void clear();
+
+    // stdout is a terminal that understands escape sequences (on Windows,
+    // once virtual terminal processing could be switched on)
+    static bool supportsAnsi();
+
+    // Terminal window size; without a console, LINES / COLUMNS or 24x80
+    static int rows();
+    static int columns();
+
+    // Draws a frame of text lines. After the first frame only lines that
+    // differ from the previous one are rewritten. The last line is treated
+    // as a prompt: it is always redrawn, with everything under it cleared,
+    // and the cursor is left at its end.
+    void present(const std::string& frame);
+
+    // Forget what is on screen, e.g. after other output; the next present
+    // clears and draws everything
+    void invalidate();
+
+private:
+    std::vector<std::string> shown;
+    bool valid = false;
+};
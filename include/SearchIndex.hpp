@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Student.hpp"
+
+enum class MatchKind {
+    ExactId,
+    ExactName,
+    Prefix,
+    Fuzzy
+};
+
+struct SearchHit {
+    std::uint32_t row;      // index into the roster
+    MatchKind kind;
+    double score;           // 1.0 = exact, lower = weaker
+    int distance;           // edit distance for fuzzy hits, 0 otherwise
+};
+
+// Name/ID lookup over a roster. Names are normalized (lowercase, letters and
+// digits only, single spaces) and indexed twice: a prefix trie over every
+// name token for type-ahead matches, and a trigram inverted index that picks
+// the candidates for fuzzy matching. Edit distance is only computed for those
+// candidates, never for the whole roster.
+class SearchIndex {
+public:
+    SearchIndex();
+
+    void rebuild(const std::vector<Student>& students);
+    void add(std::uint32_t row, const Student& student);
+    void update(std::uint32_t row, const Student& student);   // after a name or ID edit
+
+    std::vector<SearchHit> search(const std::string& term, size_t limit = 10) const;
+    size_t size() const;                    // rows indexed
+
+    static std::string normalize(const std::string& text);
+    static int editDistance(const std::string& a, const std::string& b, int maxDistance);
+    static double similarity(const std::string& term, const std::string& name);
+    static std::string matchKindLabel(MatchKind kind);
+
+    static const double FUZZY_ACCEPT_SCORE;
+
+private:
+    struct TrieNode {
+        char label;
+        std::uint32_t firstChild;
+        std::uint32_t nextSibling;
+        std::int32_t postings;       // index into tokenPostings, -1 if no token ends here
+    };
+
+    std::vector<TrieNode> trie;
+    std::vector<std::vector<std::uint32_t>> tokenPostings;
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> trigramPostings;
+    std::unordered_map<std::string, std::uint32_t> idIndex;
+    std::vector<std::string> names;      // normalized name per row
+    std::vector<std::string> ids;        // normalized ID per row
+
+    void insertToken(const std::string& token, std::uint32_t row);
+    void collectPrefix(const std::string& prefix, std::vector<std::uint32_t>& rows, size_t limit) const;
+    static std::vector<std::string> tokenize(const std::string& normalized);
+    static std::vector<std::uint32_t> trigrams(const std::string& normalized);
+    static int bestTokenDistance(const std::string& query, const std::string& name, int maxDistance);
+};
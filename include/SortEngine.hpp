@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Student.hpp"
+
+enum class SortKey {
+    AverageScore,
+    StudentNumber,   // numeric part of "STU###"
+    Name,            // case- and whitespace-insensitive
+    Gpa,
+    Age,
+    SubjectScore     // SortSpec::subjectIndex selects the subject
+};
+
+struct SortSpec {
+    SortKey key;
+    bool descending;
+    size_t subjectIndex = 0;
+};
+
+// Sorts a permutation of row indices instead of moving Student objects.
+// Keys are extracted once into flat 64-bit arrays, then ordered with a stable
+// LSD radix sort (least significant spec first), so multi-key orders such as
+// "average desc, then name asc" cost a few linear passes.
+class SortEngine {
+public:
+    static std::vector<std::uint32_t> sortedPermutation(const std::vector<Student>& students,
+                                                        const std::vector<SortSpec>& order);
+
+    // Reorder a subset of rows (e.g. a filter's selection vector) in place
+    static void sortRows(const std::vector<Student>& students, std::vector<std::uint32_t>& rows,
+                         const std::vector<SortSpec>& order);
+
+    // students[i] becomes the old students[permutation[i]]
+    static void applyPermutation(std::vector<Student>& students, const std::vector<std::uint32_t>& permutation);
+
+    static int parseStudentNumber(const std::string& studentId);
+    static std::string collationKey(const std::string& name);
+
+private:
+    // Keys are indexed by row; only the listed rows are filled in
+    static std::vector<std::uint64_t> extractKeys(const std::vector<Student>& students,
+                                                  const std::vector<std::uint32_t>& rows, const SortSpec& spec);
+    static void radixSortByKey(std::vector<std::uint32_t>& permutation, const std::vector<std::uint64_t>& keys);
+    static std::vector<std::uint64_t> rankStrings(const std::vector<std::string>& values);
+    static std::uint64_t stringChunk(const std::string& value, size_t offset);
+};
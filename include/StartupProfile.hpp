@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+
+// Startup phase timings, measured from the top of main. The UI thread and
+// the background loader both mark the phases they finish; report() lists
+// them in order with the time each took on its own thread, so the time to
+// the first menu and what it was spent on can be read off at a glance.
+// Enabled by --startup-report or the SCOREME_STARTUP_REPORT variable.
+class StartupProfile {
+public:
+    static void begin();                          // process start; call first
+    static void mark(const std::string& phase);   // phase ended now, on this thread
+    static double elapsedMs();                    // since begin()
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    static std::string report();
+};
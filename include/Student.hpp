@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <ctime>
@@ -12,11 +13,19 @@ private:
     std::string dateOfBirth;
     std::string email;
     std::vector<double> subjectScores; 
-    double averageScore;
+    std::uint32_t scoreMask = 0;   // bit i set when subject i was taken; absent scores hold 0.0
+    std::string className;   // class/section; empty when unassigned
+    double cumulativeCredits = 0.0;   // closed terms only, from the gradebook
+    double cumulativeGpa = 0.0;
+    
+    // Derived from subjectScores whenever they are set
+    double averageScore = 0.0;
     std::string letterGrade;
-    double gpa;
+    double gpa = 0.0;
     std::string remark;
     std::time_t lastUpdated;
+    
+    void recomputeGrades();
 
 public:
     // Constructors
@@ -29,18 +38,28 @@ public:
             const std::string& studentId, const std::string& name, int age,
             const std::string& gender, const std::string& dateOfBirth,
             const std::string& email, const std::vector<double>& scores);
+    // Only the subjects in presentMask were taken (see setSubjectScores)
+    Student(const std::string& username, const std::string& password,
+            const std::string& studentId, const std::string& name, int age,
+            const std::string& gender, const std::string& dateOfBirth,
+            const std::string& email, const std::vector<double>& scores, std::uint32_t presentMask);
 
     // Getters
-    std::string getStudentId() const;
+    const std::string& getStudentId() const;
     int getAge() const;
-    std::string getGender() const;
-    std::string getDateOfBirth() const;
-    std::string getEmail() const;
-    std::vector<double> getSubjectScores() const;
+    const std::string& getGender() const;
+    const std::string& getDateOfBirth() const;
+    const std::string& getEmail() const;
+    const std::vector<double>& getSubjectScores() const;
+    std::uint32_t getScoreMask() const;
+    bool hasScore(size_t subjectIndex) const;
+    const std::string& getClassName() const;
+    double getCumulativeCredits() const;
+    double getCumulativeGpa() const;
     double getAverageScore() const;
-    std::string getLetterGrade() const;
+    const std::string& getLetterGrade() const;
     double getGpa() const;
-    std::string getRemark() const;
+    const std::string& getRemark() const;
     std::time_t getLastUpdated() const;
 
     // Setters
@@ -49,7 +68,10 @@ public:
     void setGender(const std::string& gender);
     void setDateOfBirth(const std::string& dob);
     void setEmail(const std::string& email);
-    void setSubjectScores(const std::vector<double>& scores);
+    void setSubjectScores(const std::vector<double>& scores);                        // all present
+    void setSubjectScores(const std::vector<double>& scores, std::uint32_t presentMask);
+    void setClassName(const std::string& className);
+    void setCumulativeRecord(double credits, double gpa);
 
     // Calculation methods
     void calculateAverageScore();
@@ -67,6 +89,15 @@ public:
     void updateTimestamp();
     std::string getFormattedTimestamp() const;
     bool hasPassingGrade() const;
+    bool sameRecord(const Student& other) const;   // every stored field equal; derived grades and timestamps ignored
+    // Who the student is across saves: the lowercased email, or the name and
+    // date of birth when there is no email. Student IDs are renumbered
+    // whenever the roster changes order, so they cannot be used for this.
+    std::string identityKey() const;
+    
+    // Mask with the first subjectCount subjects present
+    static std::uint32_t fullScoreMask(size_t subjectCount);
+    static const size_t MAX_SUBJECTS = 32;
     
     // Static method for creating sample data
     static std::vector<Student> createSampleData();
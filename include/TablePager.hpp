@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+#include "Screen.hpp"
+#include "SortEngine.hpp"
+#include "Student.hpp"
+
+// Page-at-a-time view of a student table. Only the page on screen is
+// formatted; while the user reads it, the next page is formatted on a
+// background thread. Commands (typed, then Enter):
+//
+//   Enter / n   next page        p        previous page
+//   g N         go to page N     /text    next row whose ID or name contains text
+//   s KEY       sort by avg, gpa, name, id or age (again to reverse); s off restores
+//   q           back to the menu
+class TablePager {
+public:
+    TablePager(const std::vector<Student>& students, std::vector<std::uint32_t> rows);
+    ~TablePager();
+
+    TablePager(const TablePager&) = delete;
+    TablePager& operator=(const TablePager&) = delete;
+
+    void run();
+
+    size_t pageCount() const;
+
+    // Students that fit on one screen of the current terminal
+    static size_t rowsPerPage();
+
+private:
+    const std::vector<Student>& students;
+    const std::vector<std::uint32_t> originalRows;
+    std::vector<std::uint32_t> rows;            // display order
+    size_t pageSize;
+    size_t page = 0;
+    std::string sortLabel;
+    SortKey sortKey = SortKey::StudentNumber;
+    bool sortDescending = false;
+    size_t searchFrom = 0;                      // position after the last match
+    std::string status;
+    Screen screen;
+
+    std::map<size_t, std::string> rendered;     // formatted pages near the current one
+    std::future<std::string> prefetch;
+    size_t prefetchPage = 0;
+
+    std::string render(size_t pageIndex) const;
+    const std::string& pageText(size_t pageIndex);
+    void startPrefetch(size_t pageIndex);
+    void finishPrefetch();                      // before anything touches the roster on this thread
+    void invalidate();
+    void show();
+    std::string pageFrame();
+
+    void goTo(long long pageIndex);           // 0-based
+    void search(const std::string& text);
+    void sort(const std::string& key);
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Student.hpp"
+
+// Student table writer for bulk output, without tabulate. One pass finds
+// the column widths, a second appends every line into one reserved
+// buffer: numbers go through std::to_chars and colors come straight from
+// the letter grade, so there is no per-cell string or format object and
+// the caller writes the whole screen with a single flush.
+class TableRenderer {
+public:
+    // Appends rows[begin, end) as an ASCII table; color adds ANSI grade colors
+    static void appendStudents(std::string& out, const std::vector<Student>& students,
+                               const std::vector<std::uint32_t>& rows, size_t begin, size_t end, bool color);
+
+    static std::string renderStudents(const std::vector<Student>& students, const std::vector<std::uint32_t>& rows,
+                                      size_t begin, size_t end, bool color);
+
+    // Terminal columns taken by UTF-8 text, counting one per code point
+    static size_t displayWidth(const std::string& text);
+
+    // "12.34": value cut (not rounded) to two decimals, as grade tables show it
+    static void appendTruncated2(std::string& out, double value);
+    static void appendFixed2(std::string& out, double value);   // rounded
+    static void appendInt(std::string& out, long long value);
+
+    // ANSI color of a letter grade (A-C green, D-E yellow, F red), "" otherwise
+    static const char* gradeColor(const std::string& letterGrade);
+};
@@ -0,0 +1,214 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Set from any thread; work that has not started yet is skipped
+class CancellationToken {
+public:
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> cancelled{false};
+};
+
+// Called on the thread that started the work, so it may update the UI
+using ProgressCallback = std::function<void(size_t completed, size_t total)>;
+
+class TaskScheduler;
+
+// Tasks submitted together and waited on together. The waiting thread runs
+// queued tasks itself instead of blocking, so groups can nest: a task may
+// start and wait on its own group without tying up a worker.
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler& scheduler, const CancellationToken* token = nullptr);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task);
+
+    // Returns false when the token cancelled part of the work. The first
+    // exception thrown by a task is rethrown here.
+    bool wait(const std::function<void()>& onIdle = nullptr);
+
+    // Helps like wait() until fewer than limit tasks are pending, so a
+    // producer cannot run ahead of the tasks it submits. Does not rethrow.
+    void waitBelow(size_t limit);
+
+private:
+    TaskScheduler& scheduler;
+    const CancellationToken* token;
+    std::atomic<size_t> pending{0};
+    std::atomic<bool> skipped{false};
+    std::mutex doneMutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+};
+
+// Long jobs that must not overlap (backups, exports, report cards): they run
+// one at a time, in the order submitted, on a worker of the pool, and the
+// caller only queues them. A finished job is dropped from the queue at
+// once. On a pool without workers a job runs on the submitting thread.
+class JobQueue {
+public:
+    JobQueue();                                   // on TaskScheduler::shared(), created at first submit
+    explicit JobQueue(TaskScheduler& scheduler);
+    ~JobQueue();                                  // waits for every job
+
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    // Exceptions escaping a job are swallowed; jobs report their own errors
+    void submit(std::function<void()> job);
+    void wait();                                  // until every submitted job has finished
+    size_t pending() const;                       // queued or running
+    bool runsInBackground();                      // false when jobs run on the submitter
+
+private:
+    TaskScheduler* scheduler;
+    mutable std::mutex queueMutex;
+    std::condition_variable idle;
+    std::deque<std::function<void()>> jobs;
+    size_t unfinished = 0;
+    bool draining = false;                        // a drain task is queued or running
+
+    TaskScheduler& pool();
+    void drain();
+};
+
+// Shared pool of worker threads, one work-stealing deque per worker. A
+// worker takes its newest task first (still warm in cache) and, when idle,
+// steals the oldest task from another worker's deque. Threads that are not
+// workers push round-robin and help while they wait.
+//
+// parallelFor / parallelReduce split [0, count) into chunks of at least
+// grain items; work that fits in one chunk runs inline on the caller.
+class TaskScheduler {
+public:
+    static TaskScheduler& shared();
+
+    // Threads used including the caller; 0 restores hardware_concurrency.
+    // Takes effect when shared() is next created, so call it before any
+    // parallel work (e.g. from main). SCOREME_THREADS sets the same value.
+    static void setThreadCount(size_t threads);
+    static size_t configuredThreadCount();
+
+    explicit TaskScheduler(size_t threads);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    size_t threadCount() const;   // workers plus the calling thread
+    size_t chunkCount(size_t count, size_t grain) const;
+
+    template <typename Body>
+    bool parallelFor(size_t count, size_t grain, Body body,
+                     const CancellationToken* token = nullptr, const ProgressCallback& progress = nullptr);
+
+    // map(begin, end) -> T per chunk; chunks are combined in index order on
+    // the calling thread, so floating-point results do not depend on timing
+    template <typename T, typename Map, typename Combine>
+    T parallelReduce(size_t count, size_t grain, T identity, Map map, Combine combine,
+                     const CancellationToken* token = nullptr);
+
+private:
+    friend class TaskGroup;
+    friend class JobQueue;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> nextWorker{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    void push(std::function<void()> task);
+    bool runOne(size_t self);
+    bool runOne();
+    void workerLoop(size_t index);
+    size_t currentWorker() const;   // workers.size() when not a worker of this pool
+
+    static size_t overrideThreads;
+};
+
+template <typename Body>
+bool TaskScheduler::parallelFor(size_t count, size_t grain, Body body,
+                                const CancellationToken* token, const ProgressCallback& progress) {
+    size_t chunks = chunkCount(count, grain);
+    if (chunks <= 1) {
+        if (count == 0) return true;
+        if (token && token->isCancelled()) return false;
+        body(size_t(0), count);
+        if (progress) progress(count, count);
+        return true;
+    }
+
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    std::atomic<size_t> completed{0};
+    TaskGroup group(*this, token);
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        size_t end = std::min(count, begin + chunkSize);
+        group.run([&body, &completed, begin, end] {
+            body(begin, end);
+            completed.fetch_add(end - begin, std::memory_order_relaxed);
+        });
+    }
+
+    size_t reported = 0;
+    auto report = [&] {
+        size_t now = completed.load(std::memory_order_relaxed);
+        if (progress && now != reported) {
+            reported = now;
+            progress(now, count);
+        }
+    };
+    bool finished = group.wait(report);
+    report();
+    return finished;
+}
+
+template <typename T, typename Map, typename Combine>
+T TaskScheduler::parallelReduce(size_t count, size_t grain, T identity, Map map, Combine combine,
+                                const CancellationToken* token) {
+    size_t chunks = chunkCount(count, grain);
+    if (chunks <= 1) {
+        if (count > 0 && !(token && token->isCancelled())) {
+            T part = map(size_t(0), count);
+            combine(identity, part);
+        }
+        return identity;
+    }
+
+    size_t chunkSize = (count + chunks - 1) / chunks;
+    std::vector<std::unique_ptr<T>> parts((count + chunkSize - 1) / chunkSize);
+    parallelFor(parts.size(), 1, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+            size_t begin = c * chunkSize;
+            parts[c].reset(new T(map(begin, std::min(count, begin + chunkSize))));
+        }
+    }, token);
+
+    for (auto& part : parts) {
+        if (part) combine(identity, *part);   // cancelled chunks were never mapped
+    }
+    return identity;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Student.hpp"
+
+// One student's scores as captured by one backup
+struct TrendPoint {
+    std::int64_t timestamp;                  // seconds since the epoch
+    double average;
+    std::vector<double> subjectScores;       // NaN for a subject not taken
+};
+
+struct TrendSummary {
+    size_t points = 0;
+    double firstAverage = 0.0;
+    double lastAverage = 0.0;
+    double lowestAverage = 0.0;
+    double highestAverage = 0.0;
+    double slopePerMonth = 0.0;              // least-squares change in average per 30 days
+};
+
+// Append-only time series of per-student scores, one block per backup.
+// Students are keyed by Student::identityKey(), since IDs are renumbered
+// between backups. Inside a block rows are sorted by key; keys are
+// front-coded and every value column stores the zigzag varint of its
+// change since that student's previous snapshot, in hundredths of a point.
+// Scores rarely move between backups, so most values take a single byte.
+//
+// Opening the store decodes it once into per-student series keyed the same
+// way, so a history query is a hash lookup plus a copy of that student's
+// points.
+class TrendStore {
+public:
+    // Empty store when the file does not exist. A block cut short by an
+    // interrupted append is ignored and overwritten by the next append.
+    static TrendStore open(const std::string& filename);
+
+    // The archive's store; backups taken before it existed are read once
+    // (oldest first) to backfill it, leaving out pendingBackup, which the
+    // caller is about to append itself. A store from before students were
+    // keyed by identity is set aside as trends.store.v1 and rebuilt.
+    static TrendStore openArchive(const std::string& backupDirectory, const std::string& pendingBackup = "");
+    static std::string archiveFilename(const std::string& backupDirectory);
+
+    void append(const std::vector<Student>& students, std::int64_t timestamp);
+
+    std::vector<TrendPoint> history(const Student& student) const;
+    static TrendSummary summarize(const std::vector<TrendPoint>& points);
+
+    size_t snapshotCount() const;
+    size_t studentCount() const;
+    std::uint64_t storedBytes() const;
+    std::uint64_t storedValues() const;
+
+private:
+    struct Series {
+        std::vector<std::uint32_t> snapshots;    // index into snapshotTimes
+        std::vector<std::uint32_t> offsets;      // start of each point in values; one extra at the end
+        std::vector<std::int32_t> values;        // hundredths: average, then subjects
+    };
+
+    std::string filename;
+    std::vector<std::int64_t> snapshotTimes;
+    std::vector<Series> series;
+    std::unordered_map<std::string, std::uint32_t> seriesIndex;
+    std::uint64_t validBytes = 0;
+    std::uint64_t valueCount = 0;
+
+    void decodeBlock(const std::string& block);
+    std::uint32_t seriesFor(const std::string& identity);
+};
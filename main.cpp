@@ -3,22 +3,49 @@
 #include <memory>
 #include <string>
 #include <algorithm>
+#include <chrono>
+#include <future>
 #include "Student.hpp"
 #include "Admin.hpp"
 #include "Person.hpp"
 #include "ExcelUtil.hpp"
 #include "MenuUtils.hpp"
+#include "Gradebook.hpp"
+#include "BatchCli.hpp"
+#include "RosterStore.hpp"
+#include "StartupProfile.hpp"
 
 using namespace std;
 
 class ScoreMEApp {
 private:
     vector<Student> registeredStudents;
+    RosterStore roster;   // published versions for background reports, exports and backups
     Admin admin;
+    // Roster load, grades and search index, started before the welcome
+    // screen; nothing on the UI thread touches the three members above
+    // until waitForData has returned
+    shared_future<void> dataReady;
+    bool startupReported = false;
     
 public:
     ScoreMEApp() {
+        admin.attachRosterStore(roster);
+        dataReady = async(launch::async, [this] { loadInBackground(); }).share();
+    }
+    
+    ~ScoreMEApp() {
+        if (dataReady.valid()) dataReady.wait();   // the loader uses the members
+    }
+    
+    void loadInBackground() {
+        // Messages are shown by the UI thread, on the admin dashboard or at exit
+        MenuUtils::setDeferredOutput(true);
         loadExistingDataOrCreateSample();
+        roster.publish(registeredStudents);
+        StartupProfile::mark("roster published");
+        admin.prepareSearchIndex(registeredStudents);
+        StartupProfile::mark("search index built");
     }
     
     void loadExistingDataOrCreateSample() {
@@ -27,13 +54,22 @@ public:
             if (ExcelUtils::fileExists("data/students.xlsx")) {
                 MenuUtils::printInfo("Loading existing student data...");
                 registeredStudents = ExcelUtils::readExcelToVector("data/students.xlsx");
+                StartupProfile::mark("roster read (" + to_string(registeredStudents.size()) + " students)");
                 
                 setupMissingStudentLoginCredentials();
+                StartupProfile::mark("login credentials checked");
+                try {
+                    Gradebook::open().applyTo(registeredStudents);   // ledger only; term workbooks stay closed
+                } catch (const exception& e) {
+                    MenuUtils::printWarning("Could not read gradebook: " + string(e.what()));
+                }
+                StartupProfile::mark("gradebook applied");
                 MenuUtils::printSuccess("Loaded " + to_string(registeredStudents.size()) + " students from Excel file!");
             } else {
                 MenuUtils::printInfo("No existing data found. Creating sample data...");
                 initializeStudentAccounts();
                 createSampleExcelFiles();
+                StartupProfile::mark("sample data created");
             }
         } catch (const exception& e) {
             MenuUtils::printError("Error loading data: " + string(e.what()));
@@ -44,6 +80,7 @@ public:
     
     void setupMissingStudentLoginCredentials() {
         bool hasChanges = false;
+        size_t preserved = 0;
         
         for (auto& student : registeredStudents) {
             string currentUsername = student.getUsername();
@@ -113,9 +150,13 @@ public:
                     MenuUtils::printInfo("Auto-generated login for " + name + " - Username: " + firstName + ", Password: " + firstName + "123");
                 }
             } else {
-                MenuUtils::printInfo("Preserving existing credentials for " + student.getName() + " (Username: " + currentUsername + ")");
+                preserved++;
             }
         }
+        // One line, not one per student: a large roster would otherwise queue a message per row
+        if (preserved > 0) {
+            MenuUtils::printInfo("Preserved existing credentials for " + to_string(preserved) + " students.");
+        }
         
         // Save changes only if we set new credentials for students who had none
         if (hasChanges) {
@@ -170,13 +211,42 @@ public:
         }
     }
     
+    // Menus that need the roster call this first. If loading is still
+    // running a progress bar is shown until it finishes; a failed load
+    // is rethrown here.
+    void waitForData(const string& message) {
+        if (dataReady.wait_for(chrono::seconds(0)) != future_status::ready) {
+            double started = StartupProfile::elapsedMs();
+            MenuUtils::showLoadingAnimation(message, dataReady);
+            StartupProfile::mark("waited " + to_string(static_cast<long long>(StartupProfile::elapsedMs() - started)) +
+                                 " ms for data");
+        }
+        dataReady.get();
+        reportStartup();
+    }
+    
+    // Printed to stderr once the first menu is up and loading has finished
+    void reportStartup() {
+        if (startupReported || !StartupProfile::isEnabled()) return;
+        if (dataReady.wait_for(chrono::seconds(0)) != future_status::ready) return;
+        startupReported = true;
+        cerr << StartupProfile::report() << flush;
+    }
+    
     void run() {
-        MenuUtils::printWelcome();
+        MenuUtils::printWelcome(dataReady);
+        StartupProfile::mark("welcome screen");
         
         int choice;
+        bool firstMenu = true;
         do {
             MenuUtils::clearScreen();
             MenuUtils::printMainMenu();
+            if (firstMenu) {
+                StartupProfile::mark("first menu");
+                firstMenu = false;
+            }
+            reportStartup();
             choice = MenuUtils::getMenuChoice(3);
             
             switch (choice) {
@@ -186,12 +256,19 @@ public:
                 case 2:
                     handleStudentLogin();
                     break;
-                case 3:
-                    // Save data before exit
+                case 3: {
+                    // Save data before exit, while the goodbye screen is up
+                    waitForData("Finishing loading before saving");
                     MenuUtils::printInfo("Saving all data...");
-                    saveDataOnExit();
-                    MenuUtils::printThankYou();
+                    shared_future<void> saved = async(launch::async, [this] {
+                        MenuUtils::setDeferredOutput(true);
+                        saveDataOnExit();
+                    }).share();
+                    MenuUtils::printThankYou(saved);
+                    saved.get();
+                    admin.waitForBackgroundJobs();   // also shows the save messages
                     break;
+                }
             }
             
             if (choice != 3) {
@@ -206,7 +283,8 @@ private:
         MenuUtils::clearScreen();
         
         if (admin.login()) {
-            MenuUtils::showLoadingAnimation("Loading Admin Dashboard", 2000);
+            waitForData("Loading Admin Dashboard");
+            MenuUtils::printLoginSuccess();
             admin.showMenuWithData(registeredStudents);
         } else {
             MenuUtils::printError("Admin login failed!");
@@ -219,6 +297,7 @@ private:
         
         string username = MenuUtils::getStringInput("Username: ");
         string password = MenuUtils::getHiddenInput("Password: ");
+        waitForData("Checking credentials");
         
         // Find student with matching credentials
         Student* loggedInStudent = nullptr;
@@ -234,7 +313,8 @@ private:
             MenuUtils::pauseScreen();
             
             // Show loading animation before entering student dashboard
-            MenuUtils::showLoadingAnimation("Loading Student Dashboard", 2000);
+            MenuUtils::showLoadingAnimation("Loading Student Dashboard");
+            MenuUtils::printLoginSuccess();
             
             loggedInStudent->showMenu();
         } else {
@@ -272,13 +352,26 @@ void createSampleDataFiles() {
 }
 
 int main(int argc, char* argv[]) {
+    StartupProfile::begin();
     try {
+        // Prints where the time to the first menu went
+        if (argc > 1 && string(argv[1]) == "--startup-report") {
+            StartupProfile::setEnabled(true);
+            argc--;
+            argv++;
+        }
+        
         // Check if we're being called to create sample data
         if (argc > 1 && string(argv[1]) == "--create-sample-data") {
             createSampleDataFiles();
             return 0;
         }
         
+        // Scriptable commands (import, merge, regrade, report, export, backup, stats) run headless
+        if (argc > 1 && BatchCli::isBatchCommand(argv[1])) {
+            return BatchCli::run(vector<string>(argv + 1, argv + argc));
+        }
+        
         ScoreMEApp app;
         app.run();
     } catch (const exception& e) {
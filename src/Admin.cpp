@@ -2,11 +2,28 @@
 #include "MenuUtils.hpp"
 #include "ExcelUtil.hpp"
 #include "GradeUtil.hpp"
+#include "GradeStats.hpp"
+#include "GroupBy.hpp"
+#include "QuantileSketch.hpp"
+#include "SortEngine.hpp"
+#include "RosterQuery.hpp"
+#include "RegradeSimulator.hpp"
+#include "ScoreAnalysis.hpp"
+#include "TrendStore.hpp"
+#include "Gradebook.hpp"
+#include "ImportPipeline.hpp"
+#include "ReportCard.hpp"
+#include "RosterExport.hpp"
+#include "RosterValidator.hpp"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <future>
 #include <set>
+#include <sstream>
 #include <cctype>
+#include <stdexcept>
 
 // Add these includes for file dialog
 #ifdef _WIN32
@@ -24,12 +41,80 @@ using namespace std;  // Add this to avoid std:: prefix issues
 const std::string Admin::DEFAULT_ADMIN_USERNAME = "scoreme.pro";
 const std::string Admin::DEFAULT_ADMIN_PASSWORD = "prome@123";
 
+namespace {
+    const size_t SEARCH_RESULT_LIMIT = 10;
+
+    // Asks for every subject's score; a blank answer marks the subject as not taken
+    void promptSubjectScores(const std::string& suffix, std::vector<double>& scores, uint32_t& presentMask) {
+        vector<string> subjects = GradeUtil::getSubjectNames();
+        scores.assign(subjects.size(), 0.0);
+        presentMask = 0;
+        for (size_t i = 0; i < subjects.size(); ++i) {
+            string input = MenuUtils::getStringInput(subjects[i] + suffix);
+            if (input.empty()) continue;
+            try {
+                size_t used = 0;
+                double score = stod(input, &used);
+                if (used == input.size() && GradeUtil::isValidScore(score)) {
+                    scores[i] = score;
+                    presentMask |= 1u << i;
+                    continue;
+                }
+            } catch (...) {
+            }
+            MenuUtils::printError("Invalid score! Score must be between 0-100 (leave blank if not taken).");
+            i--; // Retry current subject
+        }
+    }
+}
+
 // Constructors
 Admin::Admin() : Person(DEFAULT_ADMIN_USERNAME, DEFAULT_ADMIN_PASSWORD, "Administrator") {}
 
 Admin::Admin(const std::string& username, const std::string& password, const std::string& name)
     : Person(username, password, name) {}
 
+Admin::~Admin() {
+    waitForBackgroundJobs();
+}
+
+void Admin::attachRosterStore(RosterStore& store) {
+    rosterStore = &store;
+}
+
+void Admin::prepareSearchIndex(const std::vector<Student>& students) {
+    searchIndex.rebuild(students);
+}
+
+void Admin::waitForBackgroundJobs() {
+    backgroundJobs.wait();
+    MenuUtils::flushDeferredMessages();
+}
+
+void Admin::runInBackground(const std::string& description,
+                            std::function<void(const std::vector<Student>&)> job) {
+    MenuUtils::flushDeferredMessages();
+
+    auto version = rosterStore->current();
+    size_t ahead = backgroundJobs.pending();
+    bool background = backgroundJobs.runsInBackground();
+    backgroundJobs.submit([version, description, job, background] {
+        // Pool workers also run other tasks; only this job's messages wait for the UI
+        if (background) MenuUtils::setDeferredOutput(true);
+        try {
+            job(version->toVector());
+            MenuUtils::printSuccess(description + " finished (roster version " + to_string(version->number()) + ").");
+        } catch (const exception& e) {
+            MenuUtils::printError(description + " failed: " + string(e.what()));
+        }
+        if (background) MenuUtils::setDeferredOutput(false);
+    });
+    if (!background) return;
+    string queued = ahead > 0 ? " after " + to_string(ahead) + " earlier job(s)" : "";
+    MenuUtils::printInfo(description + " will run in the background" + queued + " on roster version " +
+                         to_string(version->number()) + "; you can keep editing.");
+}
+
 // Override virtual methods
 bool Admin::login() {
     MenuUtils::printHeader("ADMIN LOGIN");
@@ -92,10 +177,16 @@ void Admin::showMenu() {
 // ENHANCED: showMenuWithData with improved import functionality
 void Admin::showMenuWithData(std::vector<Student>& students) {
     int choice;
+    // Usually built at startup by prepareSearchIndex; edits below keep it current
+    if (searchIndex.size() != students.size()) {
+        searchIndex.rebuild(students);
+    }
     
     do {
+        if (rosterStore) rosterStore->publish(students);
         MenuUtils::clearScreen();
         MenuUtils::printAdminMenu();
+        MenuUtils::flushDeferredMessages();
         
         // Show current data status
         if (!students.empty()) {
@@ -109,7 +200,7 @@ void Admin::showMenuWithData(std::vector<Student>& students) {
         }
         cout << endl;
         
-        choice = MenuUtils::getMenuChoice(5);
+        choice = MenuUtils::getMenuChoice(7);
         
         switch (choice) {
             case 1:
@@ -121,10 +212,11 @@ void Admin::showMenuWithData(std::vector<Student>& students) {
                 std::vector<std::string> importMainOptions = {
                     "Import Excel File (Browse Computer)",
                     "Show Recent Files",
+                    "Validate Current Roster",
                     "Back to Admin Menu"
                 };
                 MenuUtils::printMenu(importMainOptions);
-                int importChoice = MenuUtils::getMenuChoice(3);
+                int importChoice = MenuUtils::getMenuChoice(4);
                 switch (importChoice) {
                     case 1:
                         MenuUtils::clearScreen();  // Clear screen before file import
@@ -136,6 +228,11 @@ void Admin::showMenuWithData(std::vector<Student>& students) {
                         MenuUtils::pauseScreen();
                         break;
                     case 3:
+                        MenuUtils::clearScreen();
+                        validateRoster(students);
+                        MenuUtils::pauseScreen();
+                        break;
+                    case 4:
                         break; // Back to admin menu
                 }
                 break;
@@ -151,16 +248,351 @@ void Admin::showMenuWithData(std::vector<Student>& students) {
                 break;
                 
             case 5:
-                MenuUtils::printInfo("Signing out from admin dashboard...");
-                return;
+                showAnalyticsMenu(students);
+                break;
+                
+            case 6:
+                manageTerms(students);
+                break;
+                
+            case 7:
+                break;
         }
         
-        if (choice != 5) {
+        if (choice != 7) {
             if (!MenuUtils::askContinue()) {
                 break;
             }
         }
-    } while (choice != 5);
+    } while (choice != 7);
+    
+    MenuUtils::printInfo("Signing out from admin dashboard...");
+    if (rosterStore) {
+        rosterStore->publish(students);
+        if (backgroundJobs.pending() > 0) MenuUtils::printInfo("Waiting for background jobs to finish...");
+        waitForBackgroundJobs();
+    }
+}
+
+void Admin::showAnalyticsMenu(std::vector<Student>& students) {
+    int choice;
+    do {
+        MenuUtils::clearScreen();
+        MenuUtils::printHeader("ANALYTICS & REPORTS");
+        
+        vector<string> analyticsMenu = {
+            "Grade Report & Subject Statistics",
+            "Archive Percentiles (All Backups)",
+            "Cohort Breakdown (Group By)",
+            "What-If Regrading Simulator",
+            "Subject Correlation & Outliers",
+            "Student Score History (All Backups)",
+            "Per-Student Report Cards",
+            "Back to Admin Dashboard"
+        };
+        
+        MenuUtils::printMenu(analyticsMenu);
+        choice = MenuUtils::getMenuChoice(8);
+        
+        switch (choice) {
+            case 1:
+                MenuUtils::displayGradeReport(students);
+                break;
+            case 2:
+                showArchivePercentiles();
+                break;
+            case 3:
+                showCohortBreakdown(students);
+                break;
+            case 4:
+                showRegradeSimulator(students);
+                break;
+            case 5:
+                MenuUtils::displayAnomalyReport(students, ScoreAnalysis::analyze(students));
+                break;
+            case 6:
+                showStudentHistory(students);
+                break;
+            case 7:
+                generateReportCards(students);
+                break;
+            case 8:
+                return;
+        }
+        
+        if (choice != 8) {
+            MenuUtils::pauseScreen();
+        }
+    } while (choice != 8);
+}
+
+void Admin::manageTerms(std::vector<Student>& students) {
+    int choice;
+    do {
+        MenuUtils::clearScreen();
+        MenuUtils::printHeader("TERMS & TRANSCRIPTS");
+        
+        vector<string> termMenu = {
+            "Close Current Roster as a Term",
+            "List Recorded Terms",
+            "Export Transcripts (All Students)",
+            "Back to Admin Dashboard"
+        };
+        
+        MenuUtils::printMenu(termMenu);
+        choice = MenuUtils::getMenuChoice(4);
+        
+        try {
+            switch (choice) {
+                case 1: {
+                    if (students.empty()) {
+                        MenuUtils::printWarning("No students to record!");
+                        break;
+                    }
+                    string term = MenuUtils::getStringInput("Term name (e.g. 2025 Semester 1): ");
+                    if (term.empty()) {
+                        MenuUtils::printError("Term name cannot be empty!");
+                        break;
+                    }
+                    
+                    Gradebook gradebook = Gradebook::open();
+                    if (gradebook.hasTerm(term)) {
+                        string confirm = MenuUtils::getStringInput("Term '" + term + "' already exists. Replace it with the current roster? (y/n): ");
+                        if (confirm != "y" && confirm != "Y") {
+                            MenuUtils::printInfo("Term left unchanged.");
+                            break;
+                        }
+                    }
+                    
+                    bool corrected = gradebook.recordTerm(term, students);
+                    gradebook.applyTo(students);
+                    MenuUtils::printSuccess(string(corrected ? "Corrected" : "Recorded") + " term '" + term + "' for " +
+                                            to_string(students.size()) + " students. Cumulative GPAs updated.");
+                    break;
+                }
+                case 2:
+                    MenuUtils::displayTermSummaries(Gradebook::open().termSummaries());
+                    break;
+                case 3: {
+                    Gradebook gradebook = Gradebook::open();
+                    if (gradebook.terms().empty()) {
+                        MenuUtils::printWarning("No terms recorded yet. Close the current roster as a term first.");
+                        break;
+                    }
+                    vector<Transcript> transcripts = gradebook.buildTranscripts();
+                    ExcelUtils::exportTranscripts("data/transcripts.xlsx", transcripts);
+                    MenuUtils::printInfo(to_string(transcripts.size()) + " transcripts across " +
+                                         to_string(gradebook.terms().size()) + " term(s).");
+                    break;
+                }
+                case 4:
+                    return;
+            }
+        } catch (const exception& e) {
+            MenuUtils::printError("Gradebook error: " + string(e.what()));
+        }
+        
+        if (choice != 4) {
+            MenuUtils::pauseScreen();
+        }
+    } while (choice != 4);
+}
+
+void Admin::showCohortBreakdown(const std::vector<Student>& students) {
+    MenuUtils::printHeader("COHORT BREAKDOWN");
+    
+    const auto& keys = GroupBy::allKeys();
+    vector<string> keyMenu;
+    for (GroupKey key : keys) {
+        keyMenu.push_back("Group by " + GroupBy::keyName(key));
+    }
+    MenuUtils::printMenu(keyMenu);
+    GroupKey key = keys[MenuUtils::getMenuChoice(static_cast<int>(keys.size())) - 1];
+    
+    MenuUtils::displayGroupSummaries(GroupBy::aggregate(students, key), key);
+}
+
+void Admin::showArchivePercentiles() {
+    MenuUtils::printHeader("ARCHIVE PERCENTILES");
+    
+    size_t snapshotCount = 0;
+    ScoreSketches archive = ScoreSketches::loadArchive("data/backups", snapshotCount);
+    if (snapshotCount == 0) {
+        MenuUtils::printWarning("No backups found in data/backups/. Create a backup first.");
+        return;
+    }
+    
+    MenuUtils::displayArchivePercentiles(archive, snapshotCount);
+    
+    const QuantileSketch* averages = archive.find(ScoreSketches::AVERAGE_COLUMN);
+    string input = MenuUtils::getStringInput("Enter an average score to find its archive percentile (blank to skip): ");
+    if (averages && !input.empty()) {
+        try {
+            double score = stod(input);
+            double percentile = averages->rank(score) * 100.0;
+            MenuUtils::printInfo("An average of " + GradeStats::formatValue(score) + " is at percentile " +
+                                 GradeStats::formatValue(percentile) + " (±" +
+                                 GradeStats::formatValue(averages->rankErrorBound() * 100.0) + ") across all backups.");
+        } catch (...) {
+            MenuUtils::printError("Invalid score!");
+        }
+    }
+}
+
+void Admin::showStudentHistory(const std::vector<Student>& students) {
+    MenuUtils::printHeader("STUDENT SCORE HISTORY");
+    
+    string id = MenuUtils::getStringInput("Enter Student ID: ");
+    transform(id.begin(), id.end(), id.begin(), ::toupper);
+    
+    try {
+        TrendStore trends = TrendStore::openArchive("data/backups");
+        if (trends.snapshotCount() == 0) {
+            MenuUtils::printWarning("No backups found in data/backups/. Create a backup first.");
+            return;
+        }
+        
+        // History follows the student, not the ID, which may have been renumbered since
+        auto current = find_if(students.begin(), students.end(),
+                               [&id](const Student& student) { return student.getStudentId() == id; });
+        if (current == students.end()) {
+            MenuUtils::printError("Student " + id + " not found!");
+            return;
+        }
+        vector<TrendPoint> history = trends.history(*current);
+        if (history.empty()) {
+            MenuUtils::printError("Student " + id + " does not appear in any of " + to_string(trends.snapshotCount()) + " backup(s)!");
+            return;
+        }
+        
+        MenuUtils::displayStudentHistory(current->getName() + " (" + id + ")", history, TrendStore::summarize(history));
+        MenuUtils::printInfo("Trend store: " + to_string(trends.snapshotCount()) + " snapshot(s), " +
+                             to_string(trends.studentCount()) + " student(s), " +
+                             GradeStats::formatValue(static_cast<double>(trends.storedBytes()) / max<uint64_t>(1, trends.storedValues())) +
+                             " bytes per stored score");
+    } catch (const exception& e) {
+        MenuUtils::printError("Failed to read score history: " + string(e.what()));
+    }
+}
+
+void Admin::generateReportCards(const std::vector<Student>& students) {
+    MenuUtils::printHeader("PER-STUDENT REPORT CARDS");
+    
+    if (students.empty()) {
+        MenuUtils::printWarning("No student data available!");
+        return;
+    }
+    
+    ReportCardOptions options;
+    string format = MenuUtils::getStringInput("Format (html/text/xlsx) [html]: ");
+    if (!format.empty() && !ReportCards::parseFormat(format, options.format)) {
+        MenuUtils::printError("Unknown format '" + format + "'.");
+        return;
+    }
+    string directory = MenuUtils::getStringInput("Output directory [" + options.directory + "]: ");
+    if (!directory.empty()) options.directory = directory;
+    
+    auto reportResult = [](const ReportCardResult& result) {
+        for (const auto& failure : result.failures) {
+            MenuUtils::printWarning("Could not write " + failure);
+        }
+        if (result.failed > result.failures.size()) {
+            MenuUtils::printWarning("... and " + to_string(result.failed - result.failures.size()) + " more");
+        }
+        MenuUtils::printSuccess(to_string(result.written) + " report cards written to " + result.directory +
+                                " in " + to_string(static_cast<long long>(result.elapsedMs)) + " ms");
+    };
+    
+    if (rosterStore) {
+        runInBackground("Report cards", [options, reportResult](const vector<Student>& snapshot) {
+            reportResult(ReportCards::generate(snapshot, options));
+        });
+        return;
+    }
+    
+    try {
+        size_t lastShown = 0;
+        auto result = ReportCards::generate(students, options, [&lastShown](size_t completed, size_t total) {
+            // Redraw at most a hundred times however many cards there are
+            if (completed != total && completed - lastShown < total / 100) return;
+            lastShown = completed;
+            cout << "\r  " << completed << " / " << total << " cards" << flush;
+        });
+        cout << endl;
+        reportResult(result);
+    } catch (const exception& e) {
+        MenuUtils::printError("Failed to generate report cards: " + string(e.what()));
+    }
+}
+
+void Admin::showRegradeSimulator(const std::vector<Student>& students) {
+    MenuUtils::printHeader("WHAT-IF REGRADING SIMULATOR");
+    
+    if (students.empty()) {
+        MenuUtils::printWarning("No students to simulate!");
+        return;
+    }
+    
+    // Averages are extracted once and reused for every run below
+    RegradeSimulator simulator(students);
+    do {
+        GradeScale scale = GradeScale::current();
+        while (true) {
+            string input = MenuUtils::getStringInput("Grade boundaries A B C D E (blank keeps 90 80 70 60 50): ");
+            if (input.find_first_not_of(" \t") == string::npos) {
+                break;
+            }
+            istringstream values(input);
+            GradeScale candidate = scale;
+            bool complete = true;
+            for (double& threshold : candidate.thresholds) {
+                complete = complete && static_cast<bool>(values >> threshold);
+            }
+            if (complete && candidate.isValid()) {
+                scale = candidate;
+                break;
+            }
+            MenuUtils::printError("Enter five descending scores between 0 and 100, e.g. 85 75 65 55 45");
+        }
+        
+        vector<string> curveMenu = {
+            "No curve",
+            "Linear shift (add points)",
+            "Z-score normalization",
+            "Bell-curve mapping (by rank)"
+        };
+        MenuUtils::printMenu(curveMenu);
+        Curve curve;
+        int curveChoice = MenuUtils::getMenuChoice(4);
+        switch (curveChoice) {
+            case 2:
+                curve.type = CurveType::LinearShift;
+                curve.shift = MenuUtils::getDoubleInput("Points to add (negative to subtract): ");
+                break;
+            case 3:
+            case 4:
+                curve.type = (curveChoice == 3) ? CurveType::ZScore : CurveType::BellCurve;
+                curve.targetMean = MenuUtils::getDoubleInput("Target mean: ");
+                curve.targetStdDev = MenuUtils::getDoubleInput("Target standard deviation: ");
+                break;
+            default:
+                break;
+        }
+        
+        MenuUtils::displayRegradeOutcome(students, simulator.simulate(scale, curve), scale, curve);
+        
+        string sweep = MenuUtils::getStringInput("Sweep pass marks? Enter 'from to step' (blank to skip): ");
+        double from = 0.0, to = 0.0, step = 0.0;
+        istringstream range(sweep);
+        if (range >> from >> to >> step) {
+            if (step <= 0.0 || from > to || (to - from) / step > 200.0) {
+                MenuUtils::printError("Use from <= to and a positive step (at most 200 marks).");
+            } else {
+                RegradeOutcome baseline = simulator.simulate(GradeScale::current(), Curve());
+                MenuUtils::displayPassMarkSweep(simulator.sweepPassMarks(curve, from, to, step), baseline.currentPassRate);
+            }
+        }
+    } while (MenuUtils::getStringInput("Run another simulation? (y/n): ") == "y");
 }
 
 std::string Admin::getRole() const {
@@ -169,37 +601,38 @@ std::string Admin::getRole() const {
 
 // Function to reorder all student IDs sequentially
 void Admin::reorderStudentIds(std::vector<Student>& students) {
-    // Sort students by current ID to maintain some order
-    sort(students.begin(), students.end(),
-        [](const Student& a, const Student& b) {
-            string idA = a.getStudentId();
-            string idB = b.getStudentId();
-            
-            // Extract numeric part and compare
-            int numA = 0, numB = 0;
-            if (idA.length() >= 6 && idA.substr(0, 3) == "STU") {
-                try { numA = stoi(idA.substr(3)); } catch(...) {}
-            }
-            if (idB.length() >= 6 && idB.substr(0, 3) == "STU") {
-                try { numB = stoi(idB.substr(3)); } catch(...) {}
-            }
-            
-            return numA < numB;
-        });
-    
-    // Reassign IDs sequentially starting from STU001
+    renumberStudents(students);
+    searchIndex.rebuild(students);
+}
+
+// Sort by current ID number, then number from STU001 in that order
+void Admin::renumberStudents(std::vector<Student>& students) {
+    SortEngine::applyPermutation(students,
+        SortEngine::sortedPermutation(students, {{SortKey::StudentNumber, false}}));
     for (size_t i = 0; i < students.size(); ++i) {
-        int newIdNum = static_cast<int>(i + 1);
-        string newId = "STU" + string(3 - to_string(newIdNum).length(), '0') + to_string(newIdNum);
-        students[i].setStudentId(newId);
+        students[i].setStudentId(formatStudentId(static_cast<int>(i + 1)));
     }
 }
 
+// Reassign IDs sequentially starting from STU001, keeping the current order
+void Admin::reassignSequentialIds(std::vector<Student>& students) {
+    for (size_t i = 0; i < students.size(); ++i) {
+        students[i].setStudentId(formatStudentId(static_cast<int>(i + 1)));
+    }
+    searchIndex.rebuild(students);
+}
+
+// STU001 ... STU999, then STU1000 and up
+std::string Admin::formatStudentId(int number) {
+    string digits = to_string(number);
+    if (digits.length() < 3) {
+        digits = string(3 - digits.length(), '0') + digits;
+    }
+    return "STU" + digits;
+}
+
 std::string Admin::generateNextStudentId(const std::vector<Student>& students) {
-    int nextId = static_cast<int>(students.size()) + 1;
-    
-    string nextIdStr = "STU" + string(3 - to_string(nextId).length(), '0') + to_string(nextId);
-    return nextIdStr;
+    return formatStudentId(static_cast<int>(students.size()) + 1);
 }
 
 bool Admin::isValidGmail(const std::string& email) {
@@ -324,11 +757,12 @@ void Admin::manageStudents(std::vector<Student>& students) {
             "Search Student",
             "Show Failing Students",
             "Sort Students by Score",
+            "Query Students (filter & sort)",
             "Back to Admin Dashboard"
         };
         
         MenuUtils::printMenu(studentMenu);
-        choice = MenuUtils::getMenuChoice(8);
+        choice = MenuUtils::getMenuChoice(9);
         
         switch (choice) {
             case 1:
@@ -353,13 +787,16 @@ void Admin::manageStudents(std::vector<Student>& students) {
                 sortStudentsByScore(students);
                 break;
             case 8:
+                queryStudents(students);
+                break;
+            case 9:
                 return;
         }
         
-        if (choice != 8) {
+        if (choice != 9) {
             MenuUtils::pauseScreen();
         }
-    } while (choice != 8);
+    } while (choice != 9);
 }
 
 void Admin::viewAllStudents(const std::vector<Student>& students) {
@@ -422,19 +859,14 @@ void Admin::addNewStudent(std::vector<Student>& students) {
         }
     } while (!isValidGmail(email));
     
-    vector<double> scores(7);
-    vector<string> subjects = GradeUtil::getSubjectNames();
+    vector<double> scores;
+    uint32_t presentMask = 0;
     
-    MenuUtils::printInfo("Enter scores for all subjects :");
-    for (size_t i = 0; i < subjects.size(); ++i) {
-        scores[i] = MenuUtils::getDoubleInput(subjects[i] + " score : ");
-        if (!GradeUtil::isValidScore(scores[i])) {
-            MenuUtils::printError("Invalid score! Score must be between 0-100.");
-            i--; // Retry current subject
-        }
-    }
+    MenuUtils::printInfo("Enter scores for all subjects (leave blank if not taken) :");
+    promptSubjectScores(" score : ", scores, presentMask);
     
-    students.emplace_back(username, password, studentId, name, age, gender, dob, email, scores);
+    students.emplace_back(username, password, studentId, name, age, gender, dob, email, scores, presentMask);
+    searchIndex.add(static_cast<uint32_t>(students.size() - 1), students.back());
     MenuUtils::printSuccess("Student added successfully!");
     MenuUtils::printInfo("Student ID: " + studentId);
     MenuUtils::printInfo("Login credentials - Username : " + username + ", Password : " + password);
@@ -485,6 +917,7 @@ void Admin::editStudentInfo(std::vector<Student>& students) {
                 }
             } while (!isValidName(newName));
             student->setName(newName);
+            searchIndex.update(static_cast<uint32_t>(student - students.data()), *student);
             break;
         }
         case 2: {
@@ -532,17 +965,11 @@ void Admin::editStudentInfo(std::vector<Student>& students) {
             break;
         }
         case 6: {
-            vector<double> newScores(7);
-            vector<string> subjects = GradeUtil::getSubjectNames();
-            
-            for (size_t i = 0; i < subjects.size(); ++i) {
-                newScores[i] = MenuUtils::getDoubleInput(subjects[i] + " New score : ");
-                if (!GradeUtil::isValidScore(newScores[i])) {
-                    MenuUtils::printError("Invalid score! Score must be between 0-100.");
-                    i--; // Retry current subject
-                }
-            }
-            student->setSubjectScores(newScores);
+            vector<double> newScores;
+            uint32_t presentMask = 0;
+            MenuUtils::printInfo("Leave a subject blank if it was not taken.");
+            promptSubjectScores(" New score : ", newScores, presentMask);
+            student->setSubjectScores(newScores, presentMask);
             break;
         }
         case 7:
@@ -606,36 +1033,78 @@ void Admin::deleteStudent(std::vector<Student>& students) {
 void Admin::searchStudent(const std::vector<Student>& students) {
     MenuUtils::printHeader("SEARCH STUDENT");
     
-    string searchTerm = MenuUtils::getStringInput("Enter Student ID or Name: ");
-    bool found = false;
+    string searchTerm = MenuUtils::getStringInput("Enter Student ID or Name (partial or misspelled names work too): ");
     
-    for (const auto& student : students) {
-        if (student.getStudentId() == searchTerm || student.getName() == searchTerm) {
-            MenuUtils::displayStudentDetails(student);
-            found = true;
-            break;
-        }
+    // The roster may have been replaced since the index was built
+    if (searchIndex.size() != students.size()) {
+        searchIndex.rebuild(students);
     }
+    vector<SearchHit> hits = searchIndex.search(searchTerm, SEARCH_RESULT_LIMIT);
     
-    if (!found) {
+    if (hits.empty()) {
         MenuUtils::printError("Student not found!");
+        return;
     }
+    
+    const SearchHit& top = hits.front();
+    bool exact = (top.kind == MatchKind::ExactId || top.kind == MatchKind::ExactName);
+    if (exact || hits.size() == 1) {
+        if (!exact) {
+            MenuUtils::printInfo("Closest match (" + SearchIndex::matchKindLabel(top.kind) + "):");
+        }
+        MenuUtils::displayStudentDetails(students[top.row]);
+        return;
+    }
+    
+    MenuUtils::printInfo(to_string(hits.size()) + " possible matches, best first:");
+    vector<uint32_t> rows;
+    for (const auto& hit : hits) {
+        rows.push_back(hit.row);
+    }
+    MenuUtils::displayTable(students, rows);
+    MenuUtils::printInfo("Search again with a Student ID to see full details.");
 }
 
 void Admin::showFailingStudents(const std::vector<Student>& students) {
     MenuUtils::printHeader("FAILING STUDENTS");
     
-    vector<Student> failingStudents;
-    for (const auto& student : students) {
-        if (!student.hasPassingGrade()) {
-            failingStudents.push_back(student);
-        }
-    }
+    static const RosterQuery failing = RosterQuery::parse("avg < " + to_string(GradeUtil::PASSING_THRESHOLD));
+    vector<uint32_t> failingRows = failing.run(students);
     
-    if (failingStudents.empty()) {
+    if (failingRows.empty()) {
         MenuUtils::printSuccess("No failing students found!");
     } else {
-        MenuUtils::displayFailingStudents(failingStudents);
+        MenuUtils::displayFailingStudents(students, failingRows);
+    }
+}
+
+void Admin::queryStudents(const std::vector<Student>& students) {
+    MenuUtils::printHeader("QUERY STUDENTS");
+    
+    if (students.empty()) {
+        MenuUtils::printWarning("No students to query!");
+        return;
+    }
+    
+    MenuUtils::printInfo(RosterQuery::syntaxHelp());
+    while (true) {
+        string text = MenuUtils::getStringInput("\nQuery (blank to finish): ");
+        if (text.find_first_not_of(" \t") == string::npos) {
+            return;
+        }
+        
+        try {
+            RosterQuery query = RosterQuery::parse(text);
+            vector<uint32_t> rows = query.run(students);
+            if (rows.empty()) {
+                MenuUtils::printWarning("No students match this query.");
+            } else {
+                MenuUtils::displayTable(students, rows);
+                MenuUtils::printSuccess(to_string(rows.size()) + " of " + to_string(students.size()) + " students shown.");
+            }
+        } catch (const invalid_argument& e) {
+            MenuUtils::printError("Invalid query: " + string(e.what()));
+        }
     }
 }
 
@@ -673,31 +1142,31 @@ void Admin::sortStudentsByScore(std::vector<Student>& students) {
     MenuUtils::displayTable(students);
     cout << endl;
     
-    // Perform the sorting
-    if (order == "asc") {
-        MenuUtils::printInfo("Sorting in ASCENDING order (lowest to highest score)...");
-        sort(students.begin(), students.end(),
-            [](const Student& a, const Student& b) {
-                return a.getAverageScore() < b.getAverageScore();
-            });
-    } else {
+    // Sort a permutation of row indices (average, then name for ties); the roster
+    // itself is only reordered if the result is saved
+    bool descending = (order == "desc");
+    if (descending) {
         MenuUtils::printInfo("Sorting in DESCENDING order (highest to lowest score)...");
-        sort(students.begin(), students.end(),
-            [](const Student& a, const Student& b) {
-                return a.getAverageScore() > b.getAverageScore();
-            });
+    } else {
+        MenuUtils::printInfo("Sorting in ASCENDING order (lowest to highest score)...");
     }
+    vector<uint32_t> sortedOrder = SortEngine::sortedPermutation(students, {
+        {SortKey::AverageScore, descending},
+        {SortKey::Name, false}
+    });
     
     MenuUtils::printSuccess("Students sorted successfully!");
     MenuUtils::printInfo("Sorted order:");
-    MenuUtils::displayTable(students);
+    MenuUtils::displayTable(students, sortedOrder);
 
     // Ask if user wants to save the sorted data
     string saveChoice = MenuUtils::getStringInput("Save sorted data to Excel? (y/n): ");
     if (saveChoice == "y" || saveChoice == "Y") {
         try {
+            SortEngine::applyPermutation(students, sortedOrder);
+            
             // After sorting, reorder IDs to maintain sequence only if saving
-            reorderStudentIds(students);
+            reassignSequentialIds(students);
             MenuUtils::printInfo("Student IDs have been reordered to maintain sequence.");
             
             ExcelUtils::writeExcel("data/students.xlsx", students);
@@ -774,7 +1243,7 @@ void Admin::importExcelData(std::vector<Student>& students, const std::string& d
     try {
         // Show file information
         MenuUtils::printInfo("Importing from: " + selectedFile);
-        MenuUtils::showLoadingAnimation("Reading Excel file", 1500);
+        MenuUtils::showLoadingAnimation("Reading Excel file");
         
         // Backup current data before import
         if (!students.empty()) {
@@ -785,7 +1254,8 @@ void Admin::importExcelData(std::vector<Student>& students, const std::string& d
         }
         
         // Import the data
-        if (ExcelUtils::importStudentData(selectedFile, students)) {
+        ValidationReport validation;
+        if (ExcelUtils::importStudentData(selectedFile, students, &validation)) {
             // After import, reorder IDs to ensure proper sequence
             reorderStudentIds(students);
             
@@ -793,14 +1263,18 @@ void Admin::importExcelData(std::vector<Student>& students, const std::string& d
             MenuUtils::printInfo("Total students imported: " + to_string(students.size()));
             MenuUtils::printInfo("Student IDs have been reordered to maintain sequence.");
             
-            // Update all grades after import
-            for (auto& student : students) {
-                student.updateAllGrades();
+            // Cumulative GPA from closed terms; only the ledger is read
+            try {
+                Gradebook::open().applyTo(students);
+            } catch (const exception& e) {
+                MenuUtils::printWarning("Could not read gradebook: " + string(e.what()));
             }
-            MenuUtils::printInfo("All grades have been recalculated!");
             
-            // Save credentials after import
-            saveCredentialsToExcel(students);
+            // Save the default workbook and the credentials while the preview
+            // is on screen; nothing below modifies the roster
+            future<void> saved = async(launch::async, [&students] {
+                ImportPipeline::persist(students, "data/students.xlsx", "data/student_credentials.xlsx");
+            });
             
             // Show preview of imported data
             if (!students.empty()) {
@@ -815,14 +1289,20 @@ void Admin::importExcelData(std::vector<Student>& students, const std::string& d
                 if (students.size() > 5) {
                     MenuUtils::printInfo("... and " + to_string(students.size() - 5) + " more students");
                 }
+                
+                // Every import gets a quick scan for suspicious score patterns
+                MenuUtils::displayAnomalySummary(ScoreAnalysis::analyze(students));
             }
             
-            // Auto-save to default location
+            // Rows that broke a rule were imported as-is; rows refer to the imported file
+            showValidationReport(validation);
+            
             try {
-                ExcelUtils::writeExcel("data/students.xlsx", students);
+                saved.get();
+                MenuUtils::printInfo("Student credentials saved to data/student_credentials.xlsx");
                 MenuUtils::printInfo("Data also saved to default location: data/students.xlsx");
-            } catch (...) {
-                MenuUtils::printWarning("Could not save to default location.");
+            } catch (const exception& e) {
+                MenuUtils::printWarning("Could not save to default location: " + string(e.what()));
             }
             
         } else {
@@ -863,39 +1343,58 @@ void Admin::exportData(const std::vector<Student>& students, const std::string&
         return;
     }
     
-    try {
-        // Ensure all students have updated grades
-        vector<Student> updatedStudents = students;
-        for (auto& student : updatedStudents) {
-            student.updateAllGrades();
-        }
-        
-        ExcelUtils::exportGradeReport(filename, updatedStudents);
-        MenuUtils::printSuccess("Grade report exported successfully to " + filename + "!");
-        
-        // Also create a regular Excel file
-        string regularFilename = "data/students_export.xlsx";
-        ExcelUtils::writeExcel(regularFilename, updatedStudents);
-        MenuUtils::printInfo("Regular Excel file also created: " + regularFilename);
-        
-        // Export credentials
-        saveCredentialsToExcel(updatedStudents);
-        
-        // Show summary
-        int totalStudents = static_cast<int>(students.size());
-        int passingStudents = 0;
-        for (const auto& student : students) {
-            if (student.hasPassingGrade()) passingStudents++;
+    // Every file is written from one formatting pass over the roster
+    ExportTargets targets;
+    targets.gradeReport = filename;
+    targets.workbook = "data/students_export.xlsx";
+    string extraChoice = MenuUtils::getStringInput("Also export as CSV or JSON? (csv/json/both/n): ");
+    if (extraChoice == "csv" || extraChoice == "both") targets.csv = "data/students_export.csv";
+    if (extraChoice == "json" || extraChoice == "both") targets.json = "data/students_export.json";
+    
+    if (rosterStore) {
+        // Credentials are written here, since edits on this thread write the same file
+        saveCredentialsToExcel(students);
+        runInBackground("Export", [targets](const vector<Student>& snapshot) {
+            auto results = RosterExport::run(snapshot, targets);
+            for (const auto& result : results) {
+                if (!result.error.empty()) throw runtime_error(result.kind + " " + result.filename + ": " + result.error);
+            }
+        });
+        return;
+    }
+    
+    // Grades are recomputed whenever scores are set, so the roster can be
+    // exported as-is without a regraded copy
+    targets.credentials = "data/student_credentials.xlsx";
+    auto started = std::chrono::steady_clock::now();
+    auto results = RosterExport::run(students, targets);
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    
+    vector<string> written;
+    for (const auto& result : results) {
+        if (result.error.empty()) {
+            MenuUtils::printSuccess(result.kind + " written to " + result.filename +
+                                    " (" + to_string(static_cast<long long>(result.elapsedMs)) + " ms)");
+            written.push_back(result.filename);
+        } else {
+            MenuUtils::printError("Failed to write " + result.kind + " " + result.filename + ": " + result.error);
         }
-        
-        MenuUtils::printInfo("Export Summary:");
-        MenuUtils::printInfo("- Total students exported: " + to_string(totalStudents));
-        MenuUtils::printInfo("- Passing students (50+): " + to_string(passingStudents));
-        MenuUtils::printInfo("- Files created: " + filename + ", " + regularFilename + ", student_credentials.xlsx");
-        
-    } catch (const exception& e) {
-        MenuUtils::printError("Failed to export data: " + string(e.what()));
     }
+    if (written.empty()) return;
+    
+    // Show summary
+    int passingStudents = static_cast<int>(count_if(students.begin(), students.end(),
+        [](const Student& student) { return student.hasPassingGrade(); }));
+    string files;
+    for (const auto& name : written) {
+        files += (files.empty() ? "" : ", ") + name;
+    }
+    
+    MenuUtils::printInfo("Export Summary:");
+    MenuUtils::printInfo("- Total students exported: " + to_string(students.size()));
+    MenuUtils::printInfo("- Passing students (50+): " + to_string(passingStudents));
+    MenuUtils::printInfo("- Files created: " + files);
+    MenuUtils::printInfo("- Time: " + to_string(static_cast<long long>(elapsedMs)) + " ms");
 }
 
 void Admin::backupData(const std::vector<Student>& students) {
@@ -906,6 +1405,16 @@ void Admin::backupData(const std::vector<Student>& students) {
         return;
     }
     
+    if (rosterStore) {
+        // Not in the background: edits on this thread write the same credentials file
+        saveCredentialsToExcel(students);
+        runInBackground("Backup", [](const vector<Student>& snapshot) {
+            ExcelUtils::createBackup("students.xlsx", snapshot);
+            ExcelUtils::writeExcel("data/students_backup.xlsx", snapshot);
+        });
+        return;
+    }
+    
     try {
         // Create timestamped backup
         ExcelUtils::createBackup("students.xlsx", students);
@@ -927,6 +1436,30 @@ void Admin::backupData(const std::vector<Student>& students) {
 }
 
 // Utility methods
+void Admin::validateRoster(const std::vector<Student>& students) {
+    MenuUtils::printHeader("VALIDATE ROSTER");
+    if (students.empty()) {
+        MenuUtils::printWarning("No students to validate.");
+        return;
+    }
+    // Rows are numbered as in data/students.xlsx, which is saved in roster order
+    showValidationReport(RosterValidator::validate(students));
+}
+
+void Admin::showValidationReport(const ValidationReport& report) {
+    MenuUtils::displayValidationReport(report);
+    if (report.clean()) return;
+    
+    string saveChoice = MenuUtils::getStringInput("Save the full report to data/validation_report.xlsx? (y/n): ");
+    if (saveChoice == "y" || saveChoice == "Y") {
+        try {
+            ExcelUtils::exportValidationReport("data/validation_report.xlsx", report);
+        } catch (const exception&) {
+            // exportValidationReport has reported the error
+        }
+    }
+}
+
 bool Admin::isValidStudentId(const std::string& id, const std::vector<Student>& students) {
     return find_if(students.begin(), students.end(),
         [&id](const Student& s) { return s.getStudentId() == id; }) == students.end();
@@ -952,7 +1485,7 @@ Student* Admin::findStudentByName(std::vector<Student>& students, const std::str
 bool Admin::isValidName(const std::string& name) {
     if (name.empty()) return false;
     for (char c : name) {
-        if (!std::isalpha(c) && c != ' ') return false;
+        if (!std::isalpha(static_cast<unsigned char>(c)) && c != ' ') return false;
     }
     return true;
 }
@@ -963,21 +1496,23 @@ bool Admin::isValidGender(const std::string& gender) {
     return (lowerGender == "male" || lowerGender == "female" || lowerGender == "other");
 }
 
+// YYYY-MM-DD with digits only, and a day that exists in that month
 bool Admin::isValidDate(const std::string& date) {
     if (date.length() != 10) return false;
     if (date[4] != '-' || date[7] != '-') return false;
-    
-    try {
-        int year = std::stoi(date.substr(0, 4));
-        int month = std::stoi(date.substr(5, 2));
-        int day = std::stoi(date.substr(8, 2));
-        
-        if (year < 1900 || year > 2024) return false;
-        if (month < 1 || month > 12) return false;
-        if (day < 1 || day > 31) return false;
-        
-        return true;
-    } catch (...) {
-        return false;
+    for (size_t i = 0; i < date.length(); ++i) {
+        if (i != 4 && i != 7 && !isdigit(static_cast<unsigned char>(date[i]))) return false;
     }
+    
+    int year = std::stoi(date.substr(0, 4));
+    int month = std::stoi(date.substr(5, 2));
+    int day = std::stoi(date.substr(8, 2));
+    
+    if (year < 1900 || year > 2024) return false;
+    if (month < 1 || month > 12) return false;
+    
+    static const int DAYS_IN_MONTH[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    int daysInMonth = (month == 2 && leapYear) ? 29 : DAYS_IN_MONTH[month - 1];
+    return day >= 1 && day <= daysInMonth;
 }
\ No newline at end of file
@@ -0,0 +1,618 @@
+#include "BatchCli.hpp"
+#include "Admin.hpp"
+#include "ExcelUtil.hpp"
+#include "GradeServer.hpp"
+#include "GradeUtil.hpp"
+#include "ImportPipeline.hpp"
+#include "JsonUtil.hpp"
+#include "MenuUtils.hpp"
+#include "RegradeSimulator.hpp"
+#include "ReportCard.hpp"
+#include "RosterExport.hpp"
+#include "RosterValidator.hpp"
+#include "ScoreAnalysis.hpp"
+#include "Student.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+
+const std::string BatchCli::DEFAULT_ROSTER = "data/students.xlsx";
+
+namespace {
+    const size_t MAX_ISSUES_LISTED = 100;
+
+    struct BatchError : runtime_error {
+        BatchExitCode code;
+        BatchError(BatchExitCode code, const string& message) : runtime_error(message), code(code) {}
+    };
+
+    // Exit code of a command that ran to completion; validate sets Invalid
+    // when the roster broke a rule, and the result is printed all the same
+    BatchExitCode resultCode = BatchExitCode::Ok;
+
+    // "--key value", "--key=value" or a bare "--flag"; everything else is positional
+    struct Arguments {
+        string command;
+        vector<string> positional;
+        map<string, string> options;
+
+        string option(const string& name, const string& fallback) const {
+            auto found = options.find(name);
+            return found != options.end() ? found->second : fallback;
+        }
+    };
+
+    Arguments parseArguments(const vector<string>& arguments) {
+        Arguments parsed;
+        parsed.command = arguments.empty() ? "help" : arguments[0];
+        for (size_t i = 1; i < arguments.size(); ++i) {
+            const string& token = arguments[i];
+            if (token.compare(0, 2, "--") != 0) {
+                parsed.positional.push_back(token);
+                continue;
+            }
+            string key = token.substr(2);
+            size_t equals = key.find('=');
+            if (equals != string::npos) {
+                parsed.options[key.substr(0, equals)] = key.substr(equals + 1);
+            } else if (i + 1 < arguments.size() && arguments[i + 1].compare(0, 2, "--") != 0) {
+                parsed.options[key] = arguments[++i];
+            } else {
+                parsed.options[key] = "true";
+            }
+        }
+        return parsed;
+    }
+
+    // ---------------------------------------------------------------------
+    // Roster I/O
+    // ---------------------------------------------------------------------
+
+    // Credential-free read; the import pipeline grades every row as it streams in
+    vector<Student> readWorkbook(const string& filename) {
+        if (!ExcelUtils::fileExists(filename)) {
+            throw BatchError(BatchExitCode::InputError, "File not found: " + filename);
+        }
+        vector<Student> students;
+        try {
+            students = ExcelUtils::readStudentRows(filename);
+        } catch (const exception& e) {
+            throw BatchError(BatchExitCode::InputError, "Cannot read " + filename + ": " + e.what());
+        }
+        return students;
+    }
+
+    vector<Student> readRoster(const Arguments& args) {
+        string roster = args.option("data", BatchCli::DEFAULT_ROSTER);
+        vector<Student> students = readWorkbook(roster);
+        if (students.empty()) {
+            throw BatchError(BatchExitCode::InputError, "No students in " + roster);
+        }
+        return students;
+    }
+
+    // Beside the roster, where the interactive program and the grade server keep it
+    string credentialsFileFor(const string& roster) {
+        return (filesystem::path(roster).parent_path() / "student_credentials.xlsx").string();
+    }
+
+    // For commands that write the roster or its credentials back: logins are
+    // attached by student ID from the credentials workbook beside the roster
+    vector<Student> readWorkbookWithCredentials(const string& filename) {
+        if (!ExcelUtils::fileExists(filename)) {
+            throw BatchError(BatchExitCode::InputError, "File not found: " + filename);
+        }
+        ImportOptions options;
+        options.filename = filename;
+        options.credentialsFile = credentialsFileFor(filename);
+        ImportResult imported;
+        try {
+            imported = ImportPipeline::run(options);
+        } catch (const exception& e) {
+            throw BatchError(BatchExitCode::InputError, "Cannot read " + filename + ": " + e.what());
+        }
+        for (const auto& rejection : imported.rejected) {
+            MenuUtils::printWarning("Skipped row " + to_string(rejection.row) + " of " + filename + ": " + rejection.reason);
+        }
+        return move(imported.students);
+    }
+
+    // Logins by who the student is, since IDs change when the roster is renumbered
+    using Logins = unordered_map<string, pair<string, string>>;
+
+    Logins loginsByIdentity(const vector<Student>& students) {
+        Logins logins;
+        logins.reserve(students.size());
+        for (const auto& student : students) {
+            if (!student.getUsername().empty()) {
+                logins.emplace(student.identityKey(), make_pair(student.getUsername(), student.getPassword()));
+            }
+        }
+        return logins;
+    }
+
+    // Gives students without a login the one recorded for them; returns how many got one
+    size_t restoreLogins(vector<Student>& students, const Logins& logins) {
+        size_t restored = 0;
+        for (auto& student : students) {
+            if (!student.getUsername().empty()) continue;
+            auto login = logins.find(student.identityKey());
+            if (login == logins.end()) continue;
+            student.setUsername(login->second.first);
+            student.setPassword(login->second.second);
+            restored++;
+        }
+        return restored;
+    }
+
+    template <typename Write>
+    void writeOutput(const string& filename, Write write) {
+        try {
+            write();
+        } catch (const exception& e) {
+            throw BatchError(BatchExitCode::OutputError, "Cannot write " + filename + ": " + e.what());
+        }
+    }
+
+    double parseNumber(const string& text, const string& what) {
+        try {
+            size_t used = 0;
+            double value = stod(text, &used);
+            if (used == text.size()) return value;
+        } catch (...) {
+        }
+        throw BatchError(BatchExitCode::Usage, "Invalid " + what + ": '" + text + "'");
+    }
+
+    vector<double> parseNumberList(const string& text, char separator, const string& what) {
+        vector<double> values;
+        stringstream ss(text);
+        string item;
+        while (getline(ss, item, separator)) {
+            values.push_back(parseNumber(item, what));
+        }
+        return values;
+    }
+
+    // ---------------------------------------------------------------------
+    // Commands
+    // ---------------------------------------------------------------------
+
+    JsonObject runImport(const Arguments& args) {
+        if (args.positional.size() != 1) {
+            throw BatchError(BatchExitCode::Usage, "import expects exactly one workbook");
+        }
+        string input = args.positional[0];
+        string roster = args.option("data", BatchCli::DEFAULT_ROSTER);
+
+        if (!ExcelUtils::fileExists(input)) {
+            throw BatchError(BatchExitCode::InputError, "File not found: " + input);
+        }
+        ImportOptions options;
+        options.filename = input;
+        ImportResult imported;
+        try {
+            imported = ImportPipeline::run(options);
+        } catch (const exception& e) {
+            throw BatchError(BatchExitCode::InputError, "Cannot read " + input + ": " + e.what());
+        }
+        vector<Student>& students = imported.students;
+        if (students.empty()) {
+            throw BatchError(BatchExitCode::InputError, "No students in " + input);
+        }
+
+        // The imported workbook has no logins; students already on the
+        // roster keep theirs, matched on who they are
+        string credentials = credentialsFileFor(roster);
+        Logins logins;
+        if (ExcelUtils::fileExists(roster)) {
+            logins = loginsByIdentity(readWorkbookWithCredentials(roster));
+        }
+        size_t loginsKept = restoreLogins(students, logins);
+
+        // Renumbered as the interactive import does, then written with the credentials
+        Admin::renumberStudents(students);
+        writeOutput(roster, [&] { ImportPipeline::persist(students, roster, credentials); });
+
+        vector<string> stages;
+        for (const auto& stage : imported.stages) {
+            stages.push_back(JsonObject().add("name", stage.name).add("workers", stage.workers)
+                .add("batches", stage.batches).add("busyMs", stage.busyMs).str());
+        }
+        vector<string> rejected;
+        for (const auto& rejection : imported.rejected) {
+            rejected.push_back(JsonObject().add("row", rejection.row).add("reason", rejection.reason).str());
+        }
+
+        AnomalyReport scan = ScoreAnalysis::analyze(students, 0);
+        vector<string> spikes;
+        for (const auto& spike : scan.spikes) {
+            spikes.push_back(JsonUtil::quote(scan.subjects[spike.subjectIndex]));
+        }
+
+        JsonObject json;
+        json.add("input", input).add("roster", roster).add("students", students.size());
+        json.add("credentials", credentials).add("loginsKept", loginsKept);
+        json.add("outlyingScores", scan.flaggedScores).raw("perfectScoreSpikes", JsonUtil::array(spikes));
+        json.raw("rejectedRows", JsonUtil::array(rejected));
+        json.raw("validation", JsonUtil::validationReport(imported.validation, MAX_ISSUES_LISTED));
+        json.raw("pipeline", JsonObject().add("wallMs", imported.wallMs).raw("stages", JsonUtil::array(stages)).str());
+        return json;
+    }
+
+    JsonObject runMerge(const Arguments& args) {
+        if (args.positional.empty()) {
+            throw BatchError(BatchExitCode::Usage, "merge expects at least one workbook");
+        }
+        string roster = args.option("data", BatchCli::DEFAULT_ROSTER);
+
+        string credentials = credentialsFileFor(roster);
+        vector<Student> students;
+        if (ExcelUtils::fileExists(roster)) {
+            students = readWorkbookWithCredentials(roster);
+        }
+        Logins logins = loginsByIdentity(students);
+        // Student IDs are positions, renumbered on every import, so rows are
+        // matched on who the student is instead
+        unordered_map<string, size_t> rowOf;
+        rowOf.reserve(students.size());
+        for (size_t i = 0; i < students.size(); ++i) {
+            rowOf.emplace(students[i].identityKey(), i);
+        }
+
+        // Later workbooks win: a known student is replaced in place (keeping
+        // their login), anyone else appended; then the roster is renumbered
+        // as the interactive import does
+        size_t added = 0, updated = 0;
+        vector<string> inputs;
+        for (const auto& input : args.positional) {
+            for (auto& student : readWorkbook(input)) {
+                auto inserted = rowOf.emplace(student.identityKey(), students.size());
+                if (inserted.second) {
+                    students.push_back(move(student));
+                    added++;
+                } else {
+                    Student& known = students[inserted.first->second];
+                    student.setStudentId(known.getStudentId());   // keeps its place when renumbered
+                    known = move(student);
+                    updated++;
+                }
+            }
+            inputs.push_back(JsonUtil::quote(input));
+        }
+        restoreLogins(students, logins);
+        Admin::renumberStudents(students);
+        writeOutput(roster, [&] { ImportPipeline::persist(students, roster, credentials); });
+
+        JsonObject json;
+        json.raw("inputs", JsonUtil::array(inputs)).add("roster", roster).add("credentials", credentials);
+        json.add("added", added).add("updated", updated).add("students", students.size());
+        return json;
+    }
+
+    Curve parseCurve(const string& text) {
+        Curve curve;
+        vector<string> parts;
+        stringstream ss(text);
+        string part;
+        while (getline(ss, part, ':')) parts.push_back(part);
+
+        string kind = parts.empty() ? "none" : parts[0];
+        if (kind == "none" && parts.size() <= 1) {
+            curve.type = CurveType::None;
+        } else if (kind == "shift" && parts.size() == 2) {
+            curve.type = CurveType::LinearShift;
+            curve.shift = parseNumber(parts[1], "shift");
+        } else if ((kind == "zscore" || kind == "bell") && parts.size() == 3) {
+            curve.type = kind == "zscore" ? CurveType::ZScore : CurveType::BellCurve;
+            curve.targetMean = parseNumber(parts[1], "target mean");
+            curve.targetStdDev = parseNumber(parts[2], "target standard deviation");
+        } else {
+            throw BatchError(BatchExitCode::Usage, "Invalid curve '" + text + "' (none, shift:P, zscore:MEAN:SD or bell:MEAN:SD)");
+        }
+        return curve;
+    }
+
+    JsonObject runRegrade(const Arguments& args) {
+        vector<Student> students = readRoster(args);
+
+        GradeScale scale = GradeScale::current();
+        if (args.options.count("scale")) {
+            vector<double> thresholds = parseNumberList(args.option("scale", ""), ',', "grade boundary");
+            if (thresholds.size() != scale.thresholds.size()) {
+                throw BatchError(BatchExitCode::Usage, "--scale expects five boundaries, e.g. 85,75,65,55,45");
+            }
+            copy(thresholds.begin(), thresholds.end(), scale.thresholds.begin());
+            if (!scale.isValid()) {
+                throw BatchError(BatchExitCode::Usage, "Grade boundaries must be descending and within 0-100");
+            }
+        }
+        Curve curve = parseCurve(args.option("curve", "none"));
+
+        RegradeSimulator simulator(students);
+        RegradeOutcome outcome = simulator.simulate(scale, curve);
+
+        vector<string> boundaries;
+        for (double threshold : scale.thresholds) boundaries.push_back(JsonUtil::number(threshold));
+
+        JsonObject json;
+        json.add("students", students.size()).add("curve", curve.describe()).raw("scale", JsonUtil::array(boundaries));
+        json.add("currentMean", outcome.currentMean).add("simulatedMean", outcome.simulatedMean);
+        json.add("currentPassRate", outcome.currentPassRate).add("simulatedPassRate", outcome.simulatedPassRate);
+        json.add("promoted", outcome.promoted).add("demoted", outcome.demoted);
+        json.raw("currentGrades", JsonUtil::gradeCounts(outcome.currentCounts));
+        json.raw("simulatedGrades", JsonUtil::gradeCounts(outcome.simulatedCounts));
+
+        if (args.options.count("sweep")) {
+            vector<double> range = parseNumberList(args.option("sweep", ""), ':', "sweep range");
+            if (range.size() != 3 || range[2] <= 0.0 || range[0] > range[1]) {
+                throw BatchError(BatchExitCode::Usage, "--sweep expects FROM:TO:STEP, e.g. 40:60:5");
+            }
+            vector<string> points;
+            for (const auto& point : simulator.sweepPassMarks(curve, range[0], range[1], range[2])) {
+                points.push_back(JsonObject().add("passMark", point.passMark).add("passing", point.passing)
+                                             .add("passRate", point.passRate).str());
+            }
+            json.raw("sweep", JsonUtil::array(points));
+        }
+        return json;
+    }
+
+    JsonObject runReport(const Arguments& args) {
+        vector<Student> students = readRoster(args);
+        string output = args.option("out", "data/grade_report.xlsx");
+        writeOutput(output, [&] { ExcelUtils::exportGradeReport(output, students); });
+
+        JsonObject json;
+        json.add("output", output).add("students", students.size());
+        return json;
+    }
+
+    JsonObject runExport(const Arguments& args) {
+        string format = args.option("format", "");
+        if (format != "csv" && format != "xlsx" && format != "json") {
+            throw BatchError(BatchExitCode::Usage, "export expects --format csv, xlsx or json");
+        }
+        vector<Student> students = readRoster(args);
+        string output = args.option("out", "data/students_export." + format);
+        writeOutput(output, [&] {
+            if (format == "csv") {
+                ExcelUtils::writeCsv(output, students);
+            } else if (format == "json") {
+                RosterExport::writeJson(output, RosterExport::formatRows(students));
+            } else {
+                ExcelUtils::writeExcel(output, students);
+            }
+        });
+
+        JsonObject json;
+        json.add("format", format).add("output", output).add("students", students.size());
+        return json;
+    }
+
+    JsonObject runCards(const Arguments& args) {
+        ReportCardOptions options;
+        string format = args.option("format", ReportCards::formatName(options.format));
+        if (!ReportCards::parseFormat(format, options.format)) {
+            throw BatchError(BatchExitCode::Usage, "cards expects --format html, text or xlsx");
+        }
+        options.directory = args.option("out", options.directory);
+        vector<Student> students = readRoster(args);
+
+        ReportCardResult result;
+        writeOutput(options.directory, [&] { result = ReportCards::generate(students, options); });
+        for (const auto& failure : result.failures) {
+            MenuUtils::printWarning("Could not write " + failure);
+        }
+        if (result.written == 0) {
+            throw BatchError(BatchExitCode::OutputError, "No report cards written to " + options.directory);
+        }
+
+        JsonObject json;
+        json.add("format", ReportCards::formatName(options.format)).add("directory", result.directory);
+        json.add("written", result.written).add("failed", result.failed).add("cardsMs", result.elapsedMs);
+        return json;
+    }
+
+    JsonObject runBackup(const Arguments& args) {
+        // With logins attached, or the credentials backup would be blank
+        string rosterFile = args.option("data", BatchCli::DEFAULT_ROSTER);
+        vector<Student> students = readWorkbookWithCredentials(rosterFile);
+        if (students.empty()) {
+            throw BatchError(BatchExitCode::InputError, "No students in " + rosterFile);
+        }
+        // Backups are named after the roster they were taken from
+        string roster = filesystem::path(rosterFile).filename().string();
+        writeOutput("data/backups", [&] { ExcelUtils::createBackup(roster, students); });
+
+        JsonObject json;
+        json.add("directory", "data/backups").add("students", students.size());
+        size_t logins = count_if(students.begin(), students.end(),
+                                 [](const Student& student) { return !student.getUsername().empty(); });
+        json.add("credentials", credentialsFileFor(rosterFile)).add("logins", logins);
+        return json;
+    }
+
+    JsonObject runStats(const Arguments& args) {
+        vector<Student> students = readRoster(args);
+        JsonObject json;
+        json.raw("statistics", JsonUtil::rosterStatistics(students));
+        return json;
+    }
+
+    atomic<bool> stopRequested{false};
+
+    JsonObject runValidate(const Arguments& args) {
+        if (args.positional.size() > 1) {
+            throw BatchError(BatchExitCode::Usage, "validate expects at most one workbook");
+        }
+        string input = args.positional.empty() ? args.option("data", BatchCli::DEFAULT_ROSTER) : args.positional[0];
+        if (!ExcelUtils::fileExists(input)) {
+            throw BatchError(BatchExitCode::InputError, "File not found: " + input);
+        }
+        // Through the import pipeline, so score cells are checked as written
+        // and rows are numbered as in the workbook
+        ImportOptions options;
+        options.filename = input;
+        ImportResult imported;
+        try {
+            imported = ImportPipeline::run(options);
+        } catch (const exception& e) {
+            throw BatchError(BatchExitCode::InputError, "Cannot read " + input + ": " + e.what());
+        }
+
+        string out = args.option("out", "");
+        if (!out.empty()) {
+            writeOutput(out, [&] { ExcelUtils::exportValidationReport(out, imported.validation); });
+        }
+        if (!imported.validation.clean() || !imported.rejected.empty()) {
+            resultCode = BatchExitCode::Invalid;
+        }
+
+        JsonObject json;
+        json.add("input", input).add("rejectedRows", imported.rejected.size());
+        if (!out.empty()) json.add("report", out);
+        json.raw("validation", JsonUtil::validationReport(imported.validation, MAX_ISSUES_LISTED));
+        return json;
+    }
+
+    void requestStop(int) {
+        stopRequested = true;
+    }
+
+    JsonObject runServe(const Arguments& args) {
+        ServerOptions options;
+        options.rosterFile = args.option("data", BatchCli::DEFAULT_ROSTER);
+        options.host = args.option("host", options.host);
+        options.socketPath = args.option("socket", "");
+        double port = parseNumber(args.option("port", to_string(options.port)), "port");
+        if (port < 1 || port > 65535 || port != floor(port)) {
+            throw BatchError(BatchExitCode::Usage, "--port expects a number from 1 to 65535");
+        }
+        options.port = static_cast<int>(port);
+        if (args.options.count("workers")) {
+            double workers = parseNumber(args.option("workers", ""), "worker count");
+            if (workers < 1 || workers != floor(workers)) {
+                throw BatchError(BatchExitCode::Usage, "--workers expects a positive whole number");
+            }
+            options.connectionThreads = static_cast<size_t>(workers);
+        }
+
+        GradeServer server(options);
+        try {
+            server.loadRoster();
+        } catch (const exception& e) {
+            throw BatchError(BatchExitCode::InputError, e.what());
+        }
+
+        signal(SIGINT, requestStop);
+        signal(SIGTERM, requestStop);
+#ifdef SIGPIPE
+        signal(SIGPIPE, SIG_IGN);
+#endif
+        auto started = chrono::steady_clock::now();
+        MenuUtils::printInfo("Serving " + to_string(server.snapshot()->students.size()) + " students at "
+                             + server.endpoint() + " (Ctrl+C to stop)");
+        server.run(stopRequested);
+
+        JsonObject json;
+        json.add("endpoint", server.endpoint()).add("requests", static_cast<size_t>(server.requestCount()));
+        json.add("uptimeSeconds", chrono::duration<double>(chrono::steady_clock::now() - started).count());
+        return json;
+    }
+
+    const map<string, JsonObject (*)(const Arguments&)>& commands() {
+        static const map<string, JsonObject (*)(const Arguments&)> table = {
+            {"import", runImport}, {"merge", runMerge}, {"regrade", runRegrade}, {"report", runReport},
+            {"export", runExport}, {"cards", runCards}, {"backup", runBackup}, {"stats", runStats},
+            {"validate", runValidate}, {"serve", runServe}
+        };
+        return table;
+    }
+}
+
+bool BatchCli::isBatchCommand(const std::string& argument) {
+    return commands().count(argument) > 0 || argument == "help" || argument == "--help";
+}
+
+int BatchCli::run(const std::vector<std::string>& arguments) {
+    MenuUtils::setHeadless(true);
+    auto start = chrono::steady_clock::now();
+    Arguments args = parseArguments(arguments);
+
+    if (args.command == "help" || args.command == "--help") {
+        cout << usage();
+        return static_cast<int>(BatchExitCode::Ok);
+    }
+
+    BatchExitCode code = BatchExitCode::Ok;
+    JsonObject result;
+    result.add("command", args.command);
+    try {
+        if (args.options.count("threads")) {
+            double threads = parseNumber(args.option("threads", ""), "thread count");
+            if (threads < 1 || threads != floor(threads)) {
+                throw BatchError(BatchExitCode::Usage, "--threads expects a positive whole number");
+            }
+            TaskScheduler::setThreadCount(static_cast<size_t>(threads));
+        }
+        auto handler = commands().find(args.command);
+        if (handler == commands().end()) {
+            throw BatchError(BatchExitCode::Usage, "Unknown command: " + args.command);
+        }
+        resultCode = BatchExitCode::Ok;
+        JsonObject fields = handler->second(args);
+        string body = fields.str();
+        code = resultCode;
+        result.add("status", code == BatchExitCode::Ok ? "ok" : "invalid").raw("result", body);
+    } catch (const BatchError& e) {
+        code = e.code;
+        result.add("status", "error").add("message", e.what());
+    } catch (const exception& e) {
+        code = BatchExitCode::Failed;
+        result.add("status", "error").add("message", e.what());
+    }
+
+    double elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    result.add("exitCode", static_cast<int>(code)).add("elapsedMs", elapsed);
+    cout << result.str() << endl;
+    if (code == BatchExitCode::Usage) {
+        cerr << usage();
+    }
+    return static_cast<int>(code);
+}
+
+std::string BatchCli::usage() {
+    return "Usage: ScoreME_Generator <command> [arguments] [--data <roster.xlsx>] [--threads N]\n"
+           "\n"
+           "Commands (roster defaults to " + DEFAULT_ROSTER + "):\n"
+           "  import <workbook>                 Replace the roster with a workbook's rows\n"
+           "  merge <workbook>...               Add or update rows by email, or name and birth date (later files win)\n"
+           "  regrade [--scale A,B,C,D,E] [--curve none|shift:P|zscore:MEAN:SD|bell:MEAN:SD]\n"
+           "          [--sweep FROM:TO:STEP]    What-if regrading; the roster is not modified\n"
+           "  report [--out <file.xlsx>]        Export the grade report workbook\n"
+           "  export --format csv|xlsx|json [--out <file>]\n"
+           "  cards [--format html|text|xlsx] [--out <directory>]\n"
+           "                                    One report card per student (default data/report_cards)\n"
+           "  backup                            Timestamped backup into data/backups\n"
+           "  stats                             Roster and per-subject statistics\n"
+           "  validate [<workbook>] [--out <file.xlsx>]\n"
+           "                                    Check every row against the entry rules\n"
+           "  serve [--host 127.0.0.1] [--port 8080] [--socket <path>] [--workers N]\n"
+           "                                    HTTP JSON service for logins, grades and queries\n"
+           "\n"
+           "Each command prints one JSON object on stdout; messages go to stderr.\n"
+           "Exit codes: 0 ok, 1 failed, 2 usage, 3 input missing/unreadable, 4 output not written,\n"
+           "            5 validate found issues\n";
+}
@@ -1,44 +1,53 @@
 #include "ExcelUtil.hpp"
 #include "MenuUtils.hpp"
 #include "GradeUtil.hpp"
+#include "GradeStats.hpp"
+#include "GroupBy.hpp"
+#include "Gradebook.hpp"
+#include "QuantileSketch.hpp"
+#include "TrendStore.hpp"
 #include "Student.hpp"
+#include "TaskScheduler.hpp"
+#include "ImportPipeline.hpp"
+#include "RosterExport.hpp"
+#include "RosterValidator.hpp"
 #include <xlnt/xlnt.hpp>
+#include <xlnt/workbook/streaming_workbook_reader.hpp>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <ctime>
+#include <cstdio>
 #include <filesystem>
 
 using namespace std;
 
-// Main Excel operations (WITHOUT credentials)
-void ExcelUtils::writeExcel(const std::string& filename, const std::vector<Student>& students) {
-    try {
-        // Create directory if it doesn't exist
-        std::filesystem::path filePath(filename);
-        std::filesystem::create_directories(filePath.parent_path());
+namespace {
+    const string DEFAULT_SHEET_TITLE = "Student Grades";
+    const size_t CSV_ROWS_PER_TASK = 4096;
 
-        xlnt::workbook wb;
-        xlnt::worksheet ws = wb.active_sheet();
-        ws.title("Student Grades");
-
-        // Write headers WITHOUT username and password
-        auto headers = getExcelHeaders();
-        for (size_t i = 0; i < headers.size(); ++i) {
-            ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(i + 1), 1)).value(headers[i]);
+    // RFC 4180: quote fields holding separators, quotes or line breaks
+    void appendCsvField(string& out, const string& field) {
+        if (field.find_first_of(",\"\r\n") == string::npos) {
+            out += field;
+            return;
         }
-
-        // Format header row
-        formatExcelHeader(ws);
-
-        // Write student data WITHOUT credentials
-        for (size_t i = 0; i < students.size(); ++i) {
-            writeStudentToExcel(ws, students[i], static_cast<int>(i + 2));
+        out += '"';
+        for (char c : field) {
+            if (c == '"') out += '"';
+            out += c;
         }
+        out += '"';
+    }
 
-        // Save Excel file
-        wb.save(filename);
+}
+
+// Main Excel operations (WITHOUT credentials)
+void ExcelUtils::writeExcel(const std::string& filename, const std::vector<Student>& students) {
+    try {
+        writeExcelRows(filename, RosterExport::formatRows(students));
         MenuUtils::printSuccess("Excel file '" + filename + "' created successfully!");
         
     } catch (const exception& e) {
@@ -47,44 +56,36 @@ void ExcelUtils::writeExcel(const std::string& filename, const std::vector<Stude
     }
 }
 
-// Separate credentials Excel file (ONLY username, password, basic info)
-void ExcelUtils::writeCredentialsExcel(const std::string& filename, const std::vector<Student>& students) {
-    try {
-        // Create directory if it doesn't exist
-        std::filesystem::path filePath(filename);
-        std::filesystem::create_directories(filePath.parent_path());
+void ExcelUtils::writeExcelRows(const std::string& filename, const std::vector<ExportRow>& rows) {
+    // Create directory if it doesn't exist
+    std::filesystem::path filePath(filename);
+    std::filesystem::create_directories(filePath.parent_path());
 
-        xlnt::workbook wb;
-        xlnt::worksheet ws = wb.active_sheet();
-        ws.title("Student Credentials");
+    xlnt::workbook wb;
+    xlnt::worksheet ws = wb.active_sheet();
+    ws.title(DEFAULT_SHEET_TITLE);
 
-        // Write headers for credentials ONLY
-        auto credHeaders = getCredentialHeaders();
-        for (size_t i = 0; i < credHeaders.size(); ++i) {
-            ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(i + 1), 1)).value(credHeaders[i]);
-        }
+    // Write headers WITHOUT username and password
+    auto headers = getExcelHeaders();
+    for (size_t i = 0; i < headers.size(); ++i) {
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(i + 1), 1)).value(headers[i]);
+    }
 
-        // Format header row
-        for (int col = 1; col <= static_cast<int>(credHeaders.size()); ++col) {
-            auto cell = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col), 1));
-            cell.font(xlnt::font().bold(true));
-        }
+    // Format header row
+    formatExcelHeader(ws);
 
-        // Write credential data ONLY
-        for (size_t i = 0; i < students.size(); ++i) {
-            int row = static_cast<int>(i + 2);
-            int col = 1;
-            
-            ws.cell(xlnt::cell_reference(col++, row)).value(students[i].getStudentId());
-            ws.cell(xlnt::cell_reference(col++, row)).value(students[i].getName());
-            ws.cell(xlnt::cell_reference(col++, row)).value(students[i].getUsername());
-            ws.cell(xlnt::cell_reference(col++, row)).value(students[i].getPassword());
-            ws.cell(xlnt::cell_reference(col++, row)).value(students[i].getEmail());
-            ws.cell(xlnt::cell_reference(col++, row)).value(students[i].getFormattedTimestamp());
-        }
+    // Write student data WITHOUT credentials
+    for (size_t i = 0; i < rows.size(); ++i) {
+        writeRowToExcel(ws, rows[i], static_cast<int>(i + 2));
+    }
 
-        // Save Excel file
-        wb.save(filename);
+    wb.save(filename);
+}
+
+// Separate credentials Excel file (ONLY username, password, basic info)
+void ExcelUtils::writeCredentialsExcel(const std::string& filename, const std::vector<Student>& students) {
+    try {
+        writeCredentialRows(filename, RosterExport::formatRows(students));
         MenuUtils::printSuccess("Credentials file '" + filename + "' created successfully!");
         
     } catch (const exception& e) {
@@ -93,6 +94,43 @@ void ExcelUtils::writeCredentialsExcel(const std::string& filename, const std::v
     }
 }
 
+void ExcelUtils::writeCredentialRows(const std::string& filename, const std::vector<ExportRow>& rows) {
+    // Create directory if it doesn't exist
+    std::filesystem::path filePath(filename);
+    std::filesystem::create_directories(filePath.parent_path());
+
+    xlnt::workbook wb;
+    xlnt::worksheet ws = wb.active_sheet();
+    ws.title("Student Credentials");
+
+    // Write headers for credentials ONLY
+    auto credHeaders = getCredentialHeaders();
+    for (size_t i = 0; i < credHeaders.size(); ++i) {
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(i + 1), 1)).value(credHeaders[i]);
+    }
+
+    // Format header row
+    for (int col = 1; col <= static_cast<int>(credHeaders.size()); ++col) {
+        auto cell = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col), 1));
+        cell.font(xlnt::font().bold(true));
+    }
+
+    // Write credential data ONLY
+    for (size_t i = 0; i < rows.size(); ++i) {
+        int row = static_cast<int>(i + 2);
+        int col = 1;
+        
+        ws.cell(xlnt::cell_reference(col++, row)).value(rows[i].studentId);
+        ws.cell(xlnt::cell_reference(col++, row)).value(rows[i].name);
+        ws.cell(xlnt::cell_reference(col++, row)).value(rows[i].username);
+        ws.cell(xlnt::cell_reference(col++, row)).value(rows[i].password);
+        ws.cell(xlnt::cell_reference(col++, row)).value(rows[i].email);
+        ws.cell(xlnt::cell_reference(col++, row)).value(rows[i].lastUpdated);
+    }
+
+    wb.save(filename);
+}
+
 std::vector<Student> ExcelUtils::readExcelToVector(const std::string& filename) {
     std::vector<Student> students;
     
@@ -109,12 +147,13 @@ std::vector<Student> ExcelUtils::readExcelToVector(const std::string& filename)
             return sampleStudents;
         }
 
-        xlnt::workbook wb;
-        wb.load(filename);
-        xlnt::worksheet ws = wb.active_sheet();
+        ImportOptions options;
+        options.filename = filename;
+        options.credentialsFile = "data/student_credentials.xlsx";
+        ImportResult result = ImportPipeline::run(options);
 
         // Check if worksheet has data
-        if (ws.highest_row() <= 1) {
+        if (result.students.empty() && result.rejected.empty()) {
             MenuUtils::printInfo("Excel file is empty, creating sample data...");
             auto sampleStudents = Student::createSampleData();
             writeExcel(filename, sampleStudents);
@@ -123,28 +162,10 @@ std::vector<Student> ExcelUtils::readExcelToVector(const std::string& filename)
             return sampleStudents;
         }
 
-        // Try to load credentials from separate file
-        std::map<std::string, std::pair<std::string, std::string>> credentialsMap;
-        loadCredentialsFromFile("data/student_credentials.xlsx", credentialsMap);
-
-        // Skip header row and read data
-        for (int rowNum = 2; rowNum <= static_cast<int>(ws.highest_row()); ++rowNum) {
-            try {
-                Student student = readStudentFromExcel(ws, rowNum);
-                
-                // Set credentials from credentials file if available
-                auto credIt = credentialsMap.find(student.getStudentId());
-                if (credIt != credentialsMap.end()) {
-                    student.setUsername(credIt->second.first);
-                    student.setPassword(credIt->second.second);
-                }
-                
-                students.push_back(student);
-            } catch (const exception& e) {
-                MenuUtils::printWarning("Error reading row " + to_string(rowNum) + ": " + e.what());
-                continue;
-            }
+        for (const auto& rejection : result.rejected) {
+            MenuUtils::printWarning("Error reading row " + to_string(rejection.row) + ": " + rejection.reason);
         }
+        students = std::move(result.students);
         
     } catch (const exception& e) {
         MenuUtils::printError("Error reading Excel file: " + string(e.what()));
@@ -157,6 +178,18 @@ std::vector<Student> ExcelUtils::readExcelToVector(const std::string& filename)
     return students;
 }
 
+// Plain read of the student rows for archive tooling: throws instead of
+// creating sample data, and leaves credentials empty
+std::vector<Student> ExcelUtils::readStudentRows(const std::string& filename) {
+    ImportOptions options;
+    options.filename = filename;
+    ImportResult result = ImportPipeline::run(options);
+    for (const auto& rejection : result.rejected) {
+        MenuUtils::printWarning("Error reading row " + to_string(rejection.row) + ": " + rejection.reason);
+    }
+    return std::move(result.students);
+}
+
 void ExcelUtils::readExcel(const std::string& filename) {
     auto students = readExcelToVector(filename);
     
@@ -179,13 +212,17 @@ void ExcelUtils::writeExcelWithTimestamp(const std::string& baseFilename, const
 }
 
 void ExcelUtils::createBackup(const std::string& sourceFilename, const std::vector<Student>& students) {
+    string backupFilename;
     try {
         // Create backup directory if it doesn't exist
         std::filesystem::create_directories("data/backups");
         
-        string backupFilename = "data/backups/backup_" + generateTimestampFilename(sourceFilename);
+        backupFilename = "data/backups/backup_" + generateTimestampFilename(sourceFilename);
         writeExcel(backupFilename, students);
         
+        // Quantile sketch beside the backup for archive-wide percentile queries
+        ScoreSketches::fromStudents(students).save(ScoreSketches::sketchFilenameFor(backupFilename));
+        
         // Also backup credentials
         string credBackupFilename = "data/backups/backup_" + generateTimestampFilename("student_credentials.xlsx");
         writeCredentialsExcel(credBackupFilename, students);
@@ -197,64 +234,264 @@ void ExcelUtils::createBackup(const std::string& sourceFilename, const std::vect
         MenuUtils::printError("Failed to create backup: " + string(e.what()));
         throw;
     }
+    
+    // Per-student time series for history views, last: a damaged trend
+    // store must not cost the backup itself
+    try {
+        TrendStore trends = TrendStore::openArchive("data/backups", backupFilename);
+        trends.append(students, static_cast<int64_t>(time(nullptr)));
+    } catch (const exception& e) {
+        MenuUtils::printWarning("Score history not updated: " + string(e.what()));
+    }
 }
 
 void ExcelUtils::exportGradeReport(const std::string& filename, const std::vector<Student>& students) {
     try {
-        // Create directory if it doesn't exist
+        writeGradeReportRows(filename, RosterExport::formatRows(students), students);
+        MenuUtils::printSuccess("Grade report exported to: " + filename);
+        
+    } catch (const exception& e) {
+        MenuUtils::printError("Error creating grade report: " + string(e.what()));
+        throw;
+    }
+}
+
+void ExcelUtils::writeGradeReportRows(const std::string& filename, const std::vector<ExportRow>& rows,
+                                      const std::vector<Student>& students) {
+    // Create directory if it doesn't exist
+    std::filesystem::path filePath(filename);
+    std::filesystem::create_directories(filePath.parent_path());
+
+    xlnt::workbook wb;
+    xlnt::worksheet ws = wb.active_sheet();
+    ws.title("Grade Report");
+
+    // Add report title
+    ws.cell("A1").value("GRADE REPORT - " + getCurrentTimestamp());
+    ws.merge_cells("A1:I1");
+    
+    // Add summary statistics
+    int totalStudents = static_cast<int>(rows.size());
+    int passingStudents = 0;
+    double totalAverage = 0.0;
+    
+    for (const auto& row : rows) {
+        if (row.passing) {
+            passingStudents++;
+        }
+        totalAverage += row.average;
+    }
+    
+    double classAverage = totalStudents > 0 ? totalAverage / totalStudents : 0.0;
+    double passRate = totalStudents > 0 ? (static_cast<double>(passingStudents) / totalStudents) * 100.0 : 0.0;
+    
+    ws.cell("A3").value("Total Students: " + to_string(totalStudents));
+    ws.cell("A4").value("Passing Students (50+): " + to_string(passingStudents));
+    ws.cell("A5").value("Pass Rate: " + to_string(static_cast<int>(passRate * 100) / 100.0) + "%");
+    ws.cell("A6").value("Class Average: " + to_string(static_cast<int>(classAverage * 100) / 100.0));
+
+    // Write headers starting from row 8 (WITHOUT credentials)
+    auto headers = getExcelHeaders();
+    for (size_t i = 0; i < headers.size(); ++i) {
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(i + 1), 8)).value(headers[i]);
+    }
+
+    // Write student data WITHOUT credentials
+    for (size_t i = 0; i < rows.size(); ++i) {
+        writeRowToExcel(ws, rows[i], static_cast<int>(i + 9));
+    }
+
+    // Per-subject distribution on its own sheet
+    xlnt::worksheet statsSheet = wb.create_sheet();
+    writeSubjectStatisticsSheet(statsSheet, GradeStats::computeSubjectStatistics(students));
+
+    // Cohort breakdowns, one block per grouping
+    xlnt::worksheet cohortSheet = wb.create_sheet();
+    writeCohortSheet(cohortSheet, students);
+
+    wb.save(filename);
+}
+
+void ExcelUtils::exportTranscripts(const std::string& filename, const std::vector<Transcript>& transcripts) {
+    try {
         std::filesystem::path filePath(filename);
         std::filesystem::create_directories(filePath.parent_path());
 
         xlnt::workbook wb;
         xlnt::worksheet ws = wb.active_sheet();
-        ws.title("Grade Report");
+        ws.title("Transcripts");
 
-        // Add report title
-        ws.cell("A1").value("GRADE REPORT - " + getCurrentTimestamp());
-        ws.merge_cells("A1:I1");
-        
-        // Add summary statistics
-        int totalStudents = static_cast<int>(students.size());
-        int passingStudents = 0;
-        double totalAverage = 0.0;
-        
-        for (const auto& student : students) {
-            if (student.hasPassingGrade()) {
-                passingStudents++;
+        auto subjects = GradeUtil::getSubjectNames();
+        vector<string> headers = {"Student ID", "Name", "Term", "Average", "Grade", "GPA", "Credits"};
+        headers.insert(headers.end(), subjects.begin(), subjects.end());
+        for (size_t i = 0; i < headers.size(); ++i) {
+            auto cell = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(i + 1), 1));
+            cell.value(headers[i]);
+            cell.font(xlnt::font().bold(true));
+        }
+
+        // One row per student and term, then the student's cumulative line
+        int row = 2;
+        for (const auto& transcript : transcripts) {
+            for (const auto& entry : transcript.entries) {
+                int col = 1;
+                ws.cell(xlnt::cell_reference(col++, row)).value(transcript.studentId);
+                ws.cell(xlnt::cell_reference(col++, row)).value(transcript.name);
+                ws.cell(xlnt::cell_reference(col++, row)).value(entry.term);
+                ws.cell(xlnt::cell_reference(col++, row)).value(entry.average);
+                ws.cell(xlnt::cell_reference(col++, row)).value(entry.letterGrade);
+                ws.cell(xlnt::cell_reference(col++, row)).value(entry.gpa);
+                ws.cell(xlnt::cell_reference(col++, row)).value(entry.credits);
+                for (size_t s = 0; s < entry.subjectScores.size(); ++s, ++col) {
+                    if ((entry.scoreMask >> s) & 1u) {
+                        ws.cell(xlnt::cell_reference(col, row)).value(entry.subjectScores[s]);
+                    }
+                }
+                row++;
             }
-            totalAverage += student.getAverageScore();
+            auto label = ws.cell(xlnt::cell_reference(3, row));
+            label.value("Cumulative");
+            label.font(xlnt::font().bold(true));
+            ws.cell(xlnt::cell_reference(6, row)).value(transcript.cumulative.gpa());
+            ws.cell(xlnt::cell_reference(7, row)).value(transcript.cumulative.credits);
+            row += 2;   // blank line between students
         }
-        
-        double classAverage = totalStudents > 0 ? totalAverage / totalStudents : 0.0;
-        double passRate = totalStudents > 0 ? (static_cast<double>(passingStudents) / totalStudents) * 100.0 : 0.0;
-        
-        ws.cell("A3").value("Total Students: " + to_string(totalStudents));
-        ws.cell("A4").value("Passing Students (50+): " + to_string(passingStudents));
-        ws.cell("A5").value("Pass Rate: " + to_string(static_cast<int>(passRate * 100) / 100.0) + "%");
-        ws.cell("A6").value("Class Average: " + to_string(static_cast<int>(classAverage * 100) / 100.0));
 
-        // Write headers starting from row 8 (WITHOUT credentials)
-        auto headers = getExcelHeaders();
+        wb.save(filename);
+        MenuUtils::printSuccess("Transcripts exported to: " + filename);
+
+    } catch (const exception& e) {
+        MenuUtils::printError("Error creating transcripts: " + string(e.what()));
+        throw;
+    }
+}
+
+// The whole file is formatted into one buffer and written with a single call.
+// Chunks of rows are formatted in parallel and joined in order.
+void ExcelUtils::exportValidationReport(const std::string& filename, const ValidationReport& report) {
+    try {
+        std::filesystem::path filePath(filename);
+        if (filePath.has_parent_path()) std::filesystem::create_directories(filePath.parent_path());
+
+        xlnt::workbook wb;
+        xlnt::worksheet ws = wb.active_sheet();
+        ws.title("Validation Issues");
+
+        vector<string> headers = {"Row", "Column", "Rule", "Expected"};
         for (size_t i = 0; i < headers.size(); ++i) {
-            ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(i + 1), 8)).value(headers[i]);
+            auto cell = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(i + 1), 1));
+            cell.value(headers[i]);
+            cell.font(xlnt::font().bold(true));
         }
 
-        // Write student data WITHOUT credentials
-        for (size_t i = 0; i < students.size(); ++i) {
-            writeStudentToExcel(ws, students[i], static_cast<int>(i + 9));
+        // Rule text is the same for every issue of a rule; build it once
+        vector<string> ruleNames, ruleDescriptions;
+        for (size_t r = 0; r < ValidationReport::RULE_COUNT; ++r) {
+            ruleNames.push_back(RosterValidator::ruleName(static_cast<ValidationRule>(r)));
+            ruleDescriptions.push_back(RosterValidator::ruleDescription(static_cast<ValidationRule>(r)));
         }
+        int row = 2;
+        for (const auto& issue : report.issues) {
+            size_t rule = static_cast<size_t>(issue.rule);
+            ws.cell(xlnt::cell_reference(1, row)).value(static_cast<int>(issue.row));
+            ws.cell(xlnt::cell_reference(2, row)).value(RosterValidator::columnName(issue));
+            ws.cell(xlnt::cell_reference(3, row)).value(ruleNames[rule]);
+            ws.cell(xlnt::cell_reference(4, row)).value(ruleDescriptions[rule]);
+            row++;
+        }
+
+        xlnt::worksheet summary = wb.create_sheet();
+        summary.title("Summary");
+        summary.cell("A1").value("Rule");
+        summary.cell("B1").value("Issues");
+        summary.cell("A1").font(xlnt::font().bold(true));
+        summary.cell("B1").font(xlnt::font().bold(true));
+        row = 2;
+        for (size_t r = 0; r < ValidationReport::RULE_COUNT; ++r, ++row) {
+            summary.cell(xlnt::cell_reference(1, row)).value(ruleNames[r]);
+            summary.cell(xlnt::cell_reference(2, row)).value(static_cast<int>(report.countByRule[r]));
+        }
+        summary.cell(xlnt::cell_reference(1, row + 1)).value("Rows checked");
+        summary.cell(xlnt::cell_reference(2, row + 1)).value(static_cast<int>(report.rowsChecked));
+        summary.cell(xlnt::cell_reference(1, row + 2)).value("Rows with issues");
+        summary.cell(xlnt::cell_reference(2, row + 2)).value(static_cast<int>(report.rowsWithIssues()));
 
         wb.save(filename);
-        MenuUtils::printSuccess("Grade report exported to: " + filename);
-        
+        MenuUtils::printSuccess("Validation report saved to: " + filename);
+
     } catch (const exception& e) {
-        MenuUtils::printError("Error creating grade report: " + string(e.what()));
+        MenuUtils::printError("Error creating validation report: " + string(e.what()));
         throw;
     }
 }
 
+void ExcelUtils::writeCsv(const std::string& filename, const std::vector<Student>& students) {
+    writeCsvRows(filename, RosterExport::formatRows(students));
+}
+
+void ExcelUtils::writeCsvRows(const std::string& filename, const std::vector<ExportRow>& rows) {
+    std::filesystem::path filePath(filename);
+    if (filePath.has_parent_path()) {
+        std::filesystem::create_directories(filePath.parent_path());
+    }
+
+    string out;
+    out.reserve(128 * (rows.size() + 1));
+    auto headers = getExcelHeaders();
+    for (size_t i = 0; i < headers.size(); ++i) {
+        if (i > 0) out += ',';
+        appendCsvField(out, headers[i]);
+    }
+    out += "\r\n";
+
+    // Rows are already formatted, so this is only concatenation
+    auto joinRows = [&rows](size_t begin, size_t end) {
+        string text;
+        text.reserve(128 * (end - begin));
+        for (size_t r = begin; r < end; ++r) {
+            const ExportRow& row = rows[r];
+            appendCsvField(text, row.studentId);
+            text += ',';
+            appendCsvField(text, row.name);
+            text += ',';
+            text += to_string(row.age);
+            text += ',';
+            appendCsvField(text, row.gender);
+            text += ',';
+            appendCsvField(text, row.dateOfBirth);
+            text += ',';
+            appendCsvField(text, row.email);
+            for (const auto& score : row.scoreText) {
+                text += ',';
+                text += score;   // not taken: empty field
+            }
+            text += ',';
+            text += row.averageText;
+            text += ',';
+            appendCsvField(text, row.letterGrade);
+            text += ',';
+            text += row.gpaText;
+            text += ',';
+            appendCsvField(text, row.remark);
+            text += ',';
+            appendCsvField(text, row.lastUpdated);
+            text += ',';
+            appendCsvField(text, row.className);
+            text += "\r\n";
+        }
+        return text;
+    };
+    out = TaskScheduler::shared().parallelReduce(rows.size(), CSV_ROWS_PER_TASK, move(out), joinRows,
+                                                 [](string& all, string& text) { all += text; });
+
+    ofstream file(filename, ios::binary);
+    if (!file || !file.write(out.data(), static_cast<streamsize>(out.size())) || !file.flush()) {
+        throw runtime_error("Cannot write CSV file: " + filename);
+    }
+}
+
 // Import operations
-bool ExcelUtils::importStudentData(const std::string& filename, std::vector<Student>& students) {
+bool ExcelUtils::importStudentData(const std::string& filename, std::vector<Student>& students, ValidationReport* validation) {
     try {
         if (!fileExists(filename)) {
             MenuUtils::printWarning("File '" + filename + "' does not exist!");
@@ -268,23 +505,31 @@ bool ExcelUtils::importStudentData(const std::string& filename, std::vector<Stud
             return true;
         }
 
-        auto importedStudents = readExcelToVector(filename);
-        if (importedStudents.empty()) {
+        // Rows are decoded, validated and graded as they stream in; an
+        // unreadable file fails the import and leaves the roster untouched
+        ImportOptions options;
+        options.filename = filename;
+        options.credentialsFile = "data/student_credentials.xlsx";
+        ImportResult result = ImportPipeline::run(options);
+        
+        for (const auto& rejection : result.rejected) {
+            MenuUtils::printWarning("Skipped row " + to_string(rejection.row) + ": " + rejection.reason);
+        }
+        if (result.students.empty()) {
             MenuUtils::printWarning("No valid student data found in the file.");
             return false;
         }
+        if (validation) {
+            *validation = std::move(result.validation);
+        } else if (!result.validation.clean()) {
+            MenuUtils::printWarning(to_string(result.validation.rowsWithIssues()) + " imported rows failed validation.");
+        }
 
-        // Clear existing students and replace with imported data
-        students.clear();
-        students = importedStudents;
-        
-        MenuUtils::printSuccess("Successfully imported " + to_string(importedStudents.size()) + " students.");
-        MenuUtils::printInfo("Updated grade calculations for all students.");
+        // Replace existing students with imported data
+        students = std::move(result.students);
         
-        // Ensure all students have updated grades
-        for (auto& student : students) {
-            student.updateAllGrades();
-        }
+        MenuUtils::printSuccess("Successfully imported " + to_string(students.size()) + " students.");
+        MenuUtils::printInfo("Import pipeline: " + ImportPipeline::summary(result));
         
         return true;
         
@@ -398,7 +643,7 @@ std::vector<std::string> ExcelUtils::getExcelHeaders() {
     
     // Add calculated fields
     headers.insert(headers.end(), {
-        "Average Score", "Letter Grade", "GPA", "Remark", "Last Updated"
+        "Average Score", "Letter Grade", "GPA", "Remark", "Last Updated", "Class"
     });
     
     return headers;
@@ -420,40 +665,164 @@ void ExcelUtils::formatExcelHeader(xlnt::worksheet& ws) {
     }
 }
 
+void ExcelUtils::writeSubjectStatisticsSheet(xlnt::worksheet& ws, const std::vector<SubjectStatistics>& statistics) {
+    ws.title("Subject Statistics");
+
+    vector<string> headers = {"Subject", "Count", "Mean", "Std Dev", "Min", "Q1", "Median", "Q3", "Max"};
+    for (int d = 1; d <= 9; ++d) {
+        headers.push_back("P" + to_string(d * 10));
+    }
+    for (size_t bin = 0; bin < GradeStats::HISTOGRAM_BINS; ++bin) {
+        headers.push_back("Bin " + GradeStats::histogramBinLabel(bin));
+    }
+
+    for (size_t i = 0; i < headers.size(); ++i) {
+        auto cell = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(i + 1), 1));
+        cell.value(headers[i]);
+        cell.font(xlnt::font().bold(true));
+    }
+
+    for (size_t s = 0; s < statistics.size(); ++s) {
+        const auto& stats = statistics[s];
+        int row = static_cast<int>(s + 2);
+        int col = 1;
+
+        ws.cell(xlnt::cell_reference(col++, row)).value(stats.subjectName);
+        ws.cell(xlnt::cell_reference(col++, row)).value(static_cast<int>(stats.count));
+        for (double value : {stats.mean, stats.standardDeviation, stats.minimum, stats.firstQuartile,
+                             stats.median, stats.thirdQuartile, stats.maximum}) {
+            ws.cell(xlnt::cell_reference(col++, row)).value(value);
+        }
+        for (double decile : stats.deciles) {
+            ws.cell(xlnt::cell_reference(col++, row)).value(decile);
+        }
+        for (size_t count : stats.histogram) {
+            ws.cell(xlnt::cell_reference(col++, row)).value(static_cast<int>(count));
+        }
+    }
+}
+
+void ExcelUtils::writeCohortSheet(xlnt::worksheet& ws, const std::vector<Student>& students) {
+    ws.title("Cohorts");
+
+    auto subjects = GradeUtil::getSubjectNames();
+    int row = 1;
+    for (GroupKey key : GroupBy::allKeys()) {
+        vector<string> headers = {GroupBy::keyName(key), "Count", "Mean Average", "Pass Rate (%)"};
+        for (const auto& subject : subjects) {
+            headers.push_back(subject + " Mean");
+        }
+        for (size_t i = 0; i < headers.size(); ++i) {
+            auto cell = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(i + 1), row));
+            cell.value(headers[i]);
+            cell.font(xlnt::font().bold(true));
+        }
+        row++;
+
+        for (const auto& group : GroupBy::aggregate(students, key)) {
+            int col = 1;
+            ws.cell(xlnt::cell_reference(col++, row)).value(group.label);
+            ws.cell(xlnt::cell_reference(col++, row)).value(static_cast<int>(group.count));
+            ws.cell(xlnt::cell_reference(col++, row)).value(group.meanAverage);
+            ws.cell(xlnt::cell_reference(col++, row)).value(group.passRate);
+            for (double mean : group.subjectMeans) {
+                ws.cell(xlnt::cell_reference(col++, row)).value(mean);
+            }
+            row++;
+        }
+        row++;   // blank line between blocks
+    }
+}
+
 // Write student data WITHOUT username and password
-void ExcelUtils::writeStudentToExcel(xlnt::worksheet& ws, const Student& student, int row) {
+void ExcelUtils::writeRowToExcel(xlnt::worksheet& ws, const ExportRow& exportRow, int row) {
     int col = 1;
     
     try {
         // Write basic information (NO username/password)
-        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(student.getStudentId());
-        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(student.getName());
-        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(student.getAge());
-        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(student.getGender());
-        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(student.getDateOfBirth());
-        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(student.getEmail());
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.studentId);
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.name);
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.age);
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.gender);
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.dateOfBirth);
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.email);
         
-        // Subject scores
-        auto scores = student.getSubjectScores();
-        for (const auto& score : scores) {
-            ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(score);
+        // Subject scores; subjects not taken stay empty cells
+        for (size_t i = 0; i < exportRow.scores.size(); ++i) {
+            auto cell = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row));
+            if (exportRow.hasScore(i)) {
+                cell.value(exportRow.scores[i]);
+            }
         }
         
         // Calculated fields
-        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(student.getAverageScore());
-        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(student.getLetterGrade());
-        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(student.getGpa());
-        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(student.getRemark());
-        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(student.getFormattedTimestamp());
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.average);
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.letterGrade);
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.gpa);
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.remark);
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.lastUpdated);
+        ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value(exportRow.className);
         
     } catch (const exception& e) {
         MenuUtils::printWarning("Warning writing student to Excel row " + to_string(row) + ": " + e.what());
     }
 }
 
+// Stream the active sheet's data rows in batches (the header row is skipped)
+void ExcelUtils::streamSheetRows(const std::string& filename, size_t batchRows,
+                                 const std::function<bool(std::vector<SheetRow>&&, const std::string&)>& emit) {
+    // The streaming reader hands out one cell at a time in sheet order, so
+    // rows can be passed on while the rest of the archive is still inflating
+    xlnt::streaming_workbook_reader reader;
+    reader.open(filename);
+    auto titles = reader.sheet_titles();
+    if (titles.empty()) return;
+    const string title = titles.front();     // the sheet writeExcel makes active
+    reader.begin_worksheet(title);
+
+    vector<SheetRow> batch;
+    batch.reserve(batchRows);
+    while (reader.has_cell()) {
+        xlnt::cell cell = reader.read_cell();
+        auto reference = cell.reference();
+        int row = static_cast<int>(reference.row());
+        if (row < 2) continue;
+
+        if (batch.empty() || batch.back().row != row) {
+            if (batch.size() >= batchRows) {
+                if (!emit(std::move(batch), title)) return;
+                batch.clear();
+                batch.reserve(batchRows);
+            }
+            batch.push_back(SheetRow{row, {}});
+        }
+
+        size_t column = static_cast<size_t>(reference.column_index());
+        auto& cells = batch.back().cells;
+        if (cells.size() < column) cells.resize(column);
+        SheetCell& value = cells[column - 1];
+        value.present = cell.has_value();
+        if (value.present) {
+            value.text = cell.to_string();
+            if (cell.data_type() == xlnt::cell_type::number) {
+                value.numeric = true;
+                value.number = cell.value<double>();
+            }
+        }
+    }
+    reader.end_worksheet();
+
+    if (!batch.empty()) emit(std::move(batch), title);
+}
+
 // Read student data (credentials will be empty from main Excel files)
-Student ExcelUtils::readStudentFromExcel(xlnt::worksheet& ws, int row) {
-    int col = 1;
+Student ExcelUtils::decodeStudentRow(const SheetRow& sheetRow, const std::string& sheetTitle) {
+    static const SheetCell blank;
+    size_t col = 0;
+    auto next = [&sheetRow, &col]() -> const SheetCell& {
+        size_t index = col++;
+        return index < sheetRow.cells.size() ? sheetRow.cells[index] : blank;
+    };
     
     try {
         // Note: No username/password in main Excel files, so they'll be empty initially
@@ -461,39 +830,44 @@ Student ExcelUtils::readStudentFromExcel(xlnt::worksheet& ws, int row) {
         string password = "";  // Will be set later from credentials file
         
         // Read basic information
-        string studentId = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).to_string();
-        string name = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).to_string();
+        string studentId = next().text;
+        string name = next().text;
         
-        int age = 20; // default
-        try {
-            age = static_cast<int>(ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col), row)).value<double>());
-        } catch (...) {
-            age = 20;
-        }
-        col++;
+        const SheetCell& ageCell = next();
+        int age = ageCell.numeric ? static_cast<int>(ageCell.number) : 20; // default
         
-        string gender = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).to_string();
-        string dateOfBirth = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).to_string();
-        string email = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).to_string();
+        string gender = next().text;
+        string dateOfBirth = next().text;
+        string email = next().text;
         
-        // Read subject scores with error handling
+        // Read subject scores; an empty or invalid cell means the subject was not taken
         vector<double> scores;
+        uint32_t presentMask = 0;
         auto subjects = GradeUtil::getSubjectNames();
         for (size_t i = 0; i < subjects.size(); ++i) {
-            try {
-                double score = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t>(col++), row)).value<double>();
-                scores.push_back(score);
-            } catch (...) {
-                scores.push_back(0.0); // default score
+            const SheetCell& cell = next();
+            double score = 0.0;
+            if (cell.numeric && GradeUtil::isValidScore(cell.number)) {
+                score = cell.number;
+                presentMask |= 1u << i;
             }
+            scores.push_back(score);
+        }
+        
+        // Class column comes last; older files without it fall back to the
+        // sheet title when that names a class rather than our own default
+        static const size_t classColumn = getExcelHeaders().size() - 1;
+        string className = classColumn < sheetRow.cells.size() ? sheetRow.cells[classColumn].text : "";
+        if (className.empty() && sheetTitle != DEFAULT_SHEET_TITLE) {
+            className = sheetTitle;
         }
         
         // Create student WITHOUT credentials (they'll be set from credentials file)
-        Student student(username, password, studentId, name, age, gender, dateOfBirth, email, scores);
-        student.updateAllGrades(); // Ensure grades are calculated
+        Student student(username, password, studentId, name, age, gender, dateOfBirth, email, scores, presentMask);
+        student.setClassName(className);
         return student;
         
     } catch (const exception& e) {
-        throw runtime_error("Error reading student data from row " + to_string(row) + ": " + e.what());
+        throw runtime_error("Error reading student data from row " + to_string(sheetRow.row) + ": " + e.what());
     }
 }
\ No newline at end of file
@@ -0,0 +1,606 @@
+#include "GradeServer.hpp"
+#include "Admin.hpp"
+#include "ExcelUtil.hpp"
+#include "Gradebook.hpp"
+#include "JsonUtil.hpp"
+#include "MenuUtils.hpp"
+#include "RosterQuery.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const size_t GradeServer::MAX_HEADER_BYTES = 16 * 1024;
+const size_t GradeServer::MAX_BODY_BYTES = 64 * 1024;
+const int GradeServer::SESSION_SECONDS = 8 * 60 * 60;
+
+namespace {
+    // How often blocked accepts re-check the stop flag
+    const int ACCEPT_POLL_MS = 200;
+
+    // A keep-alive connection waiting for its next request is dropped after
+    // this long, or at once when another client is waiting to be accepted
+    const int KEEP_ALIVE_IDLE_MS = 1000;
+
+    // A client that stalls part-way through sending a request
+    const int READ_TIMEOUT_MS = 5000;
+
+    const size_t MAX_REQUESTS_PER_CONNECTION = 1000;
+    const size_t MIN_CONNECTION_THREADS = 8;
+
+#ifdef _WIN32
+    using SocketHandle = SOCKET;
+    const SocketHandle INVALID_HANDLE = INVALID_SOCKET;
+    void closeSocket(SocketHandle socket) { closesocket(socket); }
+    int pollSockets(pollfd* fds, unsigned long count, int timeout) { return WSAPoll(fds, count, timeout); }
+    const int SEND_FLAGS = 0;
+#else
+    using SocketHandle = int;
+    const SocketHandle INVALID_HANDLE = -1;
+    void closeSocket(SocketHandle socket) { close(socket); }
+    int pollSockets(pollfd* fds, nfds_t count, int timeout) { return poll(fds, count, timeout); }
+#ifdef MSG_NOSIGNAL
+    const int SEND_FLAGS = MSG_NOSIGNAL;   // a client hanging up must not raise SIGPIPE
+#else
+    const int SEND_FLAGS = 0;
+#endif
+#endif
+
+    const char* statusText(int status) {
+        switch (status) {
+            case 200: return "OK";
+            case 400: return "Bad Request";
+            case 401: return "Unauthorized";
+            case 403: return "Forbidden";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 413: return "Payload Too Large";
+            case 431: return "Request Header Fields Too Large";
+            case 500: return "Internal Server Error";
+            default: return "Unknown";
+        }
+    }
+
+    HttpResponse jsonError(int status, const string& message) {
+        return {status, JsonObject().add("error", message).str()};
+    }
+
+    string lowercase(string text) {
+        transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+        return text;
+    }
+
+    string trim(const string& text) {
+        size_t begin = text.find_first_not_of(" \t");
+        if (begin == string::npos) return "";
+        return text.substr(begin, text.find_last_not_of(" \t") - begin + 1);
+    }
+
+    string percentDecode(const string& text) {
+        string out;
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] == '+') {
+                out += ' ';
+            } else if (text[i] == '%' && i + 2 < text.size() && isxdigit(static_cast<unsigned char>(text[i + 1]))
+                       && isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+                out += static_cast<char>(stoi(text.substr(i + 1, 2), nullptr, 16));
+                i += 2;
+            } else {
+                out += text[i];
+            }
+        }
+        return out;
+    }
+
+    // Parses the request line and headers in head; false when malformed
+    bool parseHead(const string& head, HttpRequest& request) {
+        size_t lineEnd = head.find("\r\n");
+        string requestLine = head.substr(0, lineEnd);
+        size_t firstSpace = requestLine.find(' ');
+        size_t secondSpace = requestLine.find(' ', firstSpace + 1);
+        if (firstSpace == string::npos || secondSpace == string::npos) return false;
+
+        request.method = requestLine.substr(0, firstSpace);
+        string target = requestLine.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+        string version = requestLine.substr(secondSpace + 1);
+        if (version.compare(0, 5, "HTTP/") != 0) return false;
+        if (version == "HTTP/1.0") request.headers["connection"] = "close";
+
+        size_t question = target.find('?');
+        request.path = percentDecode(target.substr(0, question));
+        if (question != string::npos) {
+            string query = target.substr(question + 1);
+            size_t start = 0;
+            while (start <= query.size()) {
+                size_t end = query.find('&', start);
+                if (end == string::npos) end = query.size();
+                string pair = query.substr(start, end - start);
+                size_t equals = pair.find('=');
+                if (!pair.empty()) {
+                    request.query[percentDecode(pair.substr(0, equals))] =
+                        equals == string::npos ? "" : percentDecode(pair.substr(equals + 1));
+                }
+                start = end + 1;
+            }
+        }
+
+        for (size_t pos = lineEnd + 2; pos < head.size();) {
+            size_t end = head.find("\r\n", pos);
+            if (end == string::npos) end = head.size();
+            string line = head.substr(pos, end - pos);
+            size_t colon = line.find(':');
+            if (colon == string::npos) return false;
+            request.headers[lowercase(trim(line.substr(0, colon)))] = trim(line.substr(colon + 1));
+            pos = end + 2;
+        }
+        return true;
+    }
+
+    bool sendAll(SocketHandle socket, const string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            auto written = send(socket, data.data() + sent, static_cast<int>(data.size() - sent), SEND_FLAGS);
+            if (written <= 0) return false;
+            sent += static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    string renderResponse(const HttpResponse& response, bool keepAlive) {
+        string out = "HTTP/1.1 " + to_string(response.status) + " " + statusText(response.status) + "\r\n";
+        out += "Content-Type: application/json\r\n";
+        out += "Content-Length: " + to_string(response.body.size()) + "\r\n";
+        out += "Cache-Control: no-store\r\n";
+        out += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+        out += response.body;
+        return out;
+    }
+
+    // Waits for the socket to become readable; false on timeout or error
+    bool waitReadable(SocketHandle socket, int timeoutMs) {
+        pollfd fd{};
+        fd.fd = socket;
+        fd.events = POLLIN;
+        return pollSockets(&fd, 1, timeoutMs) > 0;
+    }
+
+    // Waits for the next request on an idle keep-alive connection. Gives up
+    // when the listener has a client queued, so idle connections never keep
+    // new ones waiting for a thread.
+    bool waitForNextRequest(SocketHandle socket, SocketHandle listener) {
+        pollfd fds[2] = {};
+        fds[0].fd = socket;
+        fds[0].events = POLLIN;
+        fds[1].fd = listener;
+        fds[1].events = POLLIN;
+        if (pollSockets(fds, 2, KEEP_ALIVE_IDLE_MS) <= 0) return false;
+        return (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+    }
+
+    // Reads and answers requests on one connection until either side closes
+    void serveConnection(GradeServer& server, SocketHandle socket, SocketHandle listener, const atomic<bool>& stop) {
+        string buffer;
+        char chunk[8192];
+        for (size_t served = 0; served < MAX_REQUESTS_PER_CONNECTION && !stop; ++served) {
+            size_t headEnd;
+            while ((headEnd = buffer.find("\r\n\r\n")) == string::npos) {
+                if (buffer.size() > GradeServer::MAX_HEADER_BYTES) {
+                    sendAll(socket, renderResponse(jsonError(431, "Request headers too large"), false));
+                    return;
+                }
+                bool idle = served > 0 && buffer.empty();
+                bool ready = idle ? waitForNextRequest(socket, listener) : waitReadable(socket, READ_TIMEOUT_MS);
+                if (!ready) return;
+                auto received = recv(socket, chunk, sizeof(chunk), 0);
+                if (received <= 0) return;
+                buffer.append(chunk, static_cast<size_t>(received));
+            }
+
+            HttpRequest request;
+            if (!parseHead(buffer.substr(0, headEnd), request)) {
+                sendAll(socket, renderResponse(jsonError(400, "Malformed request"), false));
+                return;
+            }
+
+            size_t bodyLength = 0;
+            auto length = request.headers.find("content-length");
+            if (length != request.headers.end()) {
+                try {
+                    bodyLength = stoul(length->second);
+                } catch (const exception&) {
+                    sendAll(socket, renderResponse(jsonError(400, "Invalid Content-Length"), false));
+                    return;
+                }
+            }
+            if (bodyLength > GradeServer::MAX_BODY_BYTES) {
+                sendAll(socket, renderResponse(jsonError(413, "Request body too large"), false));
+                return;
+            }
+            while (buffer.size() < headEnd + 4 + bodyLength) {
+                if (!waitReadable(socket, READ_TIMEOUT_MS)) return;
+                auto received = recv(socket, chunk, sizeof(chunk), 0);
+                if (received <= 0) return;
+                buffer.append(chunk, static_cast<size_t>(received));
+            }
+            request.body = buffer.substr(headEnd + 4, bodyLength);
+            buffer.erase(0, headEnd + 4 + bodyLength);   // pipelined requests stay buffered
+
+            HttpResponse response;
+            try {
+                response = server.handle(request);
+            } catch (const exception& e) {
+                response = jsonError(500, e.what());
+            }
+
+            auto connection = request.headers.find("connection");
+            bool keepAlive = !(connection != request.headers.end() && lowercase(connection->second) == "close")
+                             && served + 1 < MAX_REQUESTS_PER_CONNECTION;
+            if (!sendAll(socket, renderResponse(response, keepAlive)) || !keepAlive) return;
+        }
+    }
+
+    SocketHandle openListener(const ServerOptions& options) {
+        SocketHandle listener = INVALID_HANDLE;
+        if (!options.socketPath.empty()) {
+#ifdef _WIN32
+            throw runtime_error("Unix sockets are not supported on this platform; use --port");
+#else
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            if (options.socketPath.size() >= sizeof(address.sun_path)) {
+                throw runtime_error("Socket path too long: " + options.socketPath);
+            }
+            strncpy(address.sun_path, options.socketPath.c_str(), sizeof(address.sun_path) - 1);
+            unlink(options.socketPath.c_str());   // left behind by an earlier run
+            listener = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (listener == INVALID_HANDLE || ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                if (listener != INVALID_HANDLE) closeSocket(listener);
+                throw runtime_error("Cannot bind " + options.socketPath + ": " + strerror(errno));
+            }
+#endif
+        } else {
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(static_cast<uint16_t>(options.port));
+            if (inet_pton(AF_INET, options.host.c_str(), &address.sin_addr) != 1) {
+                throw runtime_error("Invalid IPv4 address: " + options.host);
+            }
+            listener = socket(AF_INET, SOCK_STREAM, 0);
+            int reuse = 1;
+            if (listener != INVALID_HANDLE) {
+                setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+            }
+            if (listener == INVALID_HANDLE || ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                if (listener != INVALID_HANDLE) closeSocket(listener);
+                throw runtime_error("Cannot bind " + options.host + ":" + to_string(options.port));
+            }
+        }
+
+        if (listen(listener, SOMAXCONN) != 0) {
+            closeSocket(listener);
+            throw runtime_error("Cannot listen on the server socket");
+        }
+
+        // Several threads accept on the same socket; whoever loses the race
+        // after poll must get EAGAIN rather than block
+#ifdef _WIN32
+        u_long nonBlocking = 1;
+        ioctlsocket(listener, FIONBIO, &nonBlocking);
+#else
+        fcntl(listener, F_SETFL, fcntl(listener, F_GETFL, 0) | O_NONBLOCK);
+#endif
+        return listener;
+    }
+}
+
+GradeServer::GradeServer(const ServerOptions& options) : options(options) {
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+}
+
+GradeServer::~GradeServer() {
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void GradeServer::loadRoster() {
+    if (!ExcelUtils::fileExists(options.rosterFile)) {
+        throw runtime_error("File not found: " + options.rosterFile);
+    }
+
+    auto next = make_shared<RosterSnapshot>();
+    next->students = ExcelUtils::readStudentRows(options.rosterFile);
+
+    // Credentials live beside the roster, as the interactive app keeps them
+    map<string, pair<string, string>> credentials;
+    string credentialsFile = (std::filesystem::path(options.rosterFile).parent_path() / "student_credentials.xlsx").string();
+    ExcelUtils::loadCredentialsFromFile(credentialsFile, credentials);
+    for (auto& student : next->students) {
+        auto found = credentials.find(student.getStudentId());
+        if (found != credentials.end()) {
+            student.setUsername(found->second.first);
+            student.setPassword(found->second.second);
+        }
+    }
+    try {
+        Gradebook::open().applyTo(next->students);
+    } catch (const exception& e) {
+        MenuUtils::printWarning("Could not read gradebook: " + string(e.what()));
+    }
+
+    next->studentJson.reserve(next->students.size());
+    for (uint32_t row = 0; row < next->students.size(); ++row) {
+        const Student& student = next->students[row];
+        next->studentJson.push_back(JsonUtil::student(student));
+        next->rowById.emplace(student.getStudentId(), row);
+        if (!student.getUsername().empty()) next->rowsByUsername[student.getUsername()].push_back(row);
+    }
+    next->statisticsJson = JsonUtil::rosterStatistics(next->students);
+    next->loadedAt = time(nullptr);
+
+    lock_guard<mutex> lock(reloadMutex);
+    auto previous = snapshot();
+    next->version = previous ? previous->version + 1 : 1;
+    atomic_store(&current, shared_ptr<const RosterSnapshot>(move(next)));
+}
+
+std::shared_ptr<const RosterSnapshot> GradeServer::snapshot() const {
+    return atomic_load(&current);
+}
+
+void GradeServer::run(const std::atomic<bool>& stop) {
+    SocketHandle listener = openListener(options);
+    // Threads mostly wait on sockets, so there are more of them than cores
+    size_t threads = options.connectionThreads ? options.connectionThreads
+                                               : max<size_t>(MIN_CONNECTION_THREADS, 2 * thread::hardware_concurrency());
+
+    // Each thread accepts and serves its own connections, so there is no
+    // hand-off queue between accepting and reading
+    auto acceptLoop = [&] {
+        while (!stop) {
+            if (!waitReadable(listener, ACCEPT_POLL_MS)) continue;
+            SocketHandle client = accept(listener, nullptr, nullptr);
+            if (client == INVALID_HANDLE) continue;
+#ifdef _WIN32
+            u_long blocking = 0;
+            ioctlsocket(client, FIONBIO, &blocking);
+#else
+            fcntl(client, F_SETFL, fcntl(client, F_GETFL, 0) & ~O_NONBLOCK);
+#endif
+            if (options.socketPath.empty()) {
+                int noDelay = 1;
+                setsockopt(client, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+            }
+            serveConnection(*this, client, listener, stop);
+            closeSocket(client);
+        }
+    };
+
+    vector<thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(acceptLoop);
+    }
+    acceptLoop();
+    for (auto& worker : workers) worker.join();
+
+    closeSocket(listener);
+#ifndef _WIN32
+    if (!options.socketPath.empty()) unlink(options.socketPath.c_str());
+#endif
+}
+
+HttpResponse GradeServer::handle(const HttpRequest& request) {
+    requests.fetch_add(1, memory_order_relaxed);
+    const string& path = request.path;
+    bool get = request.method == "GET";
+    bool post = request.method == "POST";
+
+    if (path == "/api/health") {
+        if (!get) return jsonError(405, "Use GET");
+        auto roster = snapshot();
+        return {200, JsonObject().add("status", "ok").add("students", roster ? roster->students.size() : size_t(0))
+                                 .add("rosterVersion", roster ? static_cast<size_t>(roster->version) : size_t(0)).str()};
+    }
+    if (!snapshot()) return jsonError(500, "Roster not loaded");
+    if (path == "/api/login") return post ? login(request) : jsonError(405, "Use POST");
+    if (path == "/api/me") return get ? studentGrades(request) : jsonError(405, "Use GET");
+    if (path == "/api/stats") return get ? statistics(request) : jsonError(405, "Use GET");
+    if (path == "/api/students") return get ? listStudents(request) : jsonError(405, "Use GET");
+    if (path.compare(0, 14, "/api/students/") == 0) {
+        return get ? findStudent(request, path.substr(14)) : jsonError(405, "Use GET");
+    }
+    if (path == "/api/reload") return post ? reload(request) : jsonError(405, "Use POST");
+    return jsonError(404, "No such endpoint: " + path);
+}
+
+std::uint64_t GradeServer::requestCount() const {
+    return requests.load(memory_order_relaxed);
+}
+
+std::string GradeServer::endpoint() const {
+    if (!options.socketPath.empty()) return "unix:" + options.socketPath;
+    return "http://" + options.host + ":" + to_string(options.port);
+}
+
+// ---------------------------------------------------------------------------
+// Sessions
+// ---------------------------------------------------------------------------
+
+std::string GradeServer::newToken() {
+    static const char hex[] = "0123456789abcdef";
+    // Bearer tokens must not be predictable: every bit comes from the OS
+    // generator (getrandom / urandom, or rand_s on Windows), not a seeded PRNG
+    static random_device source;
+    string token;
+    lock_guard<mutex> lock(tokenMutex);
+    for (int part = 0; part < 4; ++part) {
+        uint32_t bits = source();
+        for (int i = 0; i < 8; ++i, bits >>= 4) token += hex[bits & 0xF];
+    }
+    return token;
+}
+
+std::string GradeServer::createSession(bool admin, std::uint32_t row, std::uint64_t rosterVersion) {
+    string token = newToken();
+    time_t now = time(nullptr);
+    unique_lock<shared_mutex> lock(sessionMutex);
+    // Expired sessions are swept whenever a new one is issued
+    for (auto it = sessions.begin(); it != sessions.end();) {
+        it = it->second.expires < now ? sessions.erase(it) : next(it);
+    }
+    sessions[token] = {admin, row, rosterVersion, now + SESSION_SECONDS};
+    return token;
+}
+
+void GradeServer::endStudentSessions() {
+    unique_lock<shared_mutex> lock(sessionMutex);
+    for (auto it = sessions.begin(); it != sessions.end();) {
+        it = it->second.admin ? next(it) : sessions.erase(it);
+    }
+}
+
+bool GradeServer::findSession(const HttpRequest& request, Session& session) const {
+    auto header = request.headers.find("authorization");
+    if (header == request.headers.end() || header->second.compare(0, 7, "Bearer ") != 0) return false;
+
+    shared_lock<shared_mutex> lock(sessionMutex);
+    auto found = sessions.find(header->second.substr(7));
+    if (found == sessions.end() || found->second.expires < time(nullptr)) return false;
+    session = found->second;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Endpoints
+// ---------------------------------------------------------------------------
+
+HttpResponse GradeServer::login(const HttpRequest& request) {
+    map<string, string> fields;
+    try {
+        fields = JsonUtil::parseObject(request.body);
+    } catch (const exception& e) {
+        return jsonError(400, "Expected a JSON body: " + string(e.what()));
+    }
+    const string& username = fields["username"];
+    const string& password = fields["password"];
+
+    if (Admin().validateCredentials(username, password)) {
+        return {200, JsonObject().add("token", createSession(true, 0, 0)).add("role", "Admin")
+                                 .add("expiresIn", SESSION_SECONDS).str()};
+    }
+
+    // Auto-generated usernames are first names, so several students may
+    // share one; as in the interactive login, the first whose password
+    // matches signs in
+    auto roster = snapshot();
+    auto candidates = roster->rowsByUsername.find(username);
+    if (candidates == roster->rowsByUsername.end()) return jsonError(401, "Invalid credentials");
+    for (uint32_t row : candidates->second) {
+        const Student& student = roster->students[row];
+        if (!student.validateCredentials(username, password)) continue;
+        return {200, JsonObject().add("token", createSession(false, row, roster->version)).add("role", "Student")
+                                 .add("studentId", student.getStudentId()).add("expiresIn", SESSION_SECONDS).str()};
+    }
+    return jsonError(401, "Invalid credentials");
+}
+
+HttpResponse GradeServer::studentGrades(const HttpRequest& request) {
+    Session session;
+    if (!findSession(request, session)) return jsonError(401, "Sign in first");
+    if (session.admin) return jsonError(400, "Administrators have no grades; use /api/students");
+
+    auto roster = snapshot();
+    if (roster->version != session.rosterVersion) return jsonError(401, "The roster was reloaded; sign in again");
+    return {200, roster->studentJson[session.row]};
+}
+
+HttpResponse GradeServer::statistics(const HttpRequest& request) {
+    Session session;
+    if (!findSession(request, session)) return jsonError(401, "Sign in first");
+    return {200, snapshot()->statisticsJson};
+}
+
+HttpResponse GradeServer::listStudents(const HttpRequest& request) {
+    Session session;
+    if (!findSession(request, session)) return jsonError(401, "Sign in first");
+    if (!session.admin) return jsonError(403, "Administrators only");
+
+    auto roster = snapshot();
+    vector<uint32_t> rows;
+    auto query = request.query.find("q");
+    if (query != request.query.end() && !query->second.empty()) {
+        try {
+            rows = RosterQuery::parse(query->second).run(roster->students);
+        } catch (const invalid_argument& e) {
+            return jsonError(400, e.what());
+        }
+    } else {
+        rows.resize(roster->students.size());
+        for (uint32_t i = 0; i < rows.size(); ++i) rows[i] = i;
+    }
+
+    string items = "[";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (i > 0) items += ',';
+        items += roster->studentJson[rows[i]];
+    }
+    items += ']';
+    return {200, JsonObject().add("count", rows.size()).raw("students", items).str()};
+}
+
+HttpResponse GradeServer::findStudent(const HttpRequest& request, const std::string& studentId) {
+    Session session;
+    if (!findSession(request, session)) return jsonError(401, "Sign in first");
+    auto roster = snapshot();
+    if (!session.admin) {
+        if (roster->version != session.rosterVersion) return jsonError(401, "The roster was reloaded; sign in again");
+        if (roster->students[session.row].getStudentId() != studentId) {
+            return jsonError(403, "Students may only read their own record");
+        }
+    }
+    auto row = roster->rowById.find(studentId);
+    if (row == roster->rowById.end()) return jsonError(404, "No student with ID " + studentId);
+    return {200, roster->studentJson[row->second]};
+}
+
+HttpResponse GradeServer::reload(const HttpRequest& request) {
+    Session session;
+    if (!findSession(request, session)) return jsonError(401, "Sign in first");
+    if (!session.admin) return jsonError(403, "Administrators only");
+
+    try {
+        loadRoster();
+    } catch (const exception& e) {
+        return jsonError(500, "Reload failed, previous roster still served: " + string(e.what()));
+    }
+    // Rows and IDs may have moved; students sign in again against the new roster
+    endStudentSessions();
+    auto roster = snapshot();
+    return {200, JsonObject().add("students", roster->students.size())
+                             .add("rosterVersion", static_cast<size_t>(roster->version)).str()};
+}
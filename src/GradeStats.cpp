@@ -0,0 +1,181 @@
+#include "GradeStats.hpp"
+#include "GradeUtil.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+using namespace std;
+
+const size_t GradeStats::HISTOGRAM_BINS = 10;
+const double GradeStats::HISTOGRAM_BIN_WIDTH = 10.0;
+
+namespace {
+    // Rows per task below which scheduling costs more than it saves
+    const size_t MIN_ROWS_PER_TASK = 16384;
+
+    // Running sums for one subject over a slice of the roster. Scores are
+    // bounded to 0-100, so plain sums of squares stay well within precision.
+    struct ColumnAccumulator {
+        size_t count = 0;
+        double sum = 0.0;
+        double sumOfSquares = 0.0;
+        double minimum = numeric_limits<double>::max();
+        double maximum = numeric_limits<double>::lowest();
+        array<size_t, 10> histogram{};
+        vector<double> values;
+
+        // Masked add: present is 0 or 1 and weights every update, so absent
+        // subjects cost the same straight-line code as present ones. values
+        // must be pre-sized; the score is always written at the next free
+        // slot and only kept when present advances count.
+        void add(double score, unsigned present) {
+            values[count] = score;
+            count += present;
+            sum += score * present;
+            sumOfSquares += score * score * present;
+            minimum = min(minimum, present ? score : numeric_limits<double>::max());
+            maximum = max(maximum, present ? score : numeric_limits<double>::lowest());
+
+            int bin = static_cast<int>(score / GradeStats::HISTOGRAM_BIN_WIDTH);
+            bin = max(0, min(bin, static_cast<int>(GradeStats::HISTOGRAM_BINS) - 1));
+            histogram[bin] += present;
+        }
+
+        void merge(const ColumnAccumulator& other) {
+            count += other.count;
+            sum += other.sum;
+            sumOfSquares += other.sumOfSquares;
+            minimum = min(minimum, other.minimum);
+            maximum = max(maximum, other.maximum);
+            for (size_t i = 0; i < histogram.size(); ++i) {
+                histogram[i] += other.histogram[i];
+            }
+            values.insert(values.end(), other.values.begin(), other.values.end());
+        }
+    };
+}
+
+std::vector<SubjectStatistics> GradeStats::computeSubjectStatistics(const std::vector<Student>& students) {
+    auto subjects = GradeUtil::getSubjectNames();
+    size_t subjectCount = subjects.size();
+    TaskScheduler& scheduler = TaskScheduler::shared();
+
+    // Reduce: each chunk of rows is scanned into its own accumulators and
+    // the chunks are merged in order
+    using Columns = vector<ColumnAccumulator>;
+    auto scanSlice = [&](size_t begin, size_t end) {
+        Columns local(subjectCount);
+        for (auto& column : local) {
+            column.values.resize(end - begin);
+        }
+        for (size_t i = begin; i < end; ++i) {
+            const auto& scores = students[i].getSubjectScores();
+            uint32_t mask = students[i].getScoreMask();
+            size_t stored = min(scores.size(), subjectCount);
+            for (size_t s = 0; s < stored; ++s) {
+                local[s].add(scores[s], (mask >> s) & 1u);
+            }
+        }
+        for (auto& column : local) {
+            column.values.resize(column.count);
+        }
+        return local;
+    };
+    auto mergeSlice = [](Columns& merged, Columns& local) {
+        for (size_t s = 0; s < merged.size(); ++s) {
+            merged[s].merge(local[s]);
+            vector<double>().swap(local[s].values);
+        }
+    };
+    Columns merged = scheduler.parallelReduce(students.size(), MIN_ROWS_PER_TASK, Columns(subjectCount),
+                                              scanSlice, mergeSlice);
+
+    // Then select quantiles per subject
+    vector<SubjectStatistics> results(subjectCount);
+    auto finishSubject = [&](size_t s) {
+        auto& column = merged[s];
+        auto& stats = results[s];
+        stats.subjectName = subjects[s];
+        stats.count = column.count;
+        stats.histogram = column.histogram;
+        if (column.count == 0) return;
+
+        double n = static_cast<double>(column.count);
+        stats.mean = column.sum / n;
+        stats.standardDeviation = sqrt(max(0.0, column.sumOfSquares / n - stats.mean * stats.mean));
+        stats.minimum = column.minimum;
+        stats.maximum = column.maximum;
+        computeQuantiles(column.values, stats);
+    };
+
+    // One subject per task once the columns are big enough to be worth it
+    size_t subjectsPerTask = students.size() >= MIN_ROWS_PER_TASK ? 1 : subjectCount;
+    scheduler.parallelFor(subjectCount, subjectsPerTask, [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; ++s) finishSubject(s);
+    });
+
+    return results;
+}
+
+double GradeStats::selectQuantile(std::vector<double>& values, double quantile) {
+    if (values.empty()) return 0.0;
+
+    double position = quantile * static_cast<double>(values.size() - 1);
+    size_t lower = static_cast<size_t>(position);
+    double fraction = position - static_cast<double>(lower);
+
+    nth_element(values.begin(), values.begin() + lower, values.end());
+    double lowerValue = values[lower];
+    if (fraction <= 0.0 || lower + 1 >= values.size()) {
+        return lowerValue;
+    }
+    double upperValue = *min_element(values.begin() + lower + 1, values.end());
+    return lowerValue + fraction * (upperValue - lowerValue);
+}
+
+// Ascending quantiles share work: after each selection everything left of the
+// pivot is already <= it, so the next selection only partitions the right side.
+void GradeStats::computeQuantiles(std::vector<double>& column, SubjectStatistics& stats) {
+    struct Request { double quantile; double* target; };
+    vector<Request> requests;
+    for (size_t d = 0; d < stats.deciles.size(); ++d) {
+        requests.push_back({(d + 1) / 10.0, &stats.deciles[d]});
+    }
+    requests.push_back({0.25, &stats.firstQuartile});
+    requests.push_back({0.75, &stats.thirdQuartile});
+    sort(requests.begin(), requests.end(),
+        [](const Request& a, const Request& b) { return a.quantile < b.quantile; });
+
+    size_t n = column.size();
+    size_t start = 0;
+    for (const auto& request : requests) {
+        double position = request.quantile * static_cast<double>(n - 1);
+        size_t lower = static_cast<size_t>(position);
+        double fraction = position - static_cast<double>(lower);
+
+        nth_element(column.begin() + start, column.begin() + lower, column.end());
+        double value = column[lower];
+        if (fraction > 0.0 && lower + 1 < n) {
+            double upper = *min_element(column.begin() + lower + 1, column.end());
+            value += fraction * (upper - value);
+        }
+        *request.target = value;
+        start = lower;
+    }
+    stats.median = stats.deciles[4];
+}
+
+std::string GradeStats::histogramBinLabel(size_t bin) {
+    int low = static_cast<int>(bin * HISTOGRAM_BIN_WIDTH);
+    int high = (bin + 1 == HISTOGRAM_BINS) ? 100 : low + static_cast<int>(HISTOGRAM_BIN_WIDTH) - 1;
+    return to_string(low) + "-" + to_string(high);
+}
+
+std::string GradeStats::formatValue(double value) {
+    ostringstream oss;
+    oss << fixed << setprecision(2) << value;
+    return oss.str();
+}
@@ -19,6 +19,18 @@ double GradeUtil::calculateAverage(const std::vector<double>& scores) {
     return sum / scores.size();
 }
 
+// Presence bits weight each score, so there is no branch per subject
+double GradeUtil::calculateAverage(const std::vector<double>& scores, std::uint32_t presentMask) {
+    double sum = 0.0;
+    unsigned count = 0;
+    for (size_t i = 0; i < scores.size() && i < 32; ++i) {
+        unsigned present = (presentMask >> i) & 1u;
+        sum += scores[i] * present;
+        count += present;
+    }
+    return count > 0 ? sum / count : 0.0;
+}
+
 std::string GradeUtil::assignLetterGrade(double average) {
     if (average >= GRADE_A_THRESHOLD) return "A";
     else if (average >= GRADE_B_THRESHOLD) return "B";
@@ -49,6 +61,10 @@ bool GradeUtil::isPassingGrade(double average) {
     return average >= PASSING_THRESHOLD;  // 50+ is passing
 }
 
+std::array<double, 5> GradeUtil::getGradeThresholds() {
+    return {GRADE_A_THRESHOLD, GRADE_B_THRESHOLD, GRADE_C_THRESHOLD, GRADE_D_THRESHOLD, GRADE_E_THRESHOLD};
+}
+
 std::vector<std::string> GradeUtil::getSubjectNames() {
     return {
         "Mathematics",
@@ -0,0 +1,265 @@
+#include "Gradebook.hpp"
+#include "ExcelUtil.hpp"
+#include "GradeUtil.hpp"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+const std::string Gradebook::DEFAULT_DIRECTORY = "data/terms";
+const double Gradebook::CREDITS_PER_SUBJECT = 3.0;
+
+namespace {
+    const string LEDGER_FILE_MAGIC = "SCOREME-GRADEBOOK 2";
+    const string ID_KEYED_LEDGER_MAGIC = "SCOREME-GRADEBOOK 1";   // entries keyed by positional student ID
+    const string LEDGER_FILE_NAME = "gradebook.ledger";
+
+    vector<string> splitTabs(const string& line) {
+        vector<string> fields;
+        stringstream ss(line);
+        string field;
+        while (getline(ss, field, '\t')) {
+            fields.push_back(field);
+        }
+        return fields;
+    }
+}
+
+double CumulativeRecord::gpa() const {
+    return credits > 0.0 ? qualityPoints / credits : 0.0;
+}
+
+Gradebook Gradebook::open(const std::string& directory) {
+    Gradebook book;
+    book.directory = directory;
+
+    string ledger = book.ledgerFilename();
+    if (!ExcelUtils::fileExists(ledger)) {
+        return book;
+    }
+
+    ifstream in(ledger);
+    string line;
+    if (!in || !getline(in, line) || (line != LEDGER_FILE_MAGIC && line != ID_KEYED_LEDGER_MAGIC)) {
+        throw runtime_error("Not a ScoreME gradebook ledger: " + ledger);
+    }
+    bool keyedById = line == ID_KEYED_LEDGER_MAGIC;
+
+    // "T <name>" declares the next term; "E <term> <key> <average> <gpa> <credits>" is one student's term
+    while (getline(in, line)) {
+        if (line.empty()) continue;
+        vector<string> fields = splitTabs(line);
+        try {
+            if (fields[0] == "T" && fields.size() == 2) {
+                book.termNames.push_back(fields[1]);
+                book.contributions.emplace_back();
+            } else if (fields[0] == "E" && fields.size() == 6) {
+                size_t termIndex = stoul(fields[1]);
+                if (termIndex >= book.termNames.size()) throw out_of_range("term");
+                TermContribution contribution = {stod(fields[3]), stod(fields[4]), stod(fields[5])};
+                book.contributions[termIndex][fields[2]] = contribution;
+                book.addContribution(fields[2], contribution);
+            } else {
+                throw invalid_argument("record");
+            }
+        } catch (const exception&) {
+            throw runtime_error("Malformed gradebook ledger line: " + line);
+        }
+    }
+    in.close();
+    if (keyedById) book.rekeyFromWorkbooks();
+    return book;
+}
+
+bool Gradebook::recordTerm(const std::string& term, const std::vector<Student>& students) {
+    if (term.empty() || term.find('\t') != string::npos || term.find('\n') != string::npos) {
+        throw invalid_argument("Term name must be non-empty and on one line");
+    }
+
+    auto existing = find(termNames.begin(), termNames.end(), term);
+    bool correction = existing != termNames.end();
+    size_t termIndex = correction ? static_cast<size_t>(existing - termNames.begin()) : termNames.size();
+
+    // Workbook first: if it cannot be written, the ledger is left untouched
+    std::filesystem::create_directories(directory);
+    if (!correction) {
+        termNames.push_back(term);
+        contributions.emplace_back();
+    }
+    try {
+        ExcelUtils::writeExcel(termFilename(termIndex), students);
+    } catch (...) {
+        if (!correction) {
+            termNames.pop_back();
+            contributions.pop_back();
+        }
+        throw;
+    }
+
+    // Take the old term out of each cumulative record, then add the new one
+    auto& termEntries = contributions[termIndex];
+    for (const auto& entry : termEntries) {
+        removeContribution(entry.first, entry.second);
+    }
+    termEntries.clear();
+    addTerm(termIndex, students);
+
+    saveLedger();
+    return correction;
+}
+
+bool Gradebook::hasTerm(const std::string& term) const {
+    return find(termNames.begin(), termNames.end(), term) != termNames.end();
+}
+
+const std::vector<std::string>& Gradebook::terms() const {
+    return termNames;
+}
+
+std::vector<TermSummary> Gradebook::termSummaries() const {
+    vector<TermSummary> summaries;
+    for (size_t t = 0; t < termNames.size(); ++t) {
+        double averageSum = 0.0, gpaSum = 0.0;
+        for (const auto& entry : contributions[t]) {
+            averageSum += entry.second.average;
+            gpaSum += entry.second.gpa;
+        }
+        size_t count = contributions[t].size();
+        summaries.push_back({termNames[t], count, count > 0 ? averageSum / count : 0.0, count > 0 ? gpaSum / count : 0.0});
+    }
+    return summaries;
+}
+
+const CumulativeRecord* Gradebook::cumulative(const Student& student) const {
+    auto found = records.find(student.identityKey());
+    return found != records.end() ? &found->second : nullptr;
+}
+
+void Gradebook::applyTo(std::vector<Student>& students) const {
+    for (auto& student : students) {
+        const CumulativeRecord* record = cumulative(student);
+        student.setCumulativeRecord(record ? record->credits : 0.0, record ? record->gpa() : 0.0);
+    }
+}
+
+std::vector<Transcript> Gradebook::buildTranscripts() const {
+    vector<Transcript> transcripts;
+    unordered_map<string, size_t> slot;
+    slot.reserve(records.size());
+
+    for (size_t t = 0; t < termNames.size(); ++t) {
+        vector<Student> termRoster = ExcelUtils::readStudentRows(termFilename(t));
+        for (const auto& student : termRoster) {
+            auto inserted = slot.emplace(student.identityKey(), transcripts.size());
+            if (inserted.second) {
+                transcripts.push_back({student.getStudentId(), student.getName(), {}, {}});
+                const CumulativeRecord* record = cumulative(student);
+                if (record) transcripts.back().cumulative = *record;
+            }
+
+            Transcript& transcript = transcripts[inserted.first->second];
+            transcript.studentId = student.getStudentId();   // latest term's ID and spelling win
+            transcript.name = student.getName();
+            transcript.entries.push_back({termNames[t], student.getAverageScore(), student.getLetterGrade(),
+                                          student.getGpa(), termCredits(student), student.getSubjectScores(),
+                                          student.getScoreMask()});
+        }
+    }
+
+    sort(transcripts.begin(), transcripts.end(),
+         [](const Transcript& a, const Transcript& b) { return a.studentId < b.studentId; });
+    return transcripts;
+}
+
+double Gradebook::termCredits(const Student& student) {
+    // Only subjects actually taken earn credit
+    uint32_t mask = student.getScoreMask();
+    size_t taken = 0;
+    for (; mask; mask &= mask - 1) taken++;
+    return CREDITS_PER_SUBJECT * static_cast<double>(taken);
+}
+
+std::string Gradebook::termFilename(size_t termIndex) const {
+    // Index keeps names unique; the sanitized term name keeps them readable
+    string safe;
+    for (char c : termNames[termIndex]) {
+        safe += (isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_') ? c : '_';
+    }
+    return (std::filesystem::path(directory) / ("term_" + to_string(termIndex + 1) + "_" + safe + ".xlsx")).string();
+}
+
+std::string Gradebook::ledgerFilename() const {
+    return (std::filesystem::path(directory) / LEDGER_FILE_NAME).string();
+}
+
+void Gradebook::saveLedger() const {
+    // Written beside the ledger and renamed over it, so a crash never leaves half a file
+    string ledger = ledgerFilename();
+    string temporary = ledger + ".tmp";
+    {
+        ofstream out(temporary);
+        if (!out) {
+            throw runtime_error("Cannot write gradebook ledger: " + ledger);
+        }
+        out << LEDGER_FILE_MAGIC << "\n" << setprecision(10);
+        for (size_t t = 0; t < termNames.size(); ++t) {
+            out << "T\t" << termNames[t] << "\n";
+            for (const auto& entry : contributions[t]) {
+                out << "E\t" << t << "\t" << entry.first << "\t" << entry.second.average << "\t"
+                    << entry.second.gpa << "\t" << entry.second.credits << "\n";
+            }
+        }
+        if (!out.flush()) {
+            throw runtime_error("Cannot write gradebook ledger: " + ledger);
+        }
+    }
+    std::filesystem::rename(temporary, ledger);
+}
+
+// One ledger entry per student; a student listed twice keeps the first row
+void Gradebook::addTerm(size_t termIndex, const std::vector<Student>& students) {
+    auto& termEntries = contributions[termIndex];
+    for (const auto& student : students) {
+        TermContribution contribution = {student.getAverageScore(), student.getGpa(), termCredits(student)};
+        string identity = student.identityKey();
+        if (termEntries.emplace(identity, contribution).second) {
+            addContribution(identity, contribution);
+        }
+    }
+}
+
+// Entries of an old ledger are keyed by student IDs that have been renumbered
+// since; the term workbooks still say who each student was
+void Gradebook::rekeyFromWorkbooks() {
+    records.clear();
+    for (size_t t = 0; t < termNames.size(); ++t) {
+        contributions[t].clear();
+        addTerm(t, ExcelUtils::readStudentRows(termFilename(t)));
+    }
+    saveLedger();
+}
+
+void Gradebook::addContribution(const std::string& identity, const TermContribution& contribution) {
+    CumulativeRecord& record = records[identity];
+    record.credits += contribution.credits;
+    record.qualityPoints += contribution.gpa * contribution.credits;
+    record.terms++;
+}
+
+void Gradebook::removeContribution(const std::string& identity, const TermContribution& contribution) {
+    auto found = records.find(identity);
+    if (found == records.end()) return;
+
+    CumulativeRecord& record = found->second;
+    if (--record.terms == 0) {
+        records.erase(found);   // no rounding residue left behind
+        return;
+    }
+    record.credits -= contribution.credits;
+    record.qualityPoints -= contribution.gpa * contribution.credits;
+}
@@ -0,0 +1,143 @@
+#include "GroupBy.hpp"
+#include "GradeUtil.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+    const size_t MIN_ROWS_PER_TASK = 16384;
+
+    struct GroupAccumulator {
+        size_t count = 0;
+        size_t passing = 0;
+        double averageSum = 0.0;
+        vector<double> subjectSums;
+        vector<size_t> subjectCounts;   // students who took each subject
+
+        void add(const Student& student) {
+            double average = student.getAverageScore();
+            count++;
+            averageSum += average;
+            if (GradeUtil::isPassingGrade(average)) passing++;
+
+            // Absent scores are stored as 0.0, so only the counts need the mask
+            const auto& scores = student.getSubjectScores();
+            uint32_t mask = student.getScoreMask();
+            if (subjectSums.size() < scores.size()) {
+                subjectSums.resize(scores.size(), 0.0);
+                subjectCounts.resize(scores.size(), 0);
+            }
+            for (size_t s = 0; s < scores.size(); ++s) {
+                subjectSums[s] += scores[s];
+                subjectCounts[s] += (mask >> s) & 1u;
+            }
+        }
+
+        void merge(const GroupAccumulator& other) {
+            count += other.count;
+            passing += other.passing;
+            averageSum += other.averageSum;
+            if (subjectSums.size() < other.subjectSums.size()) {
+                subjectSums.resize(other.subjectSums.size(), 0.0);
+                subjectCounts.resize(other.subjectSums.size(), 0);
+            }
+            for (size_t s = 0; s < other.subjectSums.size(); ++s) {
+                subjectSums[s] += other.subjectSums[s];
+                subjectCounts[s] += other.subjectCounts[s];
+            }
+        }
+    };
+
+    using GroupTable = unordered_map<string, GroupAccumulator>;
+
+    // Numeric labels (age, year) order by value, everything else alphabetically
+    bool labelLess(const string& a, const string& b) {
+        bool numericA = !a.empty() && all_of(a.begin(), a.end(), [](unsigned char c) { return isdigit(c); });
+        bool numericB = !b.empty() && all_of(b.begin(), b.end(), [](unsigned char c) { return isdigit(c); });
+        if (numericA && numericB && a.size() != b.size()) return a.size() < b.size();
+        return a < b;
+    }
+}
+
+std::vector<GroupSummary> GroupBy::aggregate(const std::vector<Student>& students, GroupKey key) {
+    auto foldSlice = [&](size_t begin, size_t end) {
+        GroupTable table;
+        for (size_t i = begin; i < end; ++i) {
+            table[groupLabel(students[i], key)].add(students[i]);
+        }
+        return table;
+    };
+    auto mergeTables = [](GroupTable& merged, GroupTable& table) {
+        if (merged.empty()) {
+            merged.swap(table);
+            return;
+        }
+        for (const auto& entry : table) {
+            merged[entry.first].merge(entry.second);
+        }
+    };
+    GroupTable merged = TaskScheduler::shared().parallelReduce(students.size(), MIN_ROWS_PER_TASK, GroupTable(),
+                                                               foldSlice, mergeTables);
+
+    size_t subjectCount = GradeUtil::getSubjectNames().size();
+    vector<GroupSummary> summaries;
+    summaries.reserve(merged.size());
+    for (const auto& entry : merged) {
+        const GroupAccumulator& group = entry.second;
+        GroupSummary summary;
+        summary.label = entry.first;
+        summary.count = group.count;
+        summary.meanAverage = group.averageSum / group.count;
+        summary.passRate = 100.0 * static_cast<double>(group.passing) / group.count;
+        summary.subjectMeans.assign(subjectCount, 0.0);
+        for (size_t s = 0; s < subjectCount && s < group.subjectSums.size(); ++s) {
+            summary.subjectMeans[s] = group.subjectCounts[s] > 0 ? group.subjectSums[s] / group.subjectCounts[s] : 0.0;
+        }
+        summaries.push_back(summary);
+    }
+    sort(summaries.begin(), summaries.end(),
+        [](const GroupSummary& a, const GroupSummary& b) { return labelLess(a.label, b.label); });
+    return summaries;
+}
+
+std::string GroupBy::groupLabel(const Student& student, GroupKey key) {
+    switch (key) {
+        case GroupKey::Gender:
+            return student.getGender().empty() ? "Unknown" : student.getGender();
+        case GroupKey::Age:
+            return to_string(student.getAge());
+        case GroupKey::LetterGrade:
+            return student.getLetterGrade();
+        case GroupKey::ClassName:
+            return student.getClassName().empty() ? "Unassigned" : student.getClassName();
+        case GroupKey::BirthYear: {
+            // Dates are stored as YYYY-MM-DD
+            const string& dob = student.getDateOfBirth();
+            bool hasYear = dob.size() >= 4 &&
+                all_of(dob.begin(), dob.begin() + 4, [](unsigned char c) { return isdigit(c); });
+            return hasYear ? dob.substr(0, 4) : "Unknown";
+        }
+    }
+    return "";
+}
+
+std::string GroupBy::keyName(GroupKey key) {
+    switch (key) {
+        case GroupKey::Gender: return "Gender";
+        case GroupKey::Age: return "Age";
+        case GroupKey::LetterGrade: return "Letter Grade";
+        case GroupKey::ClassName: return "Class";
+        case GroupKey::BirthYear: return "Birth Year";
+    }
+    return "";
+}
+
+const std::vector<GroupKey>& GroupBy::allKeys() {
+    static const vector<GroupKey> keys = {
+        GroupKey::Gender, GroupKey::Age, GroupKey::LetterGrade, GroupKey::ClassName, GroupKey::BirthYear
+    };
+    return keys;
+}
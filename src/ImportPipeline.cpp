@@ -0,0 +1,274 @@
+#include "ImportPipeline.hpp"
+#include "ExcelUtil.hpp"
+#include "RosterExport.hpp"
+#include "TaskScheduler.hpp"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    using Clock = chrono::steady_clock;
+    using CredentialsMap = map<string, pair<string, string>>;
+
+    double millisecondsSince(Clock::time_point start) {
+        return chrono::duration<double, milli>(Clock::now() - start).count();
+    }
+
+    // A run of consecutive sheet rows; each stage fills in the next fields
+    struct ImportBatch {
+        size_t sequence = 0;                  // position in the sheet, for the index stage
+        string sheetTitle;
+        vector<SheetRow> rows;                // cleared once validated
+        vector<Student> students;
+        vector<size_t> sourceRows;            // index into rows of each student
+        vector<uint32_t> sheetRows;           // sheet row of each student, from validation on
+        vector<ImportRejection> rejected;
+        vector<ValidationIssue> issues;
+    };
+
+    enum Stage { XLSX_DECODE, ROW_DECODE, VALIDATE, INDEX, STAGE_COUNT };
+    const char* const STAGE_NAMES[STAGE_COUNT] = {"xlsx decode", "row decode", "validate", "index"};
+
+    // Busy time per stage, added to from every task
+    class StageClock {
+    public:
+        StageClock() {
+            for (int s = 0; s < STAGE_COUNT; ++s) {
+                timings[s].name = STAGE_NAMES[s];
+            }
+        }
+
+        void record(Stage stage, size_t batches, double busyMs) {
+            lock_guard<mutex> lock(timingMutex);
+            timings[stage].batches += batches;
+            timings[stage].busyMs += busyMs;
+        }
+
+        void setWorkers(Stage stage, size_t workers) {
+            timings[stage].workers = workers;
+        }
+
+        vector<ImportStageTiming> stageTimings() const {
+            return vector<ImportStageTiming>(timings.begin(), timings.end());
+        }
+
+    private:
+        array<ImportStageTiming, STAGE_COUNT> timings;
+        mutex timingMutex;
+    };
+
+    template <typename Work>
+    void timeStage(StageClock& clock, Stage stage, ImportBatch& batch, Work work) {
+        auto start = Clock::now();
+        work(batch);
+        clock.record(stage, 1, millisecondsSince(start));
+    }
+
+    void decodeRows(ImportBatch& batch) {
+        batch.students.reserve(batch.rows.size());
+        batch.sourceRows.reserve(batch.rows.size());
+        for (size_t r = 0; r < batch.rows.size(); ++r) {
+            try {
+                batch.students.push_back(ExcelUtils::decodeStudentRow(batch.rows[r], batch.sheetTitle));
+                batch.sourceRows.push_back(r);
+            } catch (const exception& e) {
+                batch.rejected.push_back({batch.rows[r].row, e.what()});
+            }
+        }
+    }
+
+    // A row without a name cannot be shown, searched or signed in to, so it
+    // is dropped; every other rule only flags the row in the report
+    void validateRows(ImportBatch& batch) {
+        size_t kept = 0;
+        batch.sheetRows.reserve(batch.students.size());
+        for (size_t i = 0; i < batch.students.size(); ++i) {
+            const SheetRow& source = batch.rows[batch.sourceRows[i]];
+            if (batch.students[i].getName().empty()) {
+                batch.rejected.push_back({source.row, "missing name"});
+                continue;
+            }
+            RosterValidator::checkStudent(batch.students[i], static_cast<uint32_t>(source.row), batch.issues, &source);
+            if (kept != i) batch.students[kept] = move(batch.students[i]);
+            batch.sheetRows.push_back(static_cast<uint32_t>(source.row));
+            kept++;
+        }
+        batch.students.erase(batch.students.begin() + kept, batch.students.end());
+        vector<size_t>().swap(batch.sourceRows);
+        vector<SheetRow>().swap(batch.rows);
+    }
+
+    // Appends finished batches in sheet order: attaches credentials and
+    // checks for duplicate IDs and emails across the whole roster
+    class RosterIndex {
+    public:
+        RosterIndex(ImportResult& result, const CredentialsMap& credentials)
+            : result(result), credentials(credentials) {}
+
+        void add(ImportBatch&& batch) {
+            size_t sequence = batch.sequence;
+            waiting.emplace(sequence, move(batch));
+        }
+
+        // Returns the number of batches appended
+        size_t appendReady() {
+            size_t appended = 0;
+            for (auto next = waiting.find(nextSequence); next != waiting.end(); next = waiting.find(nextSequence)) {
+                append(next->second);
+                waiting.erase(next);
+                nextSequence++;
+                appended++;
+            }
+            return appended;
+        }
+
+    private:
+        ImportResult& result;
+        const CredentialsMap& credentials;
+        map<size_t, ImportBatch> waiting;     // finished out of order
+        size_t nextSequence = 0;
+        DuplicateTracker duplicates;
+
+        void append(ImportBatch& batch) {
+            auto& issues = result.validation.issues;
+            issues.insert(issues.end(), batch.issues.begin(), batch.issues.end());
+            for (size_t i = 0; i < batch.students.size(); ++i) {
+                Student& student = batch.students[i];
+                auto credential = credentials.find(student.getStudentId());
+                if (credential != credentials.end()) {
+                    student.setUsername(credential->second.first);
+                    student.setPassword(credential->second.second);
+                }
+                duplicates.check(student, batch.sheetRows[i], issues);
+                result.students.push_back(move(student));
+            }
+            result.sheetRows.insert(result.sheetRows.end(), batch.sheetRows.begin(), batch.sheetRows.end());
+            result.rejected.insert(result.rejected.end(), batch.rejected.begin(), batch.rejected.end());
+        }
+    };
+}
+
+const ImportStageTiming& ImportResult::slowestStage() const {
+    static const ImportStageTiming none;
+    const ImportStageTiming* slowest = &none;
+    for (const auto& stage : stages) {
+        double perWorker = stage.busyMs / max<size_t>(1, stage.workers);
+        if (perWorker > slowest->busyMs / max<size_t>(1, slowest->workers)) slowest = &stage;
+    }
+    return *slowest;
+}
+
+ImportResult ImportPipeline::run(const ImportOptions& options) {
+    auto started = Clock::now();
+    TaskScheduler& scheduler = TaskScheduler::shared();
+    size_t workers = min(options.workers > 0 ? options.workers : scheduler.threadCount(), scheduler.threadCount());
+    size_t batchRows = max<size_t>(1, options.batchRows);
+
+    // Credentials come from a second workbook, read before the roster so
+    // only one xlnt reader is open at a time
+    CredentialsMap credentials;
+    if (!options.credentialsFile.empty()) ExcelUtils::loadCredentialsFromFile(options.credentialsFile, credentials);
+
+    ImportResult result;
+    RosterIndex index(result, credentials);
+    StageClock clock;
+    clock.setWorkers(XLSX_DECODE, 1);
+    clock.setWorkers(ROW_DECODE, workers);
+    clock.setWorkers(VALIDATE, workers);
+    clock.setWorkers(INDEX, 1);
+
+    mutex finishedMutex;
+    vector<ImportBatch> finished;
+    size_t indexBatches = 0;
+    double indexMs = 0.0;
+    auto indexFinished = [&] {
+        vector<ImportBatch> ready;
+        {
+            lock_guard<mutex> lock(finishedMutex);
+            ready.swap(finished);
+        }
+        if (ready.empty()) return;
+        auto start = Clock::now();
+        for (auto& batch : ready) index.add(move(batch));
+        indexBatches += index.appendReady();
+        indexMs += millisecondsSince(start);
+    };
+
+    // Declared after everything its tasks touch, so it is destroyed (and
+    // waits for them) first if the stream throws
+    CancellationToken failed;
+    TaskGroup group(scheduler, &failed);
+    size_t xlsxBatches = 0;
+    double xlsxMs = 0.0;
+    size_t sequence = 0;
+    auto start = Clock::now();
+    ExcelUtils::streamSheetRows(options.filename, batchRows,
+        [&](vector<SheetRow>&& rows, const string& sheetTitle) {
+            xlsxMs += millisecondsSince(start);
+            xlsxBatches++;
+            auto batch = make_shared<ImportBatch>();
+            batch->sequence = sequence++;
+            batch->sheetTitle = sheetTitle;
+            batch->rows = move(rows);
+
+            // Each batch goes through the middle stages as one scheduler task
+            group.run([&, batch] {
+                try {
+                    timeStage(clock, ROW_DECODE, *batch, decodeRows);
+                    timeStage(clock, VALIDATE, *batch, validateRows);
+                } catch (...) {
+                    failed.cancel();
+                    throw;
+                }
+                lock_guard<mutex> lock(finishedMutex);
+                finished.push_back(move(*batch));
+            });
+
+            // Bounded memory: at most workers + queueDepth batches in flight
+            group.waitBelow(workers + options.queueDepth);
+            indexFinished();
+            start = Clock::now();
+            return !failed.isCancelled();
+        });
+    xlsxMs += millisecondsSince(start);
+
+    group.wait();
+    indexFinished();
+    clock.record(XLSX_DECODE, xlsxBatches, xlsxMs);
+    clock.record(INDEX, indexBatches, indexMs);
+
+    result.stages = clock.stageTimings();
+    result.validation.rowsChecked = result.students.size();
+    result.validation.elapsedMs = result.stages[VALIDATE].busyMs + result.stages[INDEX].busyMs;
+    RosterValidator::finish(result.validation);
+    result.wallMs = millisecondsSince(started);
+    return result;
+}
+
+void ImportPipeline::persist(const std::vector<Student>& students,
+                             const std::string& rosterFile, const std::string& credentialsFile) {
+    // Two workbooks from one formatting pass, written one after another on
+    // this thread like every xlsx file RosterExport writes
+    ExportTargets targets;
+    targets.workbook = rosterFile;
+    targets.credentials = credentialsFile;
+    for (const auto& result : RosterExport::run(students, targets)) {
+        if (!result.error.empty()) throw runtime_error("Cannot write " + result.filename + ": " + result.error);
+    }
+}
+
+std::string ImportPipeline::summary(const ImportResult& result) {
+    const ImportStageTiming& slowest = result.slowestStage();
+    char text[160];
+    snprintf(text, sizeof(text), "%zu rows in %.0f ms; slowest stage: %s (%.0f ms across %zu worker%s)",
+             result.students.size() + result.rejected.size(), result.wallMs,
+             slowest.name.empty() ? "none" : slowest.name.c_str(), slowest.busyMs,
+             slowest.workers, slowest.workers == 1 ? "" : "s");
+    return text;
+}
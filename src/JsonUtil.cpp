@@ -0,0 +1,247 @@
+#include "JsonUtil.hpp"
+#include "GradeStats.hpp"
+#include "GradeUtil.hpp"
+#include "RosterValidator.hpp"
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    void skipSpace(const string& text, size_t& pos) {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+            pos++;
+        }
+    }
+
+    void appendUtf8(string& out, unsigned codePoint) {
+        if (codePoint < 0x80) {
+            out += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    string parseString(const string& text, size_t& pos) {
+        if (pos >= text.size() || text[pos] != '"') throw invalid_argument("expected a string");
+        string out;
+        for (++pos; pos < text.size() && text[pos] != '"'; ++pos) {
+            char c = text[pos];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (++pos >= text.size()) break;
+            switch (text[pos]) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    if (pos + 4 >= text.size()) throw invalid_argument("bad \\u escape");
+                    appendUtf8(out, static_cast<unsigned>(stoul(text.substr(pos + 1, 4), nullptr, 16)));
+                    pos += 4;
+                    break;
+                }
+                default: throw invalid_argument("bad escape");
+            }
+        }
+        if (pos >= text.size()) throw invalid_argument("unterminated string");
+        ++pos;
+        return out;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// JsonObject
+// ---------------------------------------------------------------------------
+
+JsonObject& JsonObject::add(const std::string& key, const std::string& value) { return raw(key, JsonUtil::quote(value)); }
+JsonObject& JsonObject::add(const std::string& key, const char* value) { return raw(key, JsonUtil::quote(value)); }
+JsonObject& JsonObject::add(const std::string& key, double value) { return raw(key, JsonUtil::number(value)); }
+JsonObject& JsonObject::add(const std::string& key, size_t value) { return raw(key, to_string(value)); }
+JsonObject& JsonObject::add(const std::string& key, int value) { return raw(key, to_string(value)); }
+JsonObject& JsonObject::add(const std::string& key, bool value) { return raw(key, value ? "true" : "false"); }
+
+JsonObject& JsonObject::raw(const std::string& key, const std::string& json) {
+    if (!body.empty()) body += ',';
+    body += JsonUtil::quote(key);
+    body += ':';
+    body += json;
+    return *this;
+}
+
+std::string JsonObject::str() const {
+    return "{" + body + "}";
+}
+
+// ---------------------------------------------------------------------------
+// JsonUtil
+// ---------------------------------------------------------------------------
+
+std::string JsonUtil::quote(const std::string& value) {
+    string out = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out + "\"";
+}
+
+std::string JsonUtil::number(double value) {
+    if (!isfinite(value)) return "null";
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.10g", value);
+    return buffer;
+}
+
+std::string JsonUtil::array(const std::vector<std::string>& items) {
+    string out = "[";
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (i > 0) out += ",";
+        out += items[i];
+    }
+    return out + "]";
+}
+
+std::map<std::string, std::string> JsonUtil::parseObject(const std::string& text) {
+    map<string, string> fields;
+    size_t pos = 0;
+    skipSpace(text, pos);
+    if (pos >= text.size() || text[pos] != '{') throw invalid_argument("expected a JSON object");
+    ++pos;
+    skipSpace(text, pos);
+    if (pos < text.size() && text[pos] == '}') {
+        ++pos;
+    } else {
+        while (true) {
+            skipSpace(text, pos);
+            string key = parseString(text, pos);
+            skipSpace(text, pos);
+            if (pos >= text.size() || text[pos] != ':') throw invalid_argument("expected ':'");
+            ++pos;
+            skipSpace(text, pos);
+            if (pos < text.size() && text[pos] == '"') {
+                fields[key] = parseString(text, pos);
+            } else {
+                size_t start = pos;
+                while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && !isspace(static_cast<unsigned char>(text[pos]))) {
+                    if (text[pos] == '{' || text[pos] == '[') throw invalid_argument("nested values are not supported");
+                    ++pos;
+                }
+                if (pos == start) throw invalid_argument("expected a value");
+                fields[key] = text.substr(start, pos - start);
+            }
+            skipSpace(text, pos);
+            if (pos < text.size() && text[pos] == ',') {
+                ++pos;
+                continue;
+            }
+            if (pos < text.size() && text[pos] == '}') {
+                ++pos;
+                break;
+            }
+            throw invalid_argument("expected ',' or '}'");
+        }
+    }
+    skipSpace(text, pos);
+    if (pos != text.size()) throw invalid_argument("trailing characters after the object");
+    return fields;
+}
+
+std::string JsonUtil::student(const Student& student) {
+    auto subjects = GradeUtil::getSubjectNames();
+    const auto& scores = student.getSubjectScores();
+    JsonObject scoreFields;
+    for (size_t i = 0; i < subjects.size(); ++i) {
+        // Subjects not taken are null rather than 0
+        scoreFields.raw(subjects[i], i < scores.size() && student.hasScore(i) ? number(scores[i]) : "null");
+    }
+
+    JsonObject json;
+    json.add("studentId", student.getStudentId()).add("name", student.getName());
+    json.add("className", student.getClassName()).add("age", student.getAge()).add("gender", student.getGender());
+    json.raw("scores", scoreFields.str());
+    json.add("average", student.getAverageScore()).add("letterGrade", student.getLetterGrade());
+    json.add("gpa", student.getGpa()).add("remark", student.getRemark());
+    json.add("cumulativeGpa", student.getCumulativeGpa()).add("cumulativeCredits", student.getCumulativeCredits());
+    return json.str();
+}
+
+std::string JsonUtil::rosterStatistics(const std::vector<Student>& students) {
+    double averageSum = 0.0;
+    size_t passing = 0;
+    std::array<size_t, GradeScale::GRADE_COUNT> grades{};
+    GradeScale scale = GradeScale::current();
+    for (const auto& student : students) {
+        averageSum += student.getAverageScore();
+        passing += student.hasPassingGrade();
+        grades[scale.gradeIndex(student.getAverageScore())]++;
+    }
+
+    vector<string> subjects;
+    for (const auto& stats : GradeStats::computeSubjectStatistics(students)) {
+        subjects.push_back(JsonObject()
+            .add("name", stats.subjectName).add("count", stats.count)
+            .add("mean", stats.mean).add("stdDev", stats.standardDeviation)
+            .add("min", stats.minimum).add("q1", stats.firstQuartile).add("median", stats.median)
+            .add("q3", stats.thirdQuartile).add("max", stats.maximum).str());
+    }
+
+    double n = students.empty() ? 1.0 : static_cast<double>(students.size());
+    JsonObject json;
+    json.add("students", students.size()).add("meanAverage", averageSum / n).add("passRate", 100.0 * passing / n);
+    json.raw("grades", gradeCounts(grades)).raw("subjects", array(subjects));
+    return json.str();
+}
+
+std::string JsonUtil::validationReport(const ValidationReport& report, size_t maxIssues) {
+    JsonObject byRule;
+    for (size_t r = 0; r < ValidationReport::RULE_COUNT; ++r) {
+        byRule.add(RosterValidator::ruleName(static_cast<ValidationRule>(r)), report.countByRule[r]);
+    }
+    vector<string> issues;
+    for (size_t i = 0; i < report.issues.size() && i < maxIssues; ++i) {
+        const auto& issue = report.issues[i];
+        issues.push_back(JsonObject().add("row", static_cast<size_t>(issue.row))
+            .add("column", RosterValidator::columnName(issue)).add("rule", RosterValidator::ruleName(issue.rule)).str());
+    }
+
+    JsonObject json;
+    json.add("rowsChecked", report.rowsChecked).add("rowsWithIssues", report.rowsWithIssues());
+    json.add("issueCount", report.issues.size()).add("elapsedMs", report.elapsedMs);
+    json.raw("byRule", byRule.str()).raw("issues", array(issues));
+    return json.str();
+}
+
+std::string JsonUtil::gradeCounts(const std::array<size_t, GradeScale::GRADE_COUNT>& counts) {
+    JsonObject json;
+    for (int g = 0; g < GradeScale::GRADE_COUNT; ++g) {
+        json.add(GradeScale::gradeLetter(g), counts[g]);
+    }
+    return json.str();
+}
@@ -1,13 +1,32 @@
 #include "MenuUtils.hpp"
 #include "GradeUtil.hpp"
 #include "ExcelUtil.hpp"
+#include "GradeStats.hpp"
+#include "GroupBy.hpp"
+#include "RegradeSimulator.hpp"
+#include "ScoreAnalysis.hpp"
+#include "QuantileSketch.hpp"
+#include "TrendStore.hpp"
+#include "Gradebook.hpp"
+#include "RosterValidator.hpp"
+#include "Screen.hpp"
+#include "TablePager.hpp"
+#include "TableRenderer.hpp"
 #include <tabulate/table.hpp>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <cmath>
 #include <iomanip>
+#include <sstream>
+#include <ctime>
+#include <cstdlib>
 #include <limits>
+#include <mutex>
 #ifdef _WIN32
     #include <windows.h>
     #include <conio.h>
+    #include <io.h>
 #else
     #include <termios.h>
     #include <unistd.h>
@@ -27,6 +46,41 @@ const std::string MenuUtils::CYAN = "\033[36m";
 const std::string MenuUtils::WHITE = "\033[37m";
 const std::string MenuUtils::BOLD = "\033[1m";
 
+bool MenuUtils::headless = false;
+
+namespace {
+    enum class MessageKind { Success, Error, Warning, Info };
+
+    thread_local bool deferredOutput = false;
+    std::mutex deferredMutex;
+    std::vector<std::pair<MessageKind, std::string>> deferredMessages;
+
+    bool deferMessage(MessageKind kind, const std::string& message) {
+        if (!deferredOutput) return false;
+        std::lock_guard<std::mutex> lock(deferredMutex);
+        deferredMessages.emplace_back(kind, message);
+        return true;
+    }
+
+    // A terminal sees each message as it is printed; a pipe or file keeps
+    // the stream's buffering instead of flushing line by line
+    void endMessage() {
+        if (MenuUtils::isTerminalOutput()) cout.flush();
+    }
+
+    const int LOADING_BAR_CELLS = 36;
+    const int LOADING_TICK_MS = 60;
+    const int WELCOME_TICK_MS = 250;
+    const int WELCOME_WAIT_LIMIT_MS = 1500;   // then the main menu comes up and loading carries on
+    const int THANK_YOU_TICK_MS = 300;
+
+    // Waits up to ms for work; true once it has finished, or if there is none
+    bool waitForWork(const std::shared_future<void>& work, int ms) {
+        if (!work.valid()) return true;
+        return work.wait_for(std::chrono::milliseconds(ms)) == std::future_status::ready;
+    }
+}
+
 
 Color MenuUtils::getGradeColor(const std::string& grade) {
     if (grade == "A" || grade == "B" || grade == "C") {
@@ -41,8 +95,13 @@ Color MenuUtils::getGradeColor(const std::string& grade) {
     return Color::white;        // Default
 }
 
-// Enhanced loading animation
-void MenuUtils::showLoadingAnimation(const std::string& message, int duration) {
+// Enhanced loading animation: the bar fills while the work runs, stops one
+// cell short if it is still running, and completes the moment it finishes
+void MenuUtils::showLoadingAnimation(const std::string& message, const std::shared_future<void>& work) {
+    if (headless) {
+        if (work.valid()) work.wait();
+        return;
+    }
     clearScreen();
     
     // Center the loading message vertically
@@ -53,34 +112,31 @@ void MenuUtils::showLoadingAnimation(const std::string& message, int duration) {
     cout << string(25, ' ') << "Loading: [";
     
     // Progress bar animation
-    for (int i = 0; i <= 35; i++) {
-        if (i <= 35) {
-            cout << GREEN << "█" << RESET;
-        }
+    int cells = 0;
+    bool done = waitForWork(work, 0);
+    while (!done && cells < LOADING_BAR_CELLS - 1) {
+        cout << GREEN << "█" << RESET;
         cout.flush();
-        
-        #ifdef _WIN32
-            Sleep(duration / 35);
-        #else
-            usleep((duration * 1000) / 20);
-        #endif
+        cells++;
+        done = waitForWork(work, LOADING_TICK_MS);
+    }
+    if (!done) work.wait();
+    for (; cells < LOADING_BAR_CELLS; cells++) {
+        cout << GREEN << "█" << RESET;
     }
     
     cout << "] " << GREEN << "100%" << RESET << endl;
-    
-    // Success message
+}
+
+// Shown under the loading bar once a login has actually been checked
+void MenuUtils::printLoginSuccess() {
+    if (headless) return;
     cout << endl << string(25, ' ') << GREEN << "✅ Login Successful! ✅" << RESET << endl;
-    
-    #ifdef _WIN32
-        Sleep(1500);
-    #else
-        usleep(1500000);
-    #endif
 }
 
 // Enhanced Welcome with USER PORTAL style
-void MenuUtils::printWelcome() {
-    system("cls");
+void MenuUtils::printWelcome(const std::shared_future<void>& loading) {
+    clearScreen();
     cout << string(10, '\n'); // Top spacing to center vertically
     
     
@@ -95,47 +151,34 @@ void MenuUtils::printWelcome() {
     cout << "        "; // Adjust spacing as needed
     
     cout << "\033[94m"; // Blue color
-    for (int i = 0; i < text.length(); i++) {
-        if (text[i] == '\n') {
-            cout << text[i];
-            cout << "        "; // Add spacing for next line
-        } else {
-            cout << text[i];
-            cout.flush();
-        }
+    string banner;
+    banner.reserve(text.length() + 64);
+    for (char c : text) {
+        banner += c;
+        if (c == '\n') banner += "        "; // Add spacing for next line
     }
+    cout << banner;
     cout << "\033[0m" << endl;
     cout << endl;
 
-    // Centered loading animation
+    // Centered loading animation: a dot per tick while the roster loads,
+    // for at most WELCOME_WAIT_LIMIT_MS; menus that need the data wait for
+    // the rest themselves
     cout << "                                               "; 
     cout << RED << "Loading";
+    cout.flush();
     
-    for (int i = 0; i < 3; i++) {
-        #ifdef _WIN32
-            Sleep(400);  // Windows Sleep function (milliseconds)
-        #else
-            system("sleep 1");
-        #endif
+    int waited = 0;
+    bool loaded = waitForWork(loading, 0);
+    while (!loaded && waited < WELCOME_WAIT_LIMIT_MS) {
         cout << ".";
         cout.flush();
+        loaded = waitForWork(loading, WELCOME_TICK_MS);
+        waited += WELCOME_TICK_MS;
     }
-    cout << RESET << endl;
-
-    // Wait for 2 seconds
-    #ifdef _WIN32
-        Sleep(2000);
-    #else
-        system("sleep 2");
-    #endif
+    cout << (loaded ? " done" : " continuing in the background") << RESET << endl;
 
-    #ifdef _WIN32
-        Sleep(2000);
-    #else
-        usleep(2000);
-    #endif
-
-    system("cls");
+    clearScreen();
 
     cout << GREEN << endl;
     cout << "                            #############################################################################" << endl;
@@ -147,32 +190,10 @@ void MenuUtils::printWelcome() {
     cout << "                            #############################################################################" << endl;
     cout << RESET << endl;
 
-    // Small delay before developer credit
-    #ifdef _WIN32
-        Sleep(1000);
-    #else
-        usleep(1000000);
-    #endif
-
     cout << YELLOW << "                                           ";
-    string developer = "Developed by ISTAD Pre-Gen4 GroupI";
-    for (int i = 0; i < developer.length(); i++) {
-        cout << developer[i];
-        cout.flush();
-        #ifdef _WIN32
-            Sleep(40);
-        #else
-            usleep(40000);
-        #endif
-    }
+    cout << "Developed by ISTAD Pre-Gen4 GroupI";
     cout << RESET << endl;
     cout << endl;
-
-    #ifdef _WIN32
-        Sleep(2000);
-    #else
-        usleep(2000000);
-    #endif
 }
 
 // Enhanced Main Menu with cyberpunk/sci-fi aesthetic
@@ -301,8 +322,22 @@ void MenuUtils::printAdminMenu() {
     
     cout << string(centerOffset, ' ') << CYAN << "├─────┼──────────────────────────────────────────────────────────┤" << RESET << endl;
     
-    // Option 5 - Sign Out
+    // Option 5 - Analytics & Reports
     cout << string(centerOffset, ' ') << CYAN << "│ " << YELLOW << "5" << RESET << "   " << CYAN << "│ " << RESET;
+    cout << CYAN << "📊" << RESET << " " << CYAN << "Analytics & Reports" << RESET;
+    cout << string(35, ' ') << CYAN << "│" << RESET << endl;
+    
+    cout << string(centerOffset, ' ') << CYAN << "├─────┼──────────────────────────────────────────────────────────┤" << RESET << endl;
+    
+    // Option 6 - Terms & Transcripts
+    cout << string(centerOffset, ' ') << CYAN << "│ " << YELLOW << "6" << RESET << "   " << CYAN << "│ " << RESET;
+    cout << BLUE << "🎓" << RESET << " " << BLUE << "Terms & Transcripts" << RESET;
+    cout << string(35, ' ') << CYAN << "│" << RESET << endl;
+    
+    cout << string(centerOffset, ' ') << CYAN << "├─────┼──────────────────────────────────────────────────────────┤" << RESET << endl;
+    
+    // Option 7 - Sign Out
+    cout << string(centerOffset, ' ') << CYAN << "│ " << YELLOW << "7" << RESET << "   " << CYAN << "│ " << RESET;
     cout << RED << "🚪" << RESET << " " << RED << "Sign Out" << RESET;
     cout << string(46, ' ') << CYAN << "│" << RESET << endl;
     
@@ -349,7 +384,7 @@ void MenuUtils::printStudentMenu() {
 }
 
 // Enhanced Thank You Message
-void MenuUtils::printThankYou() {
+void MenuUtils::printThankYou(const std::shared_future<void>& saving) {
     clearScreen();
     cout << string(5, '\n');
     
@@ -368,68 +403,57 @@ void MenuUtils::printThankYou() {
     cout << "                                 " << MAGENTA << "Developed by ISTAD Pre-Gen4 GroupI" << RESET << endl;
     cout << endl;
     
-    // Animation
+    // Animation: a star per tick while the data is saved
     cout << "                                          ";
+    bool saved = waitForWork(saving, 0);
     for (int i = 0; i < 5; i++) {
         cout << GREEN << "★ " << RESET;
         cout.flush();
-        #ifdef _WIN32
-            Sleep(300);
-        #else
-            usleep(300000);
-        #endif
+        if (!saved) saved = waitForWork(saving, THANK_YOU_TICK_MS);
     }
+    if (!saved) saving.wait();
     cout << endl;
     
     cout << "                                    " << GREEN << "Have a wonderful day! 👋" << RESET << endl;
     cout << endl;
-    
-    #ifdef _WIN32
-        Sleep(3000);
-    #else
-        usleep(3000000);
-    #endif
 }
 
 
 // Display methods
 void MenuUtils::displayTable(const std::vector<Student>& students) {
-    if (students.empty()) {
+    std::vector<std::uint32_t> rows(students.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        rows[i] = static_cast<std::uint32_t>(i);
+    }
+    displayTable(students, rows);
+}
+
+// Display the given rows of the roster, in the given order, without copying students
+void MenuUtils::displayTable(const std::vector<Student>& students, const std::vector<std::uint32_t>& rows) {
+    if (rows.empty()) {
         printWarning("No students to display!");
         return;
     }
     
-    Table table;
-    table.add_row({"ID", "Name", "Age", "Gender", "Email", "Average", "Grade", "GPA", "Remark"});
-    
-    for (const auto& student : students) {
-        table.add_row({
-            student.getStudentId(),
-            student.getName(),
-            to_string(student.getAge()),
-            student.getGender(),
-            student.getEmail(),
-            to_string(static_cast<int>(student.getAverageScore() * 100) / 100.0),
-            student.getLetterGrade(),
-            to_string(student.getGpa()),
-            student.getRemark()
-        });
-    }
-    
-    table[0].format().font_style({FontStyle::bold}).font_color(Color::cyan);
-    for (size_t i = 1; i < table.size(); ++i) {
-        std::string grade = students[i-1].getLetterGrade();
-        std::string remark = students[i-1].getRemark();
-        Color gradeColor = getGradeColor(grade);
-        table[i].format().font_color(gradeColor);
-        if (remark == "Fail") {
-            table[i].format().font_style({FontStyle::bold});
-        }
+    // Rosters longer than a screen open in the pager; pipes and batch runs
+    // still get every row
+    if (isInteractive() && rows.size() > TablePager::rowsPerPage()) {
+        TablePager(students, rows).run();
+        return;
     }
     
-    cout << table << endl;
-    // Display color legend
-    printColorLegend();
+    // The table and legend go out as one write and one flush
+    string screen = formatTable(students, rows, 0, rows.size());
+    screen += '\n';
+    screen += colorLegend();
+    cout.write(screen.data(), static_cast<streamsize>(screen.size()));
+    cout.flush();
+}
+
+std::string MenuUtils::formatTable(const std::vector<Student>& students, const std::vector<std::uint32_t>& rows,
+                                   size_t begin, size_t end) {
+    // Student tables can run to 100k rows, so they skip tabulate
+    return TableRenderer::renderStudents(students, rows, begin, end, isTerminalOutput());
 }
 
 void MenuUtils::displayStudentDetails(const Student& student) {
@@ -448,12 +472,16 @@ void MenuUtils::displayStudentDetails(const Student& student) {
     auto scores = student.getSubjectScores();
     
     for (size_t i = 0; i < subjects.size() && i < scores.size(); ++i) {
-        table.add_row({subjects[i], to_string(scores[i])});
+        table.add_row({subjects[i], student.hasScore(i) ? to_string(scores[i]) : "Not taken"});
     }
     
     table.add_row({"Average Score", to_string(student.getAverageScore())});
     table.add_row({"Letter Grade", student.getLetterGrade()});
     table.add_row({"GPA", to_string(student.getGpa())});
+    if (student.getCumulativeCredits() > 0.0) {
+        table.add_row({"Cumulative GPA", to_string(student.getCumulativeGpa()) + " (" +
+                       GradeStats::formatValue(student.getCumulativeCredits()) + " credits, closed terms)"});
+    }
     table.add_row({"Remark", student.getRemark()});
     table.add_row({"Last Updated", student.getFormattedTimestamp()});
     
@@ -555,28 +583,398 @@ void MenuUtils::displayGradeReport(const std::vector<Student>& students) {
     }
     
     cout << summaryTable << endl;
-    
+
+    displaySubjectStatistics(GradeStats::computeSubjectStatistics(students));
+
     printSeparator();
     displayTable(students);
 }
 
-void MenuUtils::displayFailingStudents(const std::vector<Student>& students) {
-    if (students.empty()) {
+void MenuUtils::displaySubjectStatistics(const std::vector<SubjectStatistics>& statistics) {
+    printHeader("SUBJECT STATISTICS");
+
+    Table statsTable;
+    statsTable.add_row({"Subject", "Count", "Mean", "Std Dev", "Min", "Q1", "Median", "Q3", "Max"});
+    for (const auto& stats : statistics) {
+        statsTable.add_row({
+            stats.subjectName,
+            to_string(stats.count),
+            GradeStats::formatValue(stats.mean),
+            GradeStats::formatValue(stats.standardDeviation),
+            GradeStats::formatValue(stats.minimum),
+            GradeStats::formatValue(stats.firstQuartile),
+            GradeStats::formatValue(stats.median),
+            GradeStats::formatValue(stats.thirdQuartile),
+            GradeStats::formatValue(stats.maximum)
+        });
+    }
+    statsTable[0].format().font_style({FontStyle::bold}).font_color(Color::magenta);
+    cout << statsTable << endl;
+
+    // Deciles
+    Table decileTable;
+    Table::Row_t decileHeader = {"Subject"};
+    for (int d = 1; d <= 9; ++d) {
+        decileHeader.push_back("P" + to_string(d * 10));
+    }
+    decileTable.add_row(decileHeader);
+    for (const auto& stats : statistics) {
+        Table::Row_t row = {stats.subjectName};
+        for (double decile : stats.deciles) {
+            row.push_back(GradeStats::formatValue(decile));
+        }
+        decileTable.add_row(row);
+    }
+    decileTable[0].format().font_style({FontStyle::bold}).font_color(Color::cyan);
+    cout << decileTable << endl;
+
+    // Histogram (student counts per 10-point bin)
+    Table histogramTable;
+    Table::Row_t histogramHeader = {"Subject"};
+    for (size_t bin = 0; bin < GradeStats::HISTOGRAM_BINS; ++bin) {
+        histogramHeader.push_back(GradeStats::histogramBinLabel(bin));
+    }
+    histogramTable.add_row(histogramHeader);
+    for (const auto& stats : statistics) {
+        Table::Row_t row = {stats.subjectName};
+        for (size_t count : stats.histogram) {
+            row.push_back(to_string(count));
+        }
+        histogramTable.add_row(row);
+    }
+    for (size_t bin = 0; bin < GradeStats::HISTOGRAM_BINS; ++bin) {
+        // Bins below the pass mark in red
+        if ((bin + 1) * GradeStats::HISTOGRAM_BIN_WIDTH <= GradeUtil::PASSING_THRESHOLD) {
+            histogramTable.column(bin + 1).format().font_color(Color::red);
+        }
+    }
+    histogramTable[0].format().font_style({FontStyle::bold}).font_color(Color::cyan);
+    cout << histogramTable << endl;
+}
+
+void MenuUtils::displayArchivePercentiles(const ScoreSketches& archive, size_t snapshotCount) {
+    printInfo("Merged sketches from " + to_string(snapshotCount) + " backup snapshot(s)");
+    
+    const double quantiles[] = {0.10, 0.25, 0.50, 0.75, 0.90};
+    Table table;
+    table.add_row({"Column", "Scores", "Min", "P10", "P25", "Median", "P75", "P90", "Max"});
+    for (size_t i = 0; i < archive.columnNames.size(); ++i) {
+        const auto& sketch = archive.sketches[i];
+        Table::Row_t row = {archive.columnNames[i], to_string(sketch.count()), GradeStats::formatValue(sketch.minimum())};
+        for (double q : quantiles) {
+            row.push_back(GradeStats::formatValue(sketch.quantile(q)));
+        }
+        row.push_back(GradeStats::formatValue(sketch.maximum()));
+        table.add_row(row);
+    }
+    table[0].format().font_style({FontStyle::bold}).font_color(Color::magenta);
+    cout << table << endl;
+    
+    if (!archive.sketches.empty()) {
+        printInfo("Rank error bound: ±" + GradeStats::formatValue(archive.sketches[0].rankErrorBound() * 100.0) + " percentile points");
+    }
+}
+
+void MenuUtils::displayGroupSummaries(const std::vector<GroupSummary>& groups, GroupKey key) {
+    printHeader("BREAKDOWN BY " + GroupBy::keyName(key));
+    if (groups.empty()) {
+        printWarning("No students to group!");
+        return;
+    }
+
+    auto subjects = GradeUtil::getSubjectNames();
+    Table table;
+    Table::Row_t header = {GroupBy::keyName(key), "Count", "Mean Avg", "Pass Rate"};
+    header.insert(header.end(), subjects.begin(), subjects.end());
+    table.add_row(header);
+
+    for (const auto& group : groups) {
+        Table::Row_t row = {
+            group.label,
+            to_string(group.count),
+            GradeStats::formatValue(group.meanAverage),
+            GradeStats::formatValue(group.passRate) + "%"
+        };
+        for (double mean : group.subjectMeans) {
+            row.push_back(GradeStats::formatValue(mean));
+        }
+        table.add_row(row);
+    }
+    table[0].format().font_style({FontStyle::bold}).font_color(Color::cyan);
+    cout << table << endl;
+}
+
+void MenuUtils::displayRegradeOutcome(const std::vector<Student>& students, const RegradeOutcome& outcome,
+                                      const GradeScale& scale, const Curve& curve) {
+    printHeader("WHAT-IF REGRADING");
+    string boundaries;
+    for (size_t i = 0; i < scale.thresholds.size(); ++i) {
+        boundaries += (i ? ", " : "") + GradeScale::gradeLetter(static_cast<int>(i)) + " >= " +
+                      GradeStats::formatValue(scale.thresholds[i]);
+    }
+    printInfo("Scale: " + boundaries);
+    printInfo("Curve: " + curve.describe());
+    printInfo("Simulation only - no student records were changed.");
+
+    // Distribution shift
+    Table distribution;
+    distribution.add_row({"Grade", "Current", "Simulated", "Change"});
+    for (int g = 0; g < GradeScale::GRADE_COUNT; ++g) {
+        long long delta = static_cast<long long>(outcome.simulatedCounts[g]) - static_cast<long long>(outcome.currentCounts[g]);
+        distribution.add_row({
+            GradeScale::gradeLetter(g),
+            to_string(outcome.currentCounts[g]),
+            to_string(outcome.simulatedCounts[g]),
+            (delta > 0 ? "+" : "") + to_string(delta)
+        });
+    }
+    distribution.add_row({
+        "Mean",
+        GradeStats::formatValue(outcome.currentMean),
+        GradeStats::formatValue(outcome.simulatedMean),
+        GradeStats::formatValue(outcome.simulatedMean - outcome.currentMean)
+    });
+    distribution.add_row({
+        "Pass Rate",
+        GradeStats::formatValue(outcome.currentPassRate) + "%",
+        GradeStats::formatValue(outcome.simulatedPassRate) + "%",
+        GradeStats::formatValue(outcome.simulatedPassRate - outcome.currentPassRate) + " pts"
+    });
+    distribution[0].format().font_style({FontStyle::bold}).font_color(Color::cyan);
+    cout << distribution << endl;
+
+    if (outcome.changes.empty()) {
+        printSuccess("No student would change letter grade.");
+        return;
+    }
+    printInfo(to_string(outcome.changes.size()) + " students change grade (" + to_string(outcome.promoted) +
+              " up, " + to_string(outcome.demoted) + " down):");
+
+    const size_t shown = min<size_t>(outcome.changes.size(), 25);
+    Table changes;
+    changes.add_row({"Student ID", "Name", "Average", "New Average", "Grade", "New Grade"});
+    for (size_t i = 0; i < shown; ++i) {
+        const auto& change = outcome.changes[i];
+        const Student& student = students[change.row];
+        changes.add_row({
+            student.getStudentId(),
+            student.getName(),
+            GradeStats::formatValue(change.oldAverage),
+            GradeStats::formatValue(change.newAverage),
+            GradeScale::gradeLetter(change.oldGrade),
+            GradeScale::gradeLetter(change.newGrade)
+        });
+        changes[i + 1][5].format().font_color(change.newGrade < change.oldGrade ? Color::green : Color::red);
+    }
+    changes[0].format().font_style({FontStyle::bold}).font_color(Color::cyan);
+    cout << changes << endl;
+    if (shown < outcome.changes.size()) {
+        printInfo("... and " + to_string(outcome.changes.size() - shown) + " more.");
+    }
+}
+
+void MenuUtils::displayPassMarkSweep(const std::vector<SweepPoint>& points, double currentPassRate) {
+    Table table;
+    table.add_row({"Pass Mark", "Passing", "Pass Rate", "vs Current"});
+    for (const auto& point : points) {
+        double delta = point.passRate - currentPassRate;
+        table.add_row({
+            GradeStats::formatValue(point.passMark),
+            to_string(point.passing),
+            GradeStats::formatValue(point.passRate) + "%",
+            (delta > 0 ? "+" : "") + GradeStats::formatValue(delta) + " pts"
+        });
+    }
+    table[0].format().font_style({FontStyle::bold}).font_color(Color::cyan);
+    cout << table << endl;
+}
+
+void MenuUtils::displayAnomalyReport(const std::vector<Student>& students, const AnomalyReport& report) {
+    printHeader("SUBJECT CORRELATION & OUTLIERS");
+
+    // Correlation matrix; strong pairs highlighted
+    Table matrix;
+    Table::Row_t header = {""};
+    header.insert(header.end(), report.subjects.begin(), report.subjects.end());
+    matrix.add_row(header);
+    for (size_t a = 0; a < report.subjects.size(); ++a) {
+        Table::Row_t row = {report.subjects[a]};
+        for (double r : report.correlation[a]) {
+            row.push_back(GradeStats::formatValue(r));
+        }
+        matrix.add_row(row);
+        for (size_t b = 0; b < report.subjects.size(); ++b) {
+            if (a != b && fabs(report.correlation[a][b]) >= 0.7) {
+                matrix[a + 1][b + 1].format().font_color(Color::yellow);
+            }
+        }
+    }
+    matrix[0].format().font_style({FontStyle::bold}).font_color(Color::cyan);
+    cout << matrix << endl;
+
+    for (const auto& spike : report.spikes) {
+        printWarning(report.subjects[spike.subjectIndex] + ": " + to_string(spike.perfectCount) +
+                     " scores of exactly 100 vs " + to_string(spike.neighbourhoodCount) +
+                     " between 95 and 100 - check for data-entry spikes.");
+    }
+
+    if (report.outliers.empty()) {
+        printSuccess("No outlying scores (|robust z| > " + GradeStats::formatValue(ScoreAnalysis::OUTLIER_THRESHOLD) + ").");
+    } else {
+        printInfo(to_string(report.flaggedScores) + " outlying scores; strongest " + to_string(report.outliers.size()) + ":");
+        Table outliers;
+        outliers.add_row({"Student ID", "Name", "Subject", "Score", "vs Own Scores (z)", "vs Cohort (z)"});
+        for (const auto& outlier : report.outliers) {
+            const Student& student = students[outlier.row];
+            outliers.add_row({
+                student.getStudentId(),
+                student.getName(),
+                report.subjects[outlier.subjectIndex],
+                GradeStats::formatValue(outlier.score),
+                GradeStats::formatValue(outlier.profileZ),
+                GradeStats::formatValue(outlier.cohortZ)
+            });
+        }
+        outliers[0].format().font_style({FontStyle::bold}).font_color(Color::cyan);
+        cout << outliers << endl;
+    }
+    printInfo("Analysis took " + GradeStats::formatValue(report.elapsedMilliseconds) + " ms.");
+}
+
+void MenuUtils::displayAnomalySummary(const AnomalyReport& report) {
+    if (report.flaggedScores == 0 && report.spikes.empty()) {
+        printSuccess("Score scan: no outliers or perfect-score spikes found.");
+        return;
+    }
+    string spikes;
+    for (const auto& spike : report.spikes) {
+        spikes += (spikes.empty() ? "" : ", ") + report.subjects[spike.subjectIndex];
+    }
+    printWarning("Score scan: " + to_string(report.flaggedScores) + " outlying scores" +
+                 (spikes.empty() ? "" : "; spikes at 100 in " + spikes) +
+                 ". See Analytics > Subject Correlation & Outliers.");
+}
+
+void MenuUtils::displayValidationReport(const ValidationReport& report, size_t maxIssues) {
+    if (report.clean()) {
+        printSuccess("Validation: all " + to_string(report.rowsChecked) + " rows passed (" +
+                     GradeStats::formatValue(report.elapsedMs) + " ms).");
+        return;
+    }
+    printWarning("Validation: " + to_string(report.issues.size()) + " issues in " + to_string(report.rowsWithIssues()) +
+                 " of " + to_string(report.rowsChecked) + " rows (" + GradeStats::formatValue(report.elapsedMs) + " ms).");
+
+    // One line per rule that fired, then the first issues in sheet order
+    Table summary;
+    summary.add_row({"Rule", "Issues", "Expected"});
+    for (size_t r = 0; r < ValidationReport::RULE_COUNT; ++r) {
+        ValidationRule rule = static_cast<ValidationRule>(r);
+        if (report.count(rule) == 0) continue;
+        summary.add_row({RosterValidator::ruleName(rule), to_string(report.count(rule)), RosterValidator::ruleDescription(rule)});
+    }
+    summary[0].format().font_style({FontStyle::bold}).font_color(Color::cyan);
+    cout << summary << endl;
+
+    Table issues;
+    issues.add_row({"Row", "Column", "Rule"});
+    size_t shown = min(maxIssues, report.issues.size());
+    for (size_t i = 0; i < shown; ++i) {
+        const auto& issue = report.issues[i];
+        issues.add_row({to_string(issue.row), RosterValidator::columnName(issue), RosterValidator::ruleName(issue.rule)});
+        issues[i + 1][2].format().font_color(Color::yellow);
+    }
+    issues[0].format().font_style({FontStyle::bold}).font_color(Color::cyan);
+    cout << issues << endl;
+    if (report.issues.size() > shown) {
+        printInfo("... and " + to_string(report.issues.size() - shown) + " more issues in the full report.");
+    }
+}
+
+void MenuUtils::displayStudentHistory(const std::string& title, const std::vector<TrendPoint>& history,
+                                      const TrendSummary& summary) {
+    printHeader("SCORE HISTORY: " + title);
+    
+    auto subjects = GradeUtil::getSubjectNames();
+    Table table;
+    Table::Row_t header = {"Backup Taken", "Average", "Change", "Grade"};
+    header.insert(header.end(), subjects.begin(), subjects.end());
+    table.add_row(header);
+    
+    for (size_t i = 0; i < history.size(); ++i) {
+        const auto& point = history[i];
+        time_t taken = static_cast<time_t>(point.timestamp);
+        ostringstream date;
+        date << put_time(localtime(&taken), "%Y-%m-%d %H:%M");
+        
+        string change = "-";
+        if (i > 0) {
+            double delta = point.average - history[i - 1].average;
+            change = (delta > 0 ? "+" : "") + GradeStats::formatValue(delta);
+        }
+        
+        string grade = GradeUtil::assignLetterGrade(point.average);
+        Table::Row_t row = {date.str(), GradeStats::formatValue(point.average), change, grade};
+        for (size_t s = 0; s < subjects.size(); ++s) {
+            bool taken = s < point.subjectScores.size() && !std::isnan(point.subjectScores[s]);
+            row.push_back(taken ? GradeStats::formatValue(point.subjectScores[s]) : "-");
+        }
+        table.add_row(row);
+        table[i + 1][3].format().font_color(getGradeColor(grade));
+    }
+    table[0].format().font_style({FontStyle::bold}).font_color(Color::magenta);
+    cout << table << endl;
+    
+    double change = summary.lastAverage - summary.firstAverage;
+    printInfo(to_string(summary.points) + " snapshot(s): average " + GradeStats::formatValue(summary.firstAverage) +
+              " -> " + GradeStats::formatValue(summary.lastAverage) + " (" + (change > 0 ? "+" : "") +
+              GradeStats::formatValue(change) + "), range " + GradeStats::formatValue(summary.lowestAverage) +
+              " - " + GradeStats::formatValue(summary.highestAverage));
+    if (summary.points > 1) {
+        string trend = (summary.slopePerMonth > 0 ? "+" : "") + GradeStats::formatValue(summary.slopePerMonth) + " points per month";
+        if (summary.slopePerMonth < 0) {
+            printWarning("Trend: " + trend);
+        } else {
+            printSuccess("Trend: " + trend);
+        }
+    }
+}
+
+void MenuUtils::displayTermSummaries(const std::vector<TermSummary>& terms) {
+    if (terms.empty()) {
+        printWarning("No terms recorded yet.");
+        return;
+    }
+    
+    Table table;
+    table.add_row({"#", "Term", "Students", "Mean Average", "Mean GPA"});
+    for (size_t i = 0; i < terms.size(); ++i) {
+        table.add_row({to_string(i + 1), terms[i].term, to_string(terms[i].students),
+                       GradeStats::formatValue(terms[i].meanAverage), GradeStats::formatValue(terms[i].meanGpa)});
+    }
+    table[0].format().font_style({FontStyle::bold}).font_color(Color::magenta);
+    cout << table << endl;
+}
+
+void MenuUtils::displayFailingStudents(const std::vector<Student>& students, const std::vector<std::uint32_t>& rows) {
+    if (rows.empty()) {
         printSuccess("No failing students found!");
         return;
     }
     
-    printError("FAILING STUDENTS (<50 Average) - " + to_string(students.size()) + " found:");
-    displayTable(students);
+    printError("FAILING STUDENTS (<50 Average) - " + to_string(rows.size()) + " found:");
+    displayTable(students, rows);
 }
 
 // Color legend function
 void MenuUtils::printColorLegend() {
-    cout << "\n" << BOLD << "Grade Color Legend:" << RESET << endl;
-    cout << GREEN << "● A-C: Excellent Performance" << RESET << endl;
-    cout << YELLOW << "● D-E: Acceptable Performance" << RESET << endl;
-    cout << RED << "● F: Failing Performance (<50)" << RESET << endl;
-    cout << endl;
+    cout << colorLegend() << flush;
+}
+
+std::string MenuUtils::colorLegend() {
+    return "\n" + BOLD + "Grade Color Legend:" + RESET + "\n" +
+           GREEN + "● A-C: Excellent Performance" + RESET + "\n" +
+           YELLOW + "● D-E: Acceptable Performance" + RESET + "\n" +
+           RED + "● F: Failing Performance (<50)" + RESET + "\n\n";
 }
 
 // Menu display methods
@@ -598,19 +996,31 @@ void MenuUtils::printColored(const std::string& text, const std::string& color)
 }
 
 void MenuUtils::printSuccess(const std::string& message) {
-    cout << GREEN << "✅ " << message << RESET << endl;
+    if (deferMessage(MessageKind::Success, message)) return;
+    if (headless) { cerr << "ok: " << message << '\n'; return; }
+    cout << GREEN << "✅ " << message << RESET << '\n';
+    endMessage();
 }
 
 void MenuUtils::printError(const std::string& message) {
-    cout << RED << "❌ " << message << RESET << endl;
+    if (deferMessage(MessageKind::Error, message)) return;
+    if (headless) { cerr << "error: " << message << '\n'; return; }
+    cout << RED << "❌ " << message << RESET << '\n';
+    endMessage();
 }
 
 void MenuUtils::printWarning(const std::string& message) {
-    cout << YELLOW << "⚠️ " << message << RESET << endl;
+    if (deferMessage(MessageKind::Warning, message)) return;
+    if (headless) { cerr << "warning: " << message << '\n'; return; }
+    cout << YELLOW << "⚠️ " << message << RESET << '\n';
+    endMessage();
 }
 
 void MenuUtils::printInfo(const std::string& message) {
-    cout << BLUE << "ℹ️ " << message << RESET << endl;
+    if (deferMessage(MessageKind::Info, message)) return;
+    if (headless) { cerr << "info: " << message << '\n'; return; }
+    cout << BLUE << "ℹ️ " << message << RESET << '\n';
+    endMessage();
 }
 
 // Input methods
@@ -726,14 +1136,30 @@ double MenuUtils::getDoubleInput(const std::string& prompt) {
 
 // Utility methods
 void MenuUtils::clearScreen() {
+    if (headless) return;
+    Screen::clear();
+}
+
+bool MenuUtils::isTerminalOutput() {
+#ifdef _WIN32
+    static const bool terminal = _isatty(_fileno(stdout)) != 0;
+#else
+    static const bool terminal = isatty(STDOUT_FILENO) != 0;
+#endif
+    return terminal;
+}
+
+bool MenuUtils::isInteractive() {
+    if (headless || !isTerminalOutput()) return false;
 #ifdef _WIN32
-    system("cls");  // Windows clear screen command
+    return _isatty(_fileno(stdin)) != 0;
 #else
-    system("clear");  // Unix/Linux clear screen command
+    return isatty(STDIN_FILENO) != 0;
 #endif
 }
 
 void MenuUtils::pauseScreen() {
+    if (headless) return;
     cout << CYAN << "\nPress Enter to continue..." << RESET;
     cin.get();
 }
@@ -746,4 +1172,32 @@ void MenuUtils::printHeader(const std::string& title) {
     printSeparator();
     cout << BOLD << CYAN << "               " << title << RESET << endl;
     printSeparator();
+}
+
+void MenuUtils::setHeadless(bool enabled) {
+    headless = enabled;
+}
+
+bool MenuUtils::isHeadless() {
+    return headless;
+}
+
+void MenuUtils::setDeferredOutput(bool enabled) {
+    deferredOutput = enabled;
+}
+
+void MenuUtils::flushDeferredMessages() {
+    std::vector<std::pair<MessageKind, std::string>> messages;
+    {
+        std::lock_guard<std::mutex> lock(deferredMutex);
+        messages.swap(deferredMessages);
+    }
+    for (const auto& entry : messages) {
+        switch (entry.first) {
+            case MessageKind::Success: printSuccess(entry.second); break;
+            case MessageKind::Error: printError(entry.second); break;
+            case MessageKind::Warning: printWarning(entry.second); break;
+            case MessageKind::Info: printInfo(entry.second); break;
+        }
+    }
 }
\ No newline at end of file
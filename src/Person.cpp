@@ -5,15 +5,15 @@
 Person::Person(const std::string& username, const std::string& password, const std::string& name)
     : username(username), password(password), name(name) {}
 
-std::string Person::getUsername() const {
+const std::string& Person::getUsername() const {
     return username;
 }
 
-std::string Person::getPassword() const {
+const std::string& Person::getPassword() const {
     return password;
 }
 
-std::string Person::getName() const {
+const std::string& Person::getName() const {
     return name;
 }
 
@@ -0,0 +1,313 @@
+#include "QuantileSketch.hpp"
+#include "ExcelUtil.hpp"
+#include "GradeUtil.hpp"
+#include "MenuUtils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+const size_t QuantileSketch::DEFAULT_K = 200;
+const std::string ScoreSketches::AVERAGE_COLUMN = "Average";
+
+namespace {
+    const string SKETCH_FILE_MAGIC = "SCOREME-SKETCH";
+    const int SKETCH_FILE_VERSION = 1;
+    const double CAPACITY_DECAY = 2.0 / 3.0;
+}
+
+// ---------------------------------------------------------------------------
+// QuantileSketch
+// ---------------------------------------------------------------------------
+
+QuantileSketch::QuantileSketch(size_t k)
+    : k(max<size_t>(k, 8)), totalCount(0),
+      minValue(numeric_limits<double>::max()), maxValue(numeric_limits<double>::lowest()),
+      coinState(0x9E3779B97F4A7C15ULL), levels(1), capacityTotal(0), retained(0) {
+    refreshCapacities();
+}
+
+void QuantileSketch::update(double value) {
+    totalCount++;
+    minValue = min(minValue, value);
+    maxValue = max(maxValue, value);
+    levels[0].push_back(value);
+    if (++retained >= capacityTotal) {
+        compress();
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.totalCount == 0) return;
+
+    if (levels.size() < other.levels.size()) {
+        levels.resize(other.levels.size());
+        refreshCapacities();
+    }
+    for (size_t h = 0; h < other.levels.size(); ++h) {
+        levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+    }
+    retained += other.retained;
+    totalCount += other.totalCount;
+    minValue = min(minValue, other.minValue);
+    maxValue = max(maxValue, other.maxValue);
+    compress();
+}
+
+double QuantileSketch::quantile(double fraction) const {
+    if (totalCount == 0) return 0.0;
+    if (fraction <= 0.0) return minValue;
+    if (fraction >= 1.0) return maxValue;
+
+    vector<pair<double, uint64_t>> weighted;
+    weighted.reserve(retained);
+    for (size_t h = 0; h < levels.size(); ++h) {
+        for (double value : levels[h]) {
+            weighted.emplace_back(value, uint64_t(1) << h);
+        }
+    }
+    sort(weighted.begin(), weighted.end());
+
+    uint64_t retainedWeight = 0;
+    for (const auto& item : weighted) retainedWeight += item.second;
+
+    double target = fraction * static_cast<double>(retainedWeight);
+    uint64_t cumulative = 0;
+    for (const auto& item : weighted) {
+        cumulative += item.second;
+        if (static_cast<double>(cumulative) >= target) {
+            return item.first;
+        }
+    }
+    return maxValue;
+}
+
+double QuantileSketch::rank(double value) const {
+    if (totalCount == 0) return 0.0;
+
+    uint64_t below = 0;
+    uint64_t retainedWeight = 0;
+    for (size_t h = 0; h < levels.size(); ++h) {
+        uint64_t weight = uint64_t(1) << h;
+        for (double item : levels[h]) {
+            retainedWeight += weight;
+            if (item <= value) below += weight;
+        }
+    }
+    return retainedWeight > 0 ? static_cast<double>(below) / static_cast<double>(retainedWeight) : 0.0;
+}
+
+std::uint64_t QuantileSketch::count() const { return totalCount; }
+double QuantileSketch::minimum() const { return totalCount > 0 ? minValue : 0.0; }
+double QuantileSketch::maximum() const { return totalCount > 0 ? maxValue : 0.0; }
+
+size_t QuantileSketch::retainedItems() const { return retained; }
+
+double QuantileSketch::rankErrorBound() const {
+    return 1.7 / static_cast<double>(k);
+}
+
+// Top level holds k items, each level below holds 2/3 of the one above
+void QuantileSketch::refreshCapacities() {
+    capacities.resize(levels.size());
+    capacityTotal = 0;
+    for (size_t h = 0; h < levels.size(); ++h) {
+        size_t depth = levels.size() - h - 1;
+        double capacity = ceil(static_cast<double>(k) * pow(CAPACITY_DECAY, static_cast<double>(depth)));
+        capacities[h] = max<size_t>(2, static_cast<size_t>(capacity));
+        capacityTotal += capacities[h];
+    }
+}
+
+// Halve the lowest over-full level: sort it, then promote every other item
+// (random offset) to the next level at double weight.
+void QuantileSketch::compress() {
+    while (retained >= capacityTotal) {
+        size_t h = 0;
+        while (h < levels.size() && levels[h].size() < capacities[h]) h++;
+        if (h == levels.size()) break;
+
+        if (h + 1 == levels.size()) {
+            levels.emplace_back();
+            refreshCapacities();
+        }
+        auto& level = levels[h];
+        sort(level.begin(), level.end());
+
+        // An odd item out stays behind at its current weight
+        size_t keep = level.size() % 2;
+        size_t offset = flipCoin() ? 1 : 0;
+        auto& next = levels[h + 1];
+        for (size_t i = keep + offset; i < level.size(); i += 2) {
+            next.push_back(level[i]);
+        }
+        size_t promoted = (level.size() - keep) / 2;
+        retained -= level.size() - keep - promoted;
+        level.resize(keep);
+    }
+}
+
+bool QuantileSketch::flipCoin() {
+    // xorshift64: deterministic, so the same input always produces the same file
+    coinState ^= coinState << 13;
+    coinState ^= coinState >> 7;
+    coinState ^= coinState << 17;
+    return (coinState & 1) != 0;
+}
+
+void QuantileSketch::write(std::ostream& out) const {
+    out << setprecision(17);
+    out << "sketch " << k << " " << totalCount << " " << minValue << " " << maxValue << " " << levels.size() << "\n";
+    for (const auto& level : levels) {
+        out << level.size();
+        for (double value : level) out << " " << value;
+        out << "\n";
+    }
+}
+
+QuantileSketch QuantileSketch::read(std::istream& in) {
+    string tag;
+    size_t k = 0, levelCount = 0;
+    QuantileSketch sketch;
+    if (!(in >> tag >> k >> sketch.totalCount >> sketch.minValue >> sketch.maxValue >> levelCount) || tag != "sketch") {
+        throw runtime_error("Malformed sketch block");
+    }
+    sketch.k = max<size_t>(k, 8);
+    sketch.levels.assign(max<size_t>(levelCount, 1), {});
+    for (size_t h = 0; h < levelCount; ++h) {
+        size_t size = 0;
+        if (!(in >> size)) throw runtime_error("Malformed sketch level");
+        sketch.levels[h].resize(size);
+        for (double& value : sketch.levels[h]) {
+            if (!(in >> value)) throw runtime_error("Truncated sketch level");
+        }
+        sketch.retained += size;
+    }
+    sketch.refreshCapacities();
+    return sketch;
+}
+
+// ---------------------------------------------------------------------------
+// ScoreSketches
+// ---------------------------------------------------------------------------
+
+ScoreSketches::ScoreSketches() {
+    columnNames.push_back(AVERAGE_COLUMN);
+    auto subjects = GradeUtil::getSubjectNames();
+    columnNames.insert(columnNames.end(), subjects.begin(), subjects.end());
+    sketches.resize(columnNames.size());
+}
+
+ScoreSketches ScoreSketches::fromStudents(const std::vector<Student>& students) {
+    ScoreSketches result;
+    for (const auto& student : students) {
+        result.sketches[0].update(student.getAverageScore());
+        const auto& scores = student.getSubjectScores();
+        for (size_t s = 0; s < scores.size() && s + 1 < result.sketches.size(); ++s) {
+            if (student.hasScore(s)) result.sketches[s + 1].update(scores[s]);
+        }
+    }
+    return result;
+}
+
+void ScoreSketches::merge(const ScoreSketches& other) {
+    for (size_t i = 0; i < other.columnNames.size(); ++i) {
+        auto it = std::find(columnNames.begin(), columnNames.end(), other.columnNames[i]);
+        if (it == columnNames.end()) {
+            columnNames.push_back(other.columnNames[i]);
+            sketches.push_back(other.sketches[i]);
+        } else {
+            sketches[it - columnNames.begin()].merge(other.sketches[i]);
+        }
+    }
+}
+
+const QuantileSketch* ScoreSketches::find(const std::string& columnName) const {
+    for (size_t i = 0; i < columnNames.size(); ++i) {
+        if (columnNames[i] == columnName) return &sketches[i];
+    }
+    return nullptr;
+}
+
+void ScoreSketches::save(const std::string& filename) const {
+    std::filesystem::path filePath(filename);
+    if (filePath.has_parent_path()) {
+        std::filesystem::create_directories(filePath.parent_path());
+    }
+
+    ofstream out(filename);
+    if (!out) {
+        throw runtime_error("Cannot write sketch file: " + filename);
+    }
+    out << SKETCH_FILE_MAGIC << " " << SKETCH_FILE_VERSION << "\n";
+    out << columnNames.size() << "\n";
+    for (size_t i = 0; i < columnNames.size(); ++i) {
+        out << columnNames[i] << "\n";
+        sketches[i].write(out);
+    }
+}
+
+ScoreSketches ScoreSketches::load(const std::string& filename) {
+    ifstream in(filename);
+    if (!in) {
+        throw runtime_error("Cannot open sketch file: " + filename);
+    }
+
+    string magic;
+    int version = 0;
+    size_t columns = 0;
+    if (!(in >> magic >> version >> columns) || magic != SKETCH_FILE_MAGIC || version != SKETCH_FILE_VERSION) {
+        throw runtime_error("Not a ScoreME sketch file: " + filename);
+    }
+
+    ScoreSketches result;
+    result.columnNames.clear();
+    result.sketches.clear();
+    for (size_t i = 0; i < columns; ++i) {
+        string name;
+        in >> ws;
+        getline(in, name);
+        result.columnNames.push_back(name);
+        result.sketches.push_back(QuantileSketch::read(in));
+    }
+    return result;
+}
+
+std::string ScoreSketches::sketchFilenameFor(const std::string& workbookFilename) {
+    return std::filesystem::path(workbookFilename).replace_extension(".sketch").string();
+}
+
+ScoreSketches ScoreSketches::loadArchive(const std::string& backupDirectory, size_t& snapshotCount) {
+    ScoreSketches archive;
+    snapshotCount = 0;
+    if (!std::filesystem::exists(backupDirectory)) {
+        return archive;
+    }
+
+    for (const auto& entry : std::filesystem::directory_iterator(backupDirectory)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".xlsx") continue;
+
+        // Credential backups carry no scores
+        string workbook = entry.path().string();
+        if (entry.path().filename().string().find("credentials") != string::npos) continue;
+
+        string sketchFile = sketchFilenameFor(workbook);
+        try {
+            if (!ExcelUtils::fileExists(sketchFile)) {
+                // One-time backfill for backups taken before sketches existed
+                fromStudents(ExcelUtils::readStudentRows(workbook)).save(sketchFile);
+            }
+            archive.merge(load(sketchFile));
+            snapshotCount++;
+        } catch (const exception& e) {
+            MenuUtils::printWarning("Skipping " + workbook + ": " + e.what());
+        }
+    }
+    return archive;
+}
@@ -0,0 +1,197 @@
+#include "RegradeSimulator.hpp"
+#include "GradeStats.hpp"
+#include "GradeUtil.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace std;
+
+namespace {
+    double clampScore(double score) {
+        return min(GradeUtil::MAX_SCORE, max(GradeUtil::MIN_SCORE, score));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// GradeScale / Curve
+// ---------------------------------------------------------------------------
+
+GradeScale GradeScale::current() {
+    return {GradeUtil::getGradeThresholds()};
+}
+
+bool GradeScale::isValid() const {
+    for (size_t i = 0; i < thresholds.size(); ++i) {
+        if (!GradeUtil::isValidScore(thresholds[i])) return false;
+        if (i > 0 && thresholds[i] >= thresholds[i - 1]) return false;
+    }
+    return true;
+}
+
+// Counts the boundaries the average falls below, so there is no branch chain
+int GradeScale::gradeIndex(double average) const {
+    return (average < thresholds[0]) + (average < thresholds[1]) + (average < thresholds[2]) +
+           (average < thresholds[3]) + (average < thresholds[4]);
+}
+
+std::string GradeScale::gradeLetter(int index) {
+    static const char* letters[GRADE_COUNT] = {"A", "B", "C", "D", "E", "F"};
+    return (index >= 0 && index < GRADE_COUNT) ? letters[index] : "?";
+}
+
+std::string Curve::describe() const {
+    switch (type) {
+        case CurveType::None:
+            return "No curve";
+        case CurveType::LinearShift:
+            return "Linear shift " + string(shift >= 0 ? "+" : "") + GradeStats::formatValue(shift);
+        case CurveType::ZScore:
+            return "Z-score to mean " + GradeStats::formatValue(targetMean) + ", std dev " + GradeStats::formatValue(targetStdDev);
+        case CurveType::BellCurve:
+            return "Bell curve, mean " + GradeStats::formatValue(targetMean) + ", std dev " + GradeStats::formatValue(targetStdDev);
+    }
+    return "";
+}
+
+// ---------------------------------------------------------------------------
+// RegradeSimulator
+// ---------------------------------------------------------------------------
+
+RegradeSimulator::RegradeSimulator(const std::vector<Student>& students) {
+    averages.reserve(students.size());
+    for (const auto& student : students) {
+        averages.push_back(student.getAverageScore());
+    }
+}
+
+RegradeOutcome RegradeSimulator::simulate(const GradeScale& scale, const Curve& curve) const {
+    RegradeOutcome outcome;
+    size_t n = averages.size();
+    if (n == 0) return outcome;
+
+    vector<double> curved = applyCurve(curve);
+    GradeScale currentScale = GradeScale::current();
+    size_t currentPassing = 0, simulatedPassing = 0;
+    double currentSum = 0.0, simulatedSum = 0.0;
+
+    // One pass over both columns: old grade, new grade, sums and pass counts
+    for (size_t i = 0; i < n; ++i) {
+        int oldGrade = currentScale.gradeIndex(averages[i]);
+        int newGrade = scale.gradeIndex(curved[i]);
+        outcome.currentCounts[oldGrade]++;
+        outcome.simulatedCounts[newGrade]++;
+        currentSum += averages[i];
+        simulatedSum += curved[i];
+        currentPassing += averages[i] >= currentScale.thresholds[4];
+        simulatedPassing += curved[i] >= scale.thresholds[4];
+
+        if (oldGrade != newGrade) {
+            outcome.changes.push_back({static_cast<uint32_t>(i), averages[i], curved[i], oldGrade, newGrade});
+            if (newGrade < oldGrade) outcome.promoted++; else outcome.demoted++;
+        }
+    }
+
+    outcome.currentMean = currentSum / n;
+    outcome.simulatedMean = simulatedSum / n;
+    outcome.currentPassRate = 100.0 * currentPassing / n;
+    outcome.simulatedPassRate = 100.0 * simulatedPassing / n;
+    return outcome;
+}
+
+std::vector<SweepPoint> RegradeSimulator::sweepPassMarks(const Curve& curve, double from, double to, double step) const {
+    vector<SweepPoint> points;
+    if (step <= 0.0 || from > to) return points;
+
+    vector<double> curved = applyCurve(curve);
+    sort(curved.begin(), curved.end());
+    size_t n = curved.size();
+
+    // Index-based so rounding in step never drops the last mark
+    size_t steps = static_cast<size_t>(floor((to - from) / step + 1e-9));
+    for (size_t k = 0; k <= steps; ++k) {
+        double mark = from + step * static_cast<double>(k);
+        size_t failing = static_cast<size_t>(lower_bound(curved.begin(), curved.end(), mark) - curved.begin());
+        size_t passing = n - failing;
+        points.push_back({mark, passing, n > 0 ? 100.0 * passing / n : 0.0});
+    }
+    return points;
+}
+
+size_t RegradeSimulator::size() const {
+    return averages.size();
+}
+
+std::vector<double> RegradeSimulator::applyCurve(const Curve& curve) const {
+    size_t n = averages.size();
+    vector<double> curved(averages);
+
+    switch (curve.type) {
+        case CurveType::None:
+            break;
+
+        case CurveType::LinearShift:
+            for (double& value : curved) value = clampScore(value + curve.shift);
+            break;
+
+        case CurveType::ZScore: {
+            double mean = accumulate(averages.begin(), averages.end(), 0.0) / n;
+            double squares = 0.0;
+            for (double value : averages) squares += (value - mean) * (value - mean);
+            double stdDev = sqrt(squares / n);
+            for (double& value : curved) {
+                double z = stdDev > 0.0 ? (value - mean) / stdDev : 0.0;
+                value = clampScore(curve.targetMean + z * curve.targetStdDev);
+            }
+            break;
+        }
+
+        case CurveType::BellCurve: {
+            // Mid-rank percentile of each student (ties share a rank), mapped
+            // through the inverse normal CDF
+            vector<uint32_t> order(n);
+            iota(order.begin(), order.end(), 0u);
+            sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return averages[a] < averages[b]; });
+            for (size_t begin = 0; begin < n;) {
+                size_t end = begin + 1;
+                while (end < n && averages[order[end]] == averages[order[begin]]) end++;
+                double percentile = (static_cast<double>(begin + end) / 2.0) / static_cast<double>(n);
+                double score = clampScore(curve.targetMean + inverseNormal(percentile) * curve.targetStdDev);
+                for (size_t i = begin; i < end; ++i) curved[order[i]] = score;
+                begin = end;
+            }
+            break;
+        }
+    }
+    return curved;
+}
+
+// Acklam's rational approximation of the standard normal quantile
+// (relative error below 1.2e-9)
+double RegradeSimulator::inverseNormal(double probability) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    const double low = 0.02425;
+
+    double p = min(max(probability, 1e-12), 1.0 - 1e-12);
+    if (p < low) {
+        double q = sqrt(-2.0 * log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    if (p > 1.0 - low) {
+        double q = sqrt(-2.0 * log(1.0 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
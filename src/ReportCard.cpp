@@ -0,0 +1,328 @@
+#include "ReportCard.hpp"
+#include "GradeUtil.hpp"
+#include "RosterExport.hpp"
+#include <xlnt/xlnt.hpp>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+namespace {
+    const size_t MAX_FAILURES_KEPT = 20;
+    const size_t CARD_BUFFER_BYTES = 8192;
+
+    string fixed2(double value) {
+        char buffer[32];
+        int length = snprintf(buffer, sizeof(buffer), "%.2f", value);
+        return string(buffer, static_cast<size_t>(length));
+    }
+
+    // Student IDs become file names, so anything that is not safe in a
+    // path is replaced; repeated IDs get a numeric suffix
+    vector<string> cardFilenames(const vector<ExportRow>& rows, const string& directory, const string& extension) {
+        vector<string> filenames;
+        filenames.reserve(rows.size());
+        unordered_set<string> used;
+        unordered_map<string, int> nextCopy;    // per stem, so repeats are not probed from 2 each time
+        used.reserve(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            string stem = rows[i].studentId;
+            for (char& c : stem) {
+                if (!isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_') c = '_';
+            }
+            if (stem.empty()) stem = "row_" + to_string(i + 1);
+            string name = stem;
+            if (!used.insert(name).second) {
+                int& copy = nextCopy.emplace(stem, 2).first->second;
+                do {
+                    name = stem + "_" + to_string(copy++);
+                } while (!used.insert(name).second);
+            }
+            filenames.push_back(directory + "/" + name + "." + extension);
+        }
+        return filenames;
+    }
+
+    // Pieces shared by every card of a run, built once
+    struct CardTemplate {
+        vector<string> subjects;
+        vector<string> textSubjectLabels;    // padded to the score column
+        string htmlHead;
+
+        CardTemplate() : subjects(GradeUtil::getSubjectNames()) {
+            for (const auto& subject : subjects) {
+                string label = subject;
+                if (label.size() < 16) label.append(16 - label.size(), ' ');
+                textSubjectLabels.push_back(label);
+            }
+            htmlHead =
+                "<!DOCTYPE html>\n<html lang=\"en\">\n<head>\n<meta charset=\"utf-8\">\n"
+                "<style>\n"
+                "body { font-family: Arial, sans-serif; margin: 2em; color: #222; }\n"
+                "h1 { font-size: 1.4em; border-bottom: 2px solid #36c; padding-bottom: .3em; }\n"
+                "table { border-collapse: collapse; margin: 1em 0; }\n"
+                "th, td { border: 1px solid #ccc; padding: .3em .8em; text-align: left; }\n"
+                "th { background: #eef3fb; }\n"
+                ".pass { color: #2a7d2a; font-weight: bold; }\n"
+                ".fail { color: #c0392b; font-weight: bold; }\n"
+                ".muted { color: #888; }\n"
+                "</style>\n";
+        }
+    };
+
+    void appendHtml(string& out, const string& text) {
+        for (char c : text) {
+            switch (c) {
+                case '&': out += "&amp;"; break;
+                case '<': out += "&lt;"; break;
+                case '>': out += "&gt;"; break;
+                case '"': out += "&quot;"; break;
+                default: out += c;
+            }
+        }
+    }
+
+    void appendTextField(string& out, const char* label, const string& value) {
+        out += label;
+        out += value;
+        out += '\n';
+    }
+
+    void formatTextCard(string& out, const CardTemplate& layout, const ExportRow& row, const Student& student) {
+        out += "REPORT CARD\n===========\n\n";
+        appendTextField(out, "Student ID      : ", row.studentId);
+        appendTextField(out, "Name            : ", row.name);
+        appendTextField(out, "Class           : ", row.className);
+        appendTextField(out, "Date of Birth   : ", row.dateOfBirth);
+        appendTextField(out, "Email           : ", row.email);
+        out += "\nSubject           Score  Grade\n-------------------------------\n";
+        for (size_t s = 0; s < layout.subjects.size() && s < row.scores.size(); ++s) {
+            out += layout.textSubjectLabels[s];
+            if (row.hasScore(s)) {
+                char line[32];
+                snprintf(line, sizeof(line), "%7.2f  ", row.scores[s]);
+                out += line;
+                out += GradeUtil::assignLetterGrade(row.scores[s]);
+            } else {
+                out += "      -  Not taken";
+            }
+            out += '\n';
+        }
+        out += '\n';
+        appendTextField(out, "Average Score   : ", fixed2(row.average));
+        appendTextField(out, "Letter Grade    : ", row.letterGrade);
+        appendTextField(out, "GPA             : ", fixed2(row.gpa));
+        if (student.getCumulativeCredits() > 0.0) {
+            appendTextField(out, "Cumulative GPA  : ", fixed2(student.getCumulativeGpa()) + " (" +
+                            fixed2(student.getCumulativeCredits()) + " credits, closed terms)");
+        }
+        appendTextField(out, "Remark          : ", row.remark);
+        appendTextField(out, "Last Updated    : ", row.lastUpdated);
+    }
+
+    void appendHtmlRow(string& out, const char* label, const string& value, const char* cssClass = nullptr) {
+        out += "<tr><th>";
+        out += label;
+        out += "</th><td";
+        if (cssClass) {
+            out += " class=\"";
+            out += cssClass;
+            out += '"';
+        }
+        out += '>';
+        appendHtml(out, value);
+        out += "</td></tr>\n";
+    }
+
+    void formatHtmlCard(string& out, const CardTemplate& layout, const ExportRow& row, const Student& student) {
+        out += layout.htmlHead;
+        out += "<title>Report Card - ";
+        appendHtml(out, row.name);
+        out += "</title>\n</head>\n<body>\n<h1>Report Card: ";
+        appendHtml(out, row.name);
+        out += "</h1>\n<table>\n";
+        appendHtmlRow(out, "Student ID", row.studentId);
+        appendHtmlRow(out, "Class", row.className);
+        appendHtmlRow(out, "Date of Birth", row.dateOfBirth);
+        appendHtmlRow(out, "Email", row.email);
+        out += "</table>\n<table>\n<tr><th>Subject</th><th>Score</th><th>Grade</th></tr>\n";
+        for (size_t s = 0; s < layout.subjects.size() && s < row.scores.size(); ++s) {
+            out += "<tr><td>";
+            out += layout.subjects[s];
+            if (row.hasScore(s)) {
+                out += "</td><td>";
+                out += fixed2(row.scores[s]);
+                out += "</td><td>";
+                out += GradeUtil::assignLetterGrade(row.scores[s]);
+                out += "</td></tr>\n";
+            } else {
+                out += "</td><td class=\"muted\">-</td><td class=\"muted\">Not taken</td></tr>\n";
+            }
+        }
+        out += "</table>\n<table>\n";
+        const char* standing = row.passing ? "pass" : "fail";
+        appendHtmlRow(out, "Average Score", fixed2(row.average));
+        appendHtmlRow(out, "Letter Grade", row.letterGrade, standing);
+        appendHtmlRow(out, "GPA", fixed2(row.gpa));
+        if (student.getCumulativeCredits() > 0.0) {
+            appendHtmlRow(out, "Cumulative GPA", fixed2(student.getCumulativeGpa()) + " (" +
+                          fixed2(student.getCumulativeCredits()) + " credits, closed terms)");
+        }
+        appendHtmlRow(out, "Remark", row.remark, standing);
+        appendHtmlRow(out, "Last Updated", row.lastUpdated);
+        out += "</table>\n</body>\n</html>\n";
+    }
+
+    // Styles are built once per shard; every card still needs its own
+    // workbook, since xlnt saves whole workbooks
+    struct XlsxStyles {
+        xlnt::font title = xlnt::font().bold(true).size(14);
+        xlnt::font label = xlnt::font().bold(true);
+    };
+
+    void writeXlsxCard(const string& filename, const XlsxStyles& styles, const CardTemplate& layout,
+                       const ExportRow& row, const Student& student) {
+        xlnt::workbook wb;
+        xlnt::worksheet ws = wb.active_sheet();
+        ws.title("Report Card");
+
+        xlnt::row_t line = 1;
+        auto field = [&](const string& label, const string& value) {
+            auto cell = ws.cell(xlnt::cell_reference(1, line));
+            cell.value(label);
+            cell.font(styles.label);
+            ws.cell(xlnt::cell_reference(2, line++)).value(value);
+        };
+
+        auto title = ws.cell(xlnt::cell_reference(1, line++));
+        title.value("REPORT CARD - " + row.name);
+        title.font(styles.title);
+        line++;
+        field("Student ID", row.studentId);
+        field("Class", row.className);
+        field("Date of Birth", row.dateOfBirth);
+        field("Email", row.email);
+        line++;
+
+        const char* headers[] = {"Subject", "Score", "Grade"};
+        for (xlnt::column_t c = 0; c < 3; ++c) {
+            auto cell = ws.cell(xlnt::cell_reference(c + 1, line));
+            cell.value(headers[c]);
+            cell.font(styles.label);
+        }
+        line++;
+        for (size_t s = 0; s < layout.subjects.size() && s < row.scores.size(); ++s, ++line) {
+            ws.cell(xlnt::cell_reference(1, line)).value(layout.subjects[s]);
+            if (row.hasScore(s)) {
+                ws.cell(xlnt::cell_reference(2, line)).value(row.scores[s]);
+                ws.cell(xlnt::cell_reference(3, line)).value(GradeUtil::assignLetterGrade(row.scores[s]));
+            } else {
+                ws.cell(xlnt::cell_reference(3, line)).value("Not taken");
+            }
+        }
+        line++;
+        field("Average Score", fixed2(row.average));
+        field("Letter Grade", row.letterGrade);
+        field("GPA", fixed2(row.gpa));
+        if (student.getCumulativeCredits() > 0.0) {
+            field("Cumulative GPA", fixed2(student.getCumulativeGpa()));
+        }
+        field("Remark", row.remark);
+        field("Last Updated", row.lastUpdated);
+
+        wb.save(filename);
+    }
+
+    void writeBuffer(const string& filename, const string& buffer) {
+        ofstream file(filename, ios::binary);
+        if (!file || !file.write(buffer.data(), static_cast<streamsize>(buffer.size())) || !file.flush()) {
+            throw runtime_error("cannot write file");
+        }
+    }
+}
+
+ReportCardResult ReportCards::generate(const std::vector<Student>& students, const ReportCardOptions& options,
+                                       const ProgressCallback& progress) {
+    auto start = chrono::steady_clock::now();
+    ReportCardResult result;
+    result.directory = options.directory;
+    std::filesystem::create_directories(options.directory);
+
+    const vector<ExportRow> rows = RosterExport::formatRows(students);
+    const vector<string> filenames = cardFilenames(rows, options.directory, extension(options.format));
+    const CardTemplate layout;
+
+    atomic<size_t> written{0};
+    mutex failureMutex;
+    auto writeShard = [&](size_t begin, size_t end) {
+        string buffer;
+        buffer.reserve(CARD_BUFFER_BYTES);
+        XlsxStyles styles;
+        for (size_t i = begin; i < end; ++i) {
+            try {
+                if (options.format == ReportCardFormat::Xlsx) {
+                    writeXlsxCard(filenames[i], styles, layout, rows[i], students[i]);
+                } else {
+                    buffer.clear();
+                    if (options.format == ReportCardFormat::Html) {
+                        formatHtmlCard(buffer, layout, rows[i], students[i]);
+                    } else {
+                        formatTextCard(buffer, layout, rows[i], students[i]);
+                    }
+                    writeBuffer(filenames[i], buffer);
+                }
+                written++;
+            } catch (const exception& e) {
+                lock_guard<mutex> lock(failureMutex);
+                if (result.failures.size() < MAX_FAILURES_KEPT) {
+                    result.failures.push_back(filenames[i] + ": " + e.what());
+                }
+                result.failed++;
+            }
+        }
+    };
+    size_t cardsPerTask = max<size_t>(1, options.cardsPerTask);
+    if (options.format == ReportCardFormat::Xlsx) {
+        // xlnt workbooks are built and saved one at a time, on this thread
+        for (size_t begin = 0; begin < rows.size(); begin += cardsPerTask) {
+            size_t end = min(rows.size(), begin + cardsPerTask);
+            writeShard(begin, end);
+            if (progress) progress(end, rows.size());
+        }
+    } else {
+        TaskScheduler::shared().parallelFor(rows.size(), cardsPerTask, writeShard, nullptr, progress);
+    }
+
+    result.written = written;
+    result.elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+bool ReportCards::parseFormat(const std::string& text, ReportCardFormat& format) {
+    if (text == "text" || text == "txt") format = ReportCardFormat::Text;
+    else if (text == "html") format = ReportCardFormat::Html;
+    else if (text == "xlsx") format = ReportCardFormat::Xlsx;
+    else return false;
+    return true;
+}
+
+std::string ReportCards::formatName(ReportCardFormat format) {
+    switch (format) {
+        case ReportCardFormat::Text: return "text";
+        case ReportCardFormat::Html: return "html";
+        case ReportCardFormat::Xlsx: return "xlsx";
+    }
+    return "unknown";
+}
+
+std::string ReportCards::extension(ReportCardFormat format) {
+    return format == ReportCardFormat::Text ? "txt" : formatName(format);
+}
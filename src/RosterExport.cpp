@@ -0,0 +1,170 @@
+#include "RosterExport.hpp"
+#include "ExcelUtil.hpp"
+#include "GradeUtil.hpp"
+#include "JsonUtil.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    const size_t ROWS_PER_TASK = 4096;
+
+    string formatNumber(double value) {
+        char buffer[32];
+        int length = snprintf(buffer, sizeof(buffer), "%.10g", value);
+        return string(buffer, static_cast<size_t>(length));
+    }
+
+    void formatRange(const vector<Student>& students, vector<ExportRow>& rows, size_t begin, size_t end) {
+        // Rosters are mostly saved in bulk, so neighbours usually share a
+        // timestamp; reuse the text instead of formatting it again
+        time_t previousTime = 0;
+        string previousText;
+        for (size_t i = begin; i < end; ++i) {
+            const Student& student = students[i];
+            ExportRow& row = rows[i];
+            row.studentId = student.getStudentId();
+            row.name = student.getName();
+            row.age = student.getAge();
+            row.gender = student.getGender();
+            row.dateOfBirth = student.getDateOfBirth();
+            row.email = student.getEmail();
+            row.scores = student.getSubjectScores();
+            row.scoreText.resize(row.scores.size());
+            for (size_t s = 0; s < row.scores.size(); ++s) {
+                if (student.hasScore(s)) {
+                    row.scoreMask |= 1u << s;
+                    row.scoreText[s] = formatNumber(row.scores[s]);
+                }
+            }
+            row.average = student.getAverageScore();
+            row.averageText = formatNumber(row.average);
+            row.letterGrade = student.getLetterGrade();
+            row.gpa = student.getGpa();
+            row.gpaText = formatNumber(row.gpa);
+            row.remark = student.getRemark();
+            if (i == begin || student.getLastUpdated() != previousTime) {
+                previousTime = student.getLastUpdated();
+                previousText = student.getFormattedTimestamp();
+            }
+            row.lastUpdated = previousText;
+            row.className = student.getClassName();
+            row.username = student.getUsername();
+            row.password = student.getPassword();
+            row.passing = student.hasPassingGrade();
+        }
+    }
+
+    void appendRowJson(string& out, const ExportRow& row, const vector<string>& subjects) {
+        JsonObject scores;
+        for (size_t s = 0; s < subjects.size(); ++s) {
+            // Subjects not taken are null rather than 0
+            scores.raw(subjects[s], row.hasScore(s) ? row.scoreText[s] : "null");
+        }
+        JsonObject json;
+        json.add("studentId", row.studentId).add("name", row.name).add("className", row.className);
+        json.add("age", row.age).add("gender", row.gender).add("dateOfBirth", row.dateOfBirth).add("email", row.email);
+        json.raw("scores", scores.str());
+        json.raw("average", isfinite(row.average) ? row.averageText : "null").add("letterGrade", row.letterGrade);
+        json.raw("gpa", isfinite(row.gpa) ? row.gpaText : "null").add("remark", row.remark).add("lastUpdated", row.lastUpdated);
+        out += json.str();
+    }
+}
+
+std::vector<ExportRow> RosterExport::formatRows(const std::vector<Student>& students) {
+    vector<ExportRow> rows(students.size());
+    TaskScheduler::shared().parallelFor(students.size(), ROWS_PER_TASK, [&](size_t begin, size_t end) {
+        formatRange(students, rows, begin, end);
+    });
+    return rows;
+}
+
+std::vector<ExportFileResult> RosterExport::run(const std::vector<Student>& students, const ExportTargets& targets) {
+    const vector<ExportRow> rows = formatRows(students);
+
+    struct Sink {
+        ExportFileResult result;
+        bool xlsx;
+        function<void(const string&)> write;
+    };
+    vector<Sink> sinks;
+    auto add = [&sinks](const string& kind, const string& filename, bool xlsx, function<void(const string&)> write) {
+        if (filename.empty()) return;
+        ExportFileResult result;
+        result.kind = kind;
+        result.filename = filename;
+        sinks.push_back({result, xlsx, move(write)});
+    };
+    add("grade report", targets.gradeReport, true, [&](const string& file) { ExcelUtils::writeGradeReportRows(file, rows, students); });
+    add("workbook", targets.workbook, true, [&](const string& file) { ExcelUtils::writeExcelRows(file, rows); });
+    add("credentials", targets.credentials, true, [&](const string& file) { ExcelUtils::writeCredentialRows(file, rows); });
+    add("CSV", targets.csv, false, [&](const string& file) { ExcelUtils::writeCsvRows(file, rows); });
+    add("JSON", targets.json, false, [&](const string& file) { writeJson(file, rows); });
+
+    auto write = [](Sink& sink) {
+        auto start = chrono::steady_clock::now();
+        try {
+            sink.write(sink.result.filename);
+        } catch (const exception& e) {
+            sink.result.error = e.what();
+        }
+        sink.result.elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+
+    // CSV and JSON are plain text and go to the pool; xlnt workbooks are
+    // written one at a time on this thread while those run
+    TaskGroup group(TaskScheduler::shared());
+    for (auto& sink : sinks) {
+        if (!sink.xlsx) group.run([&write, &sink] { write(sink); });
+    }
+    for (auto& sink : sinks) {
+        if (sink.xlsx) write(sink);
+    }
+    group.wait();
+
+    vector<ExportFileResult> results;
+    results.reserve(sinks.size());
+    for (auto& sink : sinks) {
+        results.push_back(move(sink.result));
+    }
+    return results;
+}
+
+void RosterExport::writeJson(const std::string& filename, const std::vector<ExportRow>& rows) {
+    std::filesystem::path filePath(filename);
+    if (filePath.has_parent_path()) {
+        std::filesystem::create_directories(filePath.parent_path());
+    }
+
+    auto subjects = GradeUtil::getSubjectNames();
+    string out = TaskScheduler::shared().parallelReduce(rows.size(), ROWS_PER_TASK, string("["),
+        [&](size_t begin, size_t end) {
+            string part;
+            part.reserve(320 * (end - begin));
+            for (size_t i = begin; i < end; ++i) {
+                if (i > 0) part += ',';
+                part += "\n  ";
+                appendRowJson(part, rows[i], subjects);
+            }
+            return part;
+        },
+        [](string& all, string& part) { all += part; });
+    out += "\n]\n";
+
+    ofstream file(filename, ios::binary);
+    if (!file || !file.write(out.data(), static_cast<streamsize>(out.size())) || !file.flush()) {
+        throw runtime_error("Cannot write JSON file: " + filename);
+    }
+}
+
+bool RosterExport::succeeded(const std::vector<ExportFileResult>& results) {
+    return all_of(results.begin(), results.end(), [](const ExportFileResult& result) { return result.error.empty(); });
+}
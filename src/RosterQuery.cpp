@@ -0,0 +1,428 @@
+#include "RosterQuery.hpp"
+#include "GradeUtil.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    struct Token {
+        string text;
+        bool quoted;
+    };
+
+    string lowercase(const string& text) {
+        string result = text;
+        transform(result.begin(), result.end(), result.begin(),
+            [](unsigned char c) { return static_cast<char>(tolower(c)); });
+        return result;
+    }
+
+    bool isOperatorChar(char c) {
+        return c == '=' || c == '!' || c == '<' || c == '>' || c == '~';
+    }
+
+    // Words run until whitespace, an operator, a comma or a quote, so dates
+    // and emails stay whole
+    vector<Token> tokenize(const string& text) {
+        vector<Token> tokens;
+        size_t i = 0;
+        while (i < text.size()) {
+            char c = text[i];
+            if (isspace(static_cast<unsigned char>(c))) {
+                i++;
+            } else if (c == '\'' || c == '"') {
+                size_t end = text.find(c, i + 1);
+                if (end == string::npos) {
+                    throw invalid_argument("Unterminated quote at position " + to_string(i + 1));
+                }
+                tokens.push_back({text.substr(i + 1, end - i - 1), true});
+                i = end + 1;
+            } else if (isOperatorChar(c)) {
+                size_t length = (i + 1 < text.size() && (text[i + 1] == '=' || (c == '<' && text[i + 1] == '>'))) ? 2 : 1;
+                tokens.push_back({text.substr(i, length), false});
+                i += length;
+            } else if (c == ',') {
+                tokens.push_back({",", false});
+                i++;
+            } else {
+                size_t start = i;
+                while (i < text.size() && !isspace(static_cast<unsigned char>(text[i])) && !isOperatorChar(text[i]) &&
+                       text[i] != ',' && text[i] != '\'' && text[i] != '"') {
+                    i++;
+                }
+                tokens.push_back({text.substr(start, i - start), false});
+            }
+        }
+        return tokens;
+    }
+
+    bool resolveField(const string& word, QueryField& field, size_t& subjectIndex) {
+        string key = lowercase(word);
+        subjectIndex = 0;
+        if (key == "avg" || key == "average") field = QueryField::Average;
+        else if (key == "gpa") field = QueryField::Gpa;
+        else if (key == "age") field = QueryField::Age;
+        else if (key == "gender" || key == "sex") field = QueryField::Gender;
+        else if (key == "grade" || key == "letter") field = QueryField::Grade;
+        else if (key == "remark") field = QueryField::Remark;
+        else if (key == "name") field = QueryField::Name;
+        else if (key == "id" || key == "studentid") field = QueryField::StudentId;
+        else if (key == "email" || key == "gmail") field = QueryField::Email;
+        else if (key == "dob" || key == "birth") field = QueryField::DateOfBirth;
+        else {
+            auto subjects = GradeUtil::getSubjectNames();
+            for (size_t s = 0; s < subjects.size(); ++s) {
+                if (lowercase(subjects[s]) == key) {
+                    field = QueryField::Subject;
+                    subjectIndex = s;
+                    return true;
+                }
+            }
+            return false;
+        }
+        return true;
+    }
+
+    bool isNumericField(QueryField field) {
+        return field == QueryField::Average || field == QueryField::Gpa ||
+               field == QueryField::Age || field == QueryField::Subject;
+    }
+
+    bool parseOperator(const string& text, CompareOp& op) {
+        string key = lowercase(text);
+        if (key == "=" || key == "==") op = CompareOp::Equal;
+        else if (key == "!=" || key == "<>") op = CompareOp::NotEqual;
+        else if (key == "<") op = CompareOp::Less;
+        else if (key == "<=") op = CompareOp::LessEqual;
+        else if (key == ">") op = CompareOp::Greater;
+        else if (key == ">=") op = CompareOp::GreaterEqual;
+        else if (key == "~" || key == "contains") op = CompareOp::Contains;
+        else return false;
+        return true;
+    }
+
+    const string& textValue(const Student& student, QueryField field) {
+        switch (field) {
+            case QueryField::Gender: return student.getGender();
+            case QueryField::Grade: return student.getLetterGrade();
+            case QueryField::Remark: return student.getRemark();
+            case QueryField::Name: return student.getName();
+            case QueryField::StudentId: return student.getStudentId();
+            case QueryField::Email: return student.getEmail();
+            default: return student.getDateOfBirth();
+        }
+    }
+
+    int compareIgnoreCase(const string& value, const string& lowered) {
+        size_t length = min(value.size(), lowered.size());
+        for (size_t i = 0; i < length; ++i) {
+            int a = tolower(static_cast<unsigned char>(value[i]));
+            int b = static_cast<unsigned char>(lowered[i]);
+            if (a != b) return a < b ? -1 : 1;
+        }
+        return value.size() == lowered.size() ? 0 : (value.size() < lowered.size() ? -1 : 1);
+    }
+
+    bool containsIgnoreCase(const string& value, const string& lowered) {
+        return search(value.begin(), value.end(), lowered.begin(), lowered.end(),
+            [](char a, char b) { return tolower(static_cast<unsigned char>(a)) == b; }) != value.end();
+    }
+
+    bool holds(int comparison, CompareOp op) {
+        switch (op) {
+            case CompareOp::Equal: return comparison == 0;
+            case CompareOp::NotEqual: return comparison != 0;
+            case CompareOp::Less: return comparison < 0;
+            case CompareOp::LessEqual: return comparison <= 0;
+            case CompareOp::Greater: return comparison > 0;
+            case CompareOp::GreaterEqual: return comparison >= 0;
+            case CompareOp::Contains: return false;
+        }
+        return false;
+    }
+
+    // One tight loop per operator instead of a switch per row
+    template <typename Compare>
+    void keepIf(const vector<double>& column, vector<uint32_t>& selection, Compare compare) {
+        size_t kept = 0;
+        for (uint32_t row : selection) {
+            if (compare(column[row])) selection[kept++] = row;
+        }
+        selection.resize(kept);
+    }
+
+    // Cheap numeric scans run before per-row string comparisons
+    int predicateCost(const QueryPredicate& predicate) {
+        if (isNumericField(predicate.field)) return 0;
+        return predicate.op == CompareOp::Contains ? 2 : 1;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// RosterColumns
+// ---------------------------------------------------------------------------
+
+RosterColumns RosterColumns::extract(const std::vector<Student>& students, const std::vector<QueryPredicate>& predicates) {
+    RosterColumns columns;
+    size_t n = students.size();
+    columns.subjects.resize(GradeUtil::getSubjectNames().size());
+
+    for (const auto& predicate : predicates) {
+        switch (predicate.field) {
+            case QueryField::Average:
+                if (columns.average.empty()) {
+                    columns.average.resize(n);
+                    for (size_t i = 0; i < n; ++i) columns.average[i] = students[i].getAverageScore();
+                }
+                break;
+            case QueryField::Gpa:
+                if (columns.gpa.empty()) {
+                    columns.gpa.resize(n);
+                    for (size_t i = 0; i < n; ++i) columns.gpa[i] = students[i].getGpa();
+                }
+                break;
+            case QueryField::Age:
+                if (columns.age.empty()) {
+                    columns.age.resize(n);
+                    for (size_t i = 0; i < n; ++i) columns.age[i] = students[i].getAge();
+                }
+                break;
+            case QueryField::Subject: {
+                auto& subject = columns.subjects[predicate.subjectIndex];
+                if (subject.empty()) {
+                    subject.resize(n);
+                    // Subjects not taken are NaN, so no comparison selects them
+                    for (size_t i = 0; i < n; ++i) {
+                        subject[i] = students[i].hasScore(predicate.subjectIndex)
+                                         ? students[i].getSubjectScores()[predicate.subjectIndex]
+                                         : numeric_limits<double>::quiet_NaN();
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return columns;
+}
+
+const std::vector<double>& RosterColumns::column(const QueryPredicate& predicate) const {
+    switch (predicate.field) {
+        case QueryField::Average: return average;
+        case QueryField::Gpa: return gpa;
+        case QueryField::Age: return age;
+        default: return subjects[predicate.subjectIndex];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// RosterQuery
+// ---------------------------------------------------------------------------
+
+RosterQuery::RosterQuery() : limit(0), hasLimit(false) {}
+
+RosterQuery RosterQuery::parse(const std::string& text) {
+    vector<Token> tokens = tokenize(text);
+    RosterQuery query;
+    size_t position = 0;
+
+    auto atKeyword = [&](const string& keyword) {
+        return position < tokens.size() && !tokens[position].quoted && lowercase(tokens[position].text) == keyword;
+    };
+    auto expectMore = [&](const string& what) {
+        if (position >= tokens.size()) throw invalid_argument("Expected " + what + " at end of query");
+    };
+
+    // Conditions: <field> <op> <value> joined by and / or
+    query.groups.emplace_back();
+    while (position < tokens.size() && !atKeyword("order") && !atKeyword("limit")) {
+        QueryPredicate predicate{QueryField::Average, 0, CompareOp::Equal, 0.0, ""};
+        const string& fieldName = tokens[position].text;
+        if (tokens[position].quoted || !resolveField(fieldName, predicate.field, predicate.subjectIndex)) {
+            throw invalid_argument("Unknown field '" + fieldName + "'");
+        }
+        position++;
+
+        expectMore("an operator after '" + fieldName + "'");
+        if (!parseOperator(tokens[position].text, predicate.op)) {
+            throw invalid_argument("Expected an operator after '" + fieldName + "', found '" + tokens[position].text + "'");
+        }
+        position++;
+
+        expectMore("a value after '" + fieldName + "'");
+        const Token& value = tokens[position++];
+        if (isNumericField(predicate.field)) {
+            if (predicate.op == CompareOp::Contains) {
+                throw invalid_argument("'contains' only applies to text fields, not '" + fieldName + "'");
+            }
+            char* end = nullptr;
+            predicate.number = strtod(value.text.c_str(), &end);
+            if (value.quoted || value.text.empty() || *end != '\0') {
+                throw invalid_argument("Expected a number for '" + fieldName + "', found '" + value.text + "'");
+            }
+        } else {
+            predicate.text = lowercase(value.text);
+        }
+        query.groups.back().push_back(predicate);
+
+        if (atKeyword("and")) {
+            position++;
+            expectMore("a condition after 'and'");
+        } else if (atKeyword("or")) {
+            position++;
+            expectMore("a condition after 'or'");
+            query.groups.emplace_back();
+        } else if (position < tokens.size() && !atKeyword("order") && !atKeyword("limit")) {
+            throw invalid_argument("Expected 'and', 'or', 'order by' or 'limit', found '" + tokens[position].text + "'");
+        }
+    }
+    if (query.groups.back().empty()) {
+        query.groups.clear();   // no conditions: every student matches
+    }
+    for (auto& group : query.groups) {
+        stable_sort(group.begin(), group.end(), [](const QueryPredicate& a, const QueryPredicate& b) {
+            return predicateCost(a) < predicateCost(b);
+        });
+    }
+
+    // order by <field> [asc|desc] {, <field> [asc|desc]}
+    if (atKeyword("order")) {
+        position++;
+        if (!atKeyword("by")) throw invalid_argument("Expected 'by' after 'order'");
+        position++;
+        do {
+            if (position < tokens.size() && tokens[position].text == ",") position++;
+            expectMore("a field after 'order by'");
+            QueryField field;
+            size_t subjectIndex;
+            const string& fieldName = tokens[position].text;
+            if (!resolveField(fieldName, field, subjectIndex)) {
+                throw invalid_argument("Unknown field '" + fieldName + "'");
+            }
+            position++;
+
+            SortSpec spec{SortKey::AverageScore, false, subjectIndex};
+            switch (field) {
+                case QueryField::Average: spec.key = SortKey::AverageScore; break;
+                case QueryField::Gpa: spec.key = SortKey::Gpa; break;
+                case QueryField::Age: spec.key = SortKey::Age; break;
+                case QueryField::Subject: spec.key = SortKey::SubjectScore; break;
+                case QueryField::Name: spec.key = SortKey::Name; break;
+                case QueryField::StudentId: spec.key = SortKey::StudentNumber; break;
+                default:
+                    throw invalid_argument("Cannot order by '" + fieldName + "'");
+            }
+            if (atKeyword("desc")) {
+                spec.descending = true;
+                position++;
+            } else if (atKeyword("asc")) {
+                position++;
+            }
+            query.order.push_back(spec);
+        } while (position < tokens.size() && tokens[position].text == ",");
+    }
+
+    if (atKeyword("limit")) {
+        position++;
+        expectMore("a number after 'limit'");
+        const string& count = tokens[position++].text;
+        if (count.empty() || !all_of(count.begin(), count.end(), [](unsigned char c) { return isdigit(c); })) {
+            throw invalid_argument("Expected a whole number after 'limit', found '" + count + "'");
+        }
+        query.limit = static_cast<size_t>(stoull(count));
+        query.hasLimit = true;
+    }
+
+    if (position < tokens.size()) {
+        throw invalid_argument("Unexpected '" + tokens[position].text + "' at end of query");
+    }
+    return query;
+}
+
+std::vector<std::uint32_t> RosterQuery::run(const std::vector<Student>& students) const {
+    vector<QueryPredicate> all;
+    for (const auto& group : groups) all.insert(all.end(), group.begin(), group.end());
+    RosterColumns columns = RosterColumns::extract(students, all);
+
+    vector<uint32_t> selection;
+    if (groups.empty()) {
+        selection.resize(students.size());
+        iota(selection.begin(), selection.end(), 0u);
+    }
+    for (const auto& group : groups) {
+        vector<uint32_t> matched = filter(students, columns, group);
+        if (selection.empty()) {
+            selection.swap(matched);
+        } else {
+            // Selections stay in row order, so "or" is a linear merge
+            vector<uint32_t> merged;
+            merged.reserve(selection.size() + matched.size());
+            set_union(selection.begin(), selection.end(), matched.begin(), matched.end(), back_inserter(merged));
+            selection.swap(merged);
+        }
+    }
+
+    if (!order.empty()) {
+        SortEngine::sortRows(students, selection, order);
+    }
+    if (hasLimit && selection.size() > limit) {
+        selection.resize(limit);
+    }
+    return selection;
+}
+
+std::string RosterQuery::syntaxHelp() {
+    string subjects;
+    for (const auto& subject : GradeUtil::getSubjectNames()) {
+        subjects += (subjects.empty() ? "" : ", ") + subject;
+    }
+    return "Fields: avg, gpa, age, " + subjects + ", gender, grade, remark, name, id, email, dob\n"
+           "Operators: = != < <= > >= contains (~)   Combine with: and, or\n"
+           "Example: avg < 50 and gender = Female and Mathematics >= 80 order by avg desc limit 20";
+}
+
+std::vector<std::uint32_t> RosterQuery::filter(const std::vector<Student>& students, const RosterColumns& columns,
+                                               const std::vector<QueryPredicate>& group) {
+    vector<uint32_t> selection(students.size());
+    iota(selection.begin(), selection.end(), 0u);
+    for (const auto& predicate : group) {
+        if (selection.empty()) break;
+        narrow(students, columns, predicate, selection);
+    }
+    return selection;
+}
+
+void RosterQuery::narrow(const std::vector<Student>& students, const RosterColumns& columns,
+                         const QueryPredicate& predicate, std::vector<std::uint32_t>& selection) {
+    if (isNumericField(predicate.field)) {
+        const auto& column = columns.column(predicate);
+        double value = predicate.number;
+        switch (predicate.op) {
+            case CompareOp::Equal: keepIf(column, selection, [value](double x) { return x == value; }); break;
+            case CompareOp::NotEqual: keepIf(column, selection, [value](double x) { return x < value || x > value; }); break;
+            case CompareOp::Less: keepIf(column, selection, [value](double x) { return x < value; }); break;
+            case CompareOp::LessEqual: keepIf(column, selection, [value](double x) { return x <= value; }); break;
+            case CompareOp::Greater: keepIf(column, selection, [value](double x) { return x > value; }); break;
+            case CompareOp::GreaterEqual: keepIf(column, selection, [value](double x) { return x >= value; }); break;
+            case CompareOp::Contains: selection.clear(); break;
+        }
+        return;
+    }
+
+    size_t kept = 0;
+    for (uint32_t row : selection) {
+        const string& value = textValue(students[row], predicate.field);
+        bool keep = predicate.op == CompareOp::Contains
+            ? containsIgnoreCase(value, predicate.text)
+            : holds(compareIgnoreCase(value, predicate.text), predicate.op);
+        if (keep) selection[kept++] = row;
+    }
+    selection.resize(kept);
+}
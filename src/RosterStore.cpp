@@ -0,0 +1,89 @@
+#include "RosterStore.hpp"
+#include <algorithm>
+
+using namespace std;
+
+const size_t RosterStore::CHUNK_SIZE = 256;
+
+// ---------------------------------------------------------------------------
+// RosterVersion
+// ---------------------------------------------------------------------------
+
+size_t RosterVersion::size() const {
+    return count;
+}
+
+bool RosterVersion::empty() const {
+    return count == 0;
+}
+
+const Student& RosterVersion::operator[](size_t row) const {
+    // Every chunk but the last is full
+    return (*chunks[row / RosterStore::CHUNK_SIZE])[row % RosterStore::CHUNK_SIZE];
+}
+
+std::uint64_t RosterVersion::number() const {
+    return versionNumber;
+}
+
+size_t RosterVersion::chunkCount() const {
+    return chunks.size();
+}
+
+size_t RosterVersion::sharedChunks() const {
+    return reused;
+}
+
+std::vector<Student> RosterVersion::toVector() const {
+    vector<Student> students;
+    students.reserve(count);
+    for (const auto& chunk : chunks) {
+        students.insert(students.end(), chunk->begin(), chunk->end());
+    }
+    return students;
+}
+
+// ---------------------------------------------------------------------------
+// RosterStore
+// ---------------------------------------------------------------------------
+
+RosterStore::RosterStore() : latest(make_shared<RosterVersion>()) {}
+
+std::shared_ptr<const RosterVersion> RosterStore::current() const {
+    return atomic_load(&latest);
+}
+
+std::uint64_t RosterStore::publish(const std::vector<Student>& students) {
+    lock_guard<mutex> lock(writerMutex);
+    shared_ptr<const RosterVersion> previous = current();
+
+    auto next = make_shared<RosterVersion>();
+    next->count = students.size();
+    next->versionNumber = previous->versionNumber + 1;
+    next->chunks.reserve((students.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+
+    for (size_t begin = 0; begin < students.size(); begin += CHUNK_SIZE) {
+        size_t end = min(students.size(), begin + CHUNK_SIZE);
+        size_t index = begin / CHUNK_SIZE;
+
+        // Rows keep their chunk across versions unless students are inserted
+        // or removed before them, so comparing like-for-like positions finds
+        // every chunk an in-place edit left alone
+        if (index < previous->chunks.size()) {
+            const RosterVersion::Chunk& old = *previous->chunks[index];
+            if (old.size() == end - begin &&
+                equal(old.begin(), old.end(), students.begin() + begin,
+                      [](const Student& a, const Student& b) { return a.sameRecord(b); })) {
+                next->chunks.push_back(previous->chunks[index]);
+                next->reused++;
+                continue;
+            }
+        }
+
+        auto chunk = make_shared<RosterVersion::Chunk>(students.begin() + begin, students.begin() + end);
+        next->chunks.push_back(move(chunk));
+    }
+
+    atomic_store(&latest, shared_ptr<const RosterVersion>(move(next)));
+    return previous->versionNumber + 1;
+}
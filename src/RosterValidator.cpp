@@ -0,0 +1,222 @@
+#include "RosterValidator.hpp"
+#include "Admin.hpp"
+#include "ExcelUtil.hpp"
+#include "GradeUtil.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+
+using namespace std;
+
+namespace {
+    const size_t MIN_ROWS_PER_TASK = 4096;
+
+    // Positions in ExcelUtils::getExcelHeaders()
+    const uint16_t ID_COLUMN = 0;
+    const uint16_t NAME_COLUMN = 1;
+    const uint16_t GENDER_COLUMN = 3;
+    const uint16_t DATE_COLUMN = 4;
+    const uint16_t EMAIL_COLUMN = 5;
+    const uint16_t FIRST_SCORE_COLUMN = 6;
+
+    void addIssue(vector<ValidationIssue>& issues, uint32_t row, uint16_t column, ValidationRule rule) {
+        issues.push_back(ValidationIssue{row, column, rule});
+    }
+
+    string lowercase(const string& text) {
+        string lower = text;
+        transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+        return lower;
+    }
+
+    // FNV-1a, optionally over the lowercased text
+    uint64_t hashKey(const string& text, bool foldCase) {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : text) {
+            hash ^= foldCase ? static_cast<unsigned char>(tolower(c)) : c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    bool sameKey(const string& a, const string& b, bool foldCase) {
+        if (!foldCase) return a == b;
+        return a.size() == b.size() && equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+            return tolower(x) == tolower(y);
+        });
+    }
+
+    // Indexes of students whose key an earlier student already used. Sorting
+    // (hash, index) pairs keeps the whole scan in two flat arrays instead of
+    // a node per student in a hash map; equal hashes are confirmed on the text.
+    template <typename Key>
+    vector<size_t> findDuplicates(const vector<Student>& students, Key key, bool foldCase) {
+        vector<pair<uint64_t, size_t>> keys;
+        keys.reserve(students.size());
+        for (size_t i = 0; i < students.size(); ++i) {
+            const string& text = key(students[i]);
+            if (!text.empty()) keys.emplace_back(hashKey(text, foldCase), i);
+        }
+        sort(keys.begin(), keys.end());
+
+        vector<size_t> duplicates;
+        for (size_t group = 0; group < keys.size();) {
+            size_t end = group + 1;
+            while (end < keys.size() && keys[end].first == keys[group].first) end++;
+            // Within a group rows are in sheet order, so any earlier equal key came first
+            for (size_t i = group + 1; i < end; ++i) {
+                const string& text = key(students[keys[i].second]);
+                for (size_t j = group; j < i; ++j) {
+                    if (sameKey(text, key(students[keys[j].second]), foldCase)) {
+                        duplicates.push_back(keys[i].second);
+                        break;
+                    }
+                }
+            }
+            group = end;
+        }
+        return duplicates;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// ValidationReport
+// ---------------------------------------------------------------------------
+
+size_t ValidationReport::rowsWithIssues() const {
+    size_t rows = 0;
+    for (size_t i = 0; i < issues.size(); ++i) {
+        if (i == 0 || issues[i].row != issues[i - 1].row) rows++;
+    }
+    return rows;
+}
+
+// ---------------------------------------------------------------------------
+// DuplicateTracker
+// ---------------------------------------------------------------------------
+
+void DuplicateTracker::check(const Student& student, std::uint32_t row, std::vector<ValidationIssue>& issues) {
+    checkId(student, row, issues);
+    checkEmail(student, row, issues);
+}
+
+void DuplicateTracker::checkId(const Student& student, std::uint32_t row, std::vector<ValidationIssue>& issues) {
+    const string& id = student.getStudentId();
+    if (!id.empty() && !firstRowById.emplace(id, row).second) {
+        addIssue(issues, row, ID_COLUMN, ValidationRule::DuplicateId);
+    }
+}
+
+void DuplicateTracker::checkEmail(const Student& student, std::uint32_t row, std::vector<ValidationIssue>& issues) {
+    // Empty emails are the Email rule's concern, not duplicates
+    if (!student.getEmail().empty() && !firstRowByEmail.emplace(lowercase(student.getEmail()), row).second) {
+        addIssue(issues, row, EMAIL_COLUMN, ValidationRule::DuplicateEmail);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// RosterValidator
+// ---------------------------------------------------------------------------
+
+ValidationReport RosterValidator::validate(const std::vector<Student>& students,
+                                           const std::vector<std::uint32_t>& sheetRows) {
+    auto start = chrono::steady_clock::now();
+    auto rowOf = [&sheetRows](size_t i) {
+        return i < sheetRows.size() ? sheetRows[i] : static_cast<uint32_t>(i + 2);
+    };
+
+    // The two duplicate scans run as tasks of their own while the row rules
+    // fan out beside them
+    vector<size_t> duplicateIds, duplicateEmails;
+    TaskScheduler& scheduler = TaskScheduler::shared();
+    TaskGroup duplicates(scheduler);
+    duplicates.run([&] {
+        duplicateIds = findDuplicates(students, [](const Student& s) -> const string& { return s.getStudentId(); }, false);
+    });
+    duplicates.run([&] {
+        duplicateEmails = findDuplicates(students, [](const Student& s) -> const string& { return s.getEmail(); }, true);
+    });
+
+    ValidationReport report;
+    report.issues = scheduler.parallelReduce(students.size(), MIN_ROWS_PER_TASK, vector<ValidationIssue>(),
+        [&](size_t begin, size_t end) {
+            vector<ValidationIssue> issues;
+            for (size_t i = begin; i < end; ++i) checkStudent(students[i], rowOf(i), issues);
+            return issues;
+        },
+        [](vector<ValidationIssue>& all, vector<ValidationIssue>& part) {
+            all.insert(all.end(), part.begin(), part.end());
+        });
+    duplicates.wait();
+
+    for (size_t i : duplicateIds) addIssue(report.issues, rowOf(i), ID_COLUMN, ValidationRule::DuplicateId);
+    for (size_t i : duplicateEmails) addIssue(report.issues, rowOf(i), EMAIL_COLUMN, ValidationRule::DuplicateEmail);
+    report.rowsChecked = students.size();
+    finish(report);
+    report.elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+void RosterValidator::checkStudent(const Student& student, std::uint32_t row,
+                                   std::vector<ValidationIssue>& issues, const SheetRow* sheetRow) {
+    if (!Admin::isValidName(student.getName())) addIssue(issues, row, NAME_COLUMN, ValidationRule::Name);
+    if (!Admin::isValidGender(student.getGender())) addIssue(issues, row, GENDER_COLUMN, ValidationRule::Gender);
+    if (!Admin::isValidDate(student.getDateOfBirth())) addIssue(issues, row, DATE_COLUMN, ValidationRule::DateOfBirth);
+    if (!Admin::isValidGmail(student.getEmail())) addIssue(issues, row, EMAIL_COLUMN, ValidationRule::Email);
+
+    const auto& scores = student.getSubjectScores();
+    for (size_t i = 0; i < scores.size(); ++i) {
+        uint16_t column = static_cast<uint16_t>(FIRST_SCORE_COLUMN + i);
+        bool valid;
+        if (sheetRow) {
+            // An empty cell is a subject not taken; anything else must be a score
+            bool present = column < sheetRow->cells.size() && sheetRow->cells[column].present;
+            valid = !present || (sheetRow->cells[column].numeric && GradeUtil::isValidScore(sheetRow->cells[column].number));
+        } else {
+            valid = !student.hasScore(i) || GradeUtil::isValidScore(scores[i]);
+        }
+        if (!valid) addIssue(issues, row, column, ValidationRule::Score);
+    }
+}
+
+void RosterValidator::finish(ValidationReport& report) {
+    stable_sort(report.issues.begin(), report.issues.end(), [](const ValidationIssue& a, const ValidationIssue& b) {
+        return a.row != b.row ? a.row < b.row : a.column < b.column;
+    });
+    report.countByRule.fill(0);
+    for (const auto& issue : report.issues) {
+        report.countByRule[static_cast<size_t>(issue.rule)]++;
+    }
+}
+
+std::string RosterValidator::ruleName(ValidationRule rule) {
+    switch (rule) {
+        case ValidationRule::Name: return "name";
+        case ValidationRule::Email: return "email";
+        case ValidationRule::Gender: return "gender";
+        case ValidationRule::DateOfBirth: return "date-of-birth";
+        case ValidationRule::Score: return "score";
+        case ValidationRule::DuplicateId: return "duplicate-id";
+        case ValidationRule::DuplicateEmail: return "duplicate-email";
+    }
+    return "unknown";
+}
+
+std::string RosterValidator::ruleDescription(ValidationRule rule) {
+    switch (rule) {
+        case ValidationRule::Name: return "Letters and spaces only";
+        case ValidationRule::Email: return "Must be a Gmail address";
+        case ValidationRule::Gender: return "Male, Female or Other";
+        case ValidationRule::DateOfBirth: return "YYYY-MM-DD, 1900 to 2024";
+        case ValidationRule::Score: return "Number from 0 to 100, or empty";
+        case ValidationRule::DuplicateId: return "Student ID used by an earlier row";
+        case ValidationRule::DuplicateEmail: return "Email used by an earlier row";
+    }
+    return "";
+}
+
+std::string RosterValidator::columnName(const ValidationIssue& issue) {
+    static const vector<string> headers = ExcelUtils::getExcelHeaders();
+    return issue.column < headers.size() ? headers[issue.column] : "Column " + to_string(issue.column + 1);
+}
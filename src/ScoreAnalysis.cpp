@@ -0,0 +1,308 @@
+#include "ScoreAnalysis.hpp"
+#include "GradeUtil.hpp"
+#include "TaskScheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+// Iglewicz & Hoaglin's cut-off for modified z-scores
+const double ScoreAnalysis::OUTLIER_THRESHOLD = 3.5;
+
+namespace {
+    const size_t CORRELATION_BLOCK_ROWS = 512;
+    const size_t MIN_ROWS_PER_TASK = 16384;
+    const size_t MEDIAN_BUCKETS = 4096;
+
+    // Scales MAD so robust z matches the ordinary z-score for normal data
+    const double MAD_SCALE = 0.6745;
+
+    // Spreads narrower than this many points are widened to it, so small or
+    // very uniform cohorts do not turn rounding noise into outliers
+    const double MIN_MAD = 1.5;
+
+    const double PERFECT_SCORE = 100.0;
+    const double NEIGHBOURHOOD_START = 95.0;
+
+    struct RobustCentre {
+        double median = 0.0;
+        double mad = 0.0;
+
+        double z(double value) const {
+            return MAD_SCALE * (value - median) / max(mad, MIN_MAD);
+        }
+    };
+
+    // Median of one student's handful of scores: insertion sort beats selection here
+    double smallMedian(vector<double>& values) {
+        for (size_t i = 1; i < values.size(); ++i) {
+            double value = values[i];
+            size_t j = i;
+            for (; j > 0 && values[j - 1] > value; --j) values[j] = values[j - 1];
+            values[j] = value;
+        }
+        size_t middle = values.size() / 2;
+        return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+    }
+}
+
+AnomalyReport ScoreAnalysis::analyze(const std::vector<Student>& students, size_t topOutliers) {
+    auto start = chrono::steady_clock::now();
+
+    AnomalyReport report;
+    report.subjects = GradeUtil::getSubjectNames();
+    size_t subjectCount = report.subjects.size();
+    size_t n = students.size();
+
+    // Column-major copy of the score matrix, with a 0/1 presence column per
+    // subject so absent scores can be masked out arithmetically
+    vector<vector<double>> columns(subjectCount, vector<double>(n, 0.0));
+    vector<vector<double>> presence(subjectCount, vector<double>(n, 0.0));
+    vector<double> ownMedian(n, 0.0);
+    TaskScheduler& scheduler = TaskScheduler::shared();
+    scheduler.parallelFor(n, MIN_ROWS_PER_TASK, [&](size_t begin, size_t end) {
+        vector<double> rowScores;
+        for (size_t i = begin; i < end; ++i) {
+            const auto& scores = students[i].getSubjectScores();
+            uint32_t mask = students[i].getScoreMask();
+            rowScores.assign(subjectCount, 0.0);
+            size_t taken = 0;
+            for (size_t s = 0; s < subjectCount && s < scores.size(); ++s) {
+                unsigned present = (mask >> s) & 1u;
+                columns[s][i] = scores[s];
+                presence[s][i] = present;
+                rowScores[taken] = scores[s];
+                taken += present;
+            }
+            rowScores.resize(taken);
+            ownMedian[i] = taken > 0 ? smallMedian(rowScores) : 0.0;
+        }
+    });
+
+    report.correlation = correlationMatrix(columns, presence);
+
+    // Per subject: cohort centre of the raw scores and of each score's gap
+    // from the student's own median. Subjects are independent, one per task
+    // on large rosters.
+    vector<RobustCentre> cohortCentre(subjectCount), profileCentre(subjectCount);
+    vector<char> spiked(subjectCount, 0);   // not vector<bool>: tasks write neighbouring entries
+    vector<size_t> perfectCounts(subjectCount, 0), neighbourhoodCounts(subjectCount, 0);
+    auto centreSubject = [&](size_t s, vector<double>& scratch) {
+        const auto& column = columns[s];
+        const auto& present = presence[s];
+
+        // Each pass compacts the students who took the subject into scratch:
+        // every value is written, only present ones advance the cursor
+        auto gather = [&](auto valueOf) {
+            scratch.resize(n);
+            size_t taken = 0;
+            for (size_t i = 0; i < n; ++i) {
+                scratch[taken] = valueOf(i);
+                taken += static_cast<size_t>(present[i]);
+            }
+            scratch.resize(taken);
+        };
+
+        gather([&](size_t i) { return column[i]; });
+        cohortCentre[s].median = median(scratch);
+        gather([&](size_t i) { return fabs(column[i] - cohortCentre[s].median); });
+        cohortCentre[s].mad = median(scratch);
+
+        gather([&](size_t i) { return column[i] - ownMedian[i]; });
+        profileCentre[s].median = median(scratch);
+        gather([&](size_t i) { return fabs(column[i] - ownMedian[i] - profileCentre[s].median); });
+        profileCentre[s].mad = median(scratch);
+
+        // Exact 100s far above the density just below them suggest data entry
+        size_t perfect = 0, neighbourhood = 0;
+        for (double score : column) {
+            if (score == PERFECT_SCORE) perfect++;
+            else if (score >= NEIGHBOURHOOD_START) neighbourhood++;
+        }
+        size_t expected = max<size_t>(1, neighbourhood / static_cast<size_t>(PERFECT_SCORE - NEIGHBOURHOOD_START));
+        spiked[s] = perfect > 2 * expected;
+        perfectCounts[s] = perfect;
+        neighbourhoodCounts[s] = neighbourhood;
+    };
+
+    size_t subjectsPerTask = n >= MIN_ROWS_PER_TASK ? 1 : subjectCount;
+    scheduler.parallelFor(subjectCount, subjectsPerTask, [&](size_t begin, size_t end) {
+        vector<double> scratch(n);
+        for (size_t s = begin; s < end; ++s) centreSubject(s, scratch);
+    });
+    for (size_t s = 0; s < subjectCount; ++s) {
+        if (spiked[s]) report.spikes.push_back({s, perfectCounts[s], neighbourhoodCounts[s]});
+    }
+
+    for (size_t s = 0; s < subjectCount; ++s) {
+        const auto& column = columns[s];
+        const auto& present = presence[s];
+        for (size_t i = 0; i < n; ++i) {
+            double profileZ = profileCentre[s].z(column[i] - ownMedian[i]);
+            double cohortZ = cohortCentre[s].z(column[i]);
+            if (present[i] != 0.0 && (fabs(profileZ) > OUTLIER_THRESHOLD || fabs(cohortZ) > OUTLIER_THRESHOLD)) {
+                report.outliers.push_back({static_cast<uint32_t>(i), s, column[i], cohortZ, profileZ});
+            }
+        }
+    }
+    report.flaggedScores = report.outliers.size();
+
+    auto strength = [](const ScoreOutlier& o) { return max(fabs(o.profileZ), fabs(o.cohortZ)); };
+    auto stronger = [&strength](const ScoreOutlier& a, const ScoreOutlier& b) { return strength(a) > strength(b); };
+    if (report.outliers.size() > topOutliers) {
+        partial_sort(report.outliers.begin(), report.outliers.begin() + topOutliers, report.outliers.end(), stronger);
+        report.outliers.resize(topOutliers);
+    } else {
+        sort(report.outliers.begin(), report.outliers.end(), stronger);
+    }
+
+    report.elapsedMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+// Pearson correlation over the students who took both subjects. Each block
+// of rows is transposed into small row-major tiles (centred values, zero
+// where absent, and 0/1 presence) and every subject pair is accumulated from
+// those tiles before moving on. Presence weights the sums, so the inner loop
+// has no branches.
+std::vector<std::vector<double>> ScoreAnalysis::correlationMatrix(const std::vector<std::vector<double>>& columns,
+                                                                  const std::vector<std::vector<double>>& presence) {
+    size_t k = columns.size();
+    size_t n = k > 0 ? columns[0].size() : 0;
+    vector<vector<double>> correlation(k, vector<double>(k, 0.0));
+    if (n < 2) return correlation;
+
+    vector<double> means(k, 0.0);
+    for (size_t s = 0; s < k; ++s) {
+        double sum = 0.0, count = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += columns[s][i] * presence[s][i];
+            count += presence[s][i];
+        }
+        means[s] = count > 0.0 ? sum / count : 0.0;
+    }
+
+    // Per pair: joint count, sums and sums of squares of each side over the
+    // joint rows, and the cross-product
+    struct PairSums {
+        double count = 0.0, sumA = 0.0, sumB = 0.0, squaresA = 0.0, squaresB = 0.0, products = 0.0;
+    };
+    // Runs of blocks are summed independently and added together in order
+    auto accumulateBlocks = [&](size_t firstBlock, size_t lastBlock) {
+        vector<PairSums> pairs(k * k);
+        vector<double> tile(CORRELATION_BLOCK_ROWS * k), maskTile(CORRELATION_BLOCK_ROWS * k);
+        for (size_t block = firstBlock; block < lastBlock; ++block) {
+            size_t begin = block * CORRELATION_BLOCK_ROWS;
+            size_t rows = min(CORRELATION_BLOCK_ROWS, n - begin);
+            for (size_t s = 0; s < k; ++s) {
+                const double* column = columns[s].data() + begin;
+                const double* present = presence[s].data() + begin;
+                for (size_t r = 0; r < rows; ++r) {
+                    tile[r * k + s] = (column[r] - means[s]) * present[r];
+                    maskTile[r * k + s] = present[r];
+                }
+            }
+            for (size_t r = 0; r < rows; ++r) {
+                const double* row = &tile[r * k];
+                const double* mask = &maskTile[r * k];
+                for (size_t a = 0; a < k; ++a) {
+                    double valueA = row[a], maskA = mask[a];
+                    for (size_t b = a + 1; b < k; ++b) {
+                        PairSums& pair = pairs[a * k + b];
+                        double valueB = row[b], maskB = mask[b];
+                        pair.count += maskA * maskB;
+                        pair.sumA += valueA * maskB;
+                        pair.sumB += valueB * maskA;
+                        pair.squaresA += valueA * valueA * maskB;
+                        pair.squaresB += valueB * valueB * maskA;
+                        pair.products += valueA * valueB;
+                    }
+                }
+            }
+        }
+        return pairs;
+    };
+    auto addPairs = [](vector<PairSums>& total, vector<PairSums>& part) {
+        for (size_t p = 0; p < total.size(); ++p) {
+            total[p].count += part[p].count;
+            total[p].sumA += part[p].sumA;
+            total[p].sumB += part[p].sumB;
+            total[p].squaresA += part[p].squaresA;
+            total[p].squaresB += part[p].squaresB;
+            total[p].products += part[p].products;
+        }
+    };
+    size_t blocks = (n + CORRELATION_BLOCK_ROWS - 1) / CORRELATION_BLOCK_ROWS;
+    vector<PairSums> pairs = TaskScheduler::shared().parallelReduce(
+        blocks, MIN_ROWS_PER_TASK / CORRELATION_BLOCK_ROWS, vector<PairSums>(k * k), accumulateBlocks, addPairs);
+
+    for (size_t a = 0; a < k; ++a) {
+        correlation[a][a] = 1.0;
+        for (size_t b = a + 1; b < k; ++b) {
+            const PairSums& pair = pairs[a * k + b];
+            double r = 0.0;
+            if (pair.count >= 2.0) {
+                double covariance = pair.products - pair.sumA * pair.sumB / pair.count;
+                double varianceA = pair.squaresA - pair.sumA * pair.sumA / pair.count;
+                double varianceB = pair.squaresB - pair.sumB * pair.sumB / pair.count;
+                double denominator = sqrt(max(0.0, varianceA) * max(0.0, varianceB));
+                r = denominator > 0.0 ? covariance / denominator : 0.0;
+            }
+            correlation[a][b] = correlation[b][a] = r;
+        }
+    }
+    return correlation;
+}
+
+// Exact median without reordering: a histogram pass finds the bucket(s)
+// holding the middle rank(s), and only those values go through selection.
+// Much cheaper than nth_element over the whole column when it runs dozens
+// of times per analysis.
+double ScoreAnalysis::median(const std::vector<double>& values) {
+    if (values.empty()) return 0.0;
+    size_t middle = values.size() / 2;
+    size_t lowRank = values.size() % 2 == 1 ? middle : middle - 1;
+
+    if (values.size() < MEDIAN_BUCKETS) {
+        vector<double> copy(values);
+        nth_element(copy.begin(), copy.begin() + middle, copy.end());
+        double upper = copy[middle];
+        if (lowRank == middle) return upper;
+        return (*max_element(copy.begin(), copy.begin() + middle) + upper) / 2.0;
+    }
+
+    auto range = minmax_element(values.begin(), values.end());
+    double low = *range.first, high = *range.second;
+    if (low == high) return low;
+
+    double scale = static_cast<double>(MEDIAN_BUCKETS) / (high - low);
+    auto bucketOf = [&](double value) {
+        return min(MEDIAN_BUCKETS - 1, static_cast<size_t>((value - low) * scale));
+    };
+
+    vector<size_t> counts(MEDIAN_BUCKETS, 0);
+    for (double value : values) counts[bucketOf(value)]++;
+
+    // Buckets containing the two middle ranks; everything between is gathered
+    size_t firstBucket = 0, before = 0;
+    while (before + counts[firstBucket] <= lowRank) {
+        before += counts[firstBucket++];
+    }
+    size_t lastBucket = firstBucket, through = before + counts[firstBucket];
+    while (through <= middle) {
+        through += counts[++lastBucket];
+    }
+
+    vector<double> candidates;
+    candidates.reserve(through - before);
+    for (double value : values) {
+        size_t bucket = bucketOf(value);
+        if (bucket >= firstBucket && bucket <= lastBucket) candidates.push_back(value);
+    }
+    size_t upperOffset = middle - before;
+    nth_element(candidates.begin(), candidates.begin() + upperOffset, candidates.end());
+    double upper = candidates[upperOffset];
+    if (lowRank == middle) return upper;
+    return (*max_element(candidates.begin(), candidates.begin() + upperOffset) + upper) / 2.0;
+}
@@ -0,0 +1,168 @@
+#include "Screen.hpp"
+#include "MenuUtils.hpp"
+#include <cstdlib>
+#include <iostream>
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/ioctl.h>
+    #include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+    const char* const CLEAR_AND_HOME = "\033[H\033[2J";
+
+    vector<string> splitLines(const string& frame) {
+        vector<string> lines;
+        size_t start = 0;
+        while (true) {
+            size_t newline = frame.find('\n', start);
+            if (newline == string::npos) {
+                lines.push_back(frame.substr(start));
+                return lines;
+            }
+            lines.push_back(frame.substr(start, newline - start));
+            start = newline + 1;
+        }
+    }
+
+    // Columns a line takes on screen: escape sequences take none and
+    // UTF-8 continuation bytes add nothing
+    size_t visibleWidth(const string& line) {
+        size_t width = 0;
+        for (size_t i = 0; i < line.size(); ++i) {
+            if (line[i] == '\033' && i + 1 < line.size() && line[i + 1] == '[') {
+                i += 2;
+                while (i < line.size() && !(line[i] >= '@' && line[i] <= '~')) i++;
+                continue;
+            }
+            if ((static_cast<unsigned char>(line[i]) & 0xC0) != 0x80) width++;
+        }
+        return width;
+    }
+
+    void appendCursorTo(string& out, size_t line) {
+        out += "\033[";
+        out += to_string(line + 1);
+        out += ";1H";
+    }
+}
+
+bool Screen::supportsAnsi() {
+    if (!MenuUtils::isTerminalOutput()) return false;
+#ifdef _WIN32
+    // Windows 10 consoles understand escape sequences once asked to
+    static const bool enabled = [] {
+        HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+        DWORD mode = 0;
+        if (!GetConsoleMode(console, &mode)) return false;
+        return SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING) != 0;
+    }();
+    return enabled;
+#else
+    const char* term = getenv("TERM");
+    return !(term && string(term) == "dumb");
+#endif
+}
+
+void Screen::clear() {
+    if (!MenuUtils::isTerminalOutput()) return;
+    if (supportsAnsi()) {
+        cout << CLEAR_AND_HOME << flush;
+        return;
+    }
+#ifdef _WIN32
+    // Older consoles: blank the buffer through the console API
+    cout.flush();
+    HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(console, &info)) return;
+    DWORD cells = static_cast<DWORD>(info.dwSize.X) * info.dwSize.Y;
+    DWORD written = 0;
+    COORD home = {0, 0};
+    FillConsoleOutputCharacterA(console, ' ', cells, home, &written);
+    FillConsoleOutputAttribute(console, info.wAttributes, cells, home, &written);
+    SetConsoleCursorPosition(console, home);
+#endif
+}
+
+int Screen::rows() {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        return info.srWindow.Bottom - info.srWindow.Top + 1;
+    }
+#else
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0) {
+        return size.ws_row;
+    }
+#endif
+    // Not a console, or it would not say: the shell's idea, then the classic default
+    const char* lines = getenv("LINES");
+    int fromEnvironment = lines ? atoi(lines) : 0;
+    return fromEnvironment > 0 ? fromEnvironment : 24;
+}
+
+int Screen::columns() {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        return info.srWindow.Right - info.srWindow.Left + 1;
+    }
+#else
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) {
+        return size.ws_col;
+    }
+#endif
+    const char* columns = getenv("COLUMNS");
+    int fromEnvironment = columns ? atoi(columns) : 0;
+    return fromEnvironment > 0 ? fromEnvironment : 80;
+}
+
+void Screen::present(const std::string& frame) {
+    if (!MenuUtils::isTerminalOutput()) {
+        cout << frame << flush;
+        return;
+    }
+
+    vector<string> lines = splitLines(frame);
+    // Line positions are only known while nothing wraps or scrolls
+    bool fits = static_cast<int>(lines.size()) < rows();
+    size_t width = static_cast<size_t>(columns());
+    for (const auto& line : lines) {
+        if (!fits) break;
+        fits = visibleWidth(line) < width;
+    }
+
+    string out;
+    if (!valid || !fits || !supportsAnsi()) {
+        clear();
+        out = frame;
+    } else {
+        for (size_t i = 0; i + 1 < lines.size(); ++i) {
+            if (i < shown.size() && shown[i] == lines[i]) continue;
+            appendCursorTo(out, i);
+            out += lines[i];
+            out += "\033[K";
+        }
+        // The prompt line also holds the last answer typed, and the lines
+        // below it whatever the previous frame left there
+        appendCursorTo(out, lines.size() - 1);
+        out += "\033[J";
+        out += lines.back();
+    }
+    cout.write(out.data(), static_cast<streamsize>(out.size()));
+    cout.flush();
+
+    shown = std::move(lines);
+    valid = fits && supportsAnsi();
+}
+
+void Screen::invalidate() {
+    valid = false;
+    shown.clear();
+}
@@ -0,0 +1,357 @@
+#include "SearchIndex.hpp"
+#include <algorithm>
+#include <cctype>
+#include <unordered_map>
+
+using namespace std;
+
+const double SearchIndex::FUZZY_ACCEPT_SCORE = 0.7;
+
+namespace {
+    const uint32_t NO_NODE = 0xFFFFFFFFu;
+
+    // Caps on how much of the index one query may touch
+    const size_t PREFIX_CANDIDATE_LIMIT = 256;
+    const size_t FUZZY_CANDIDATE_LIMIT = 64;
+
+    const double EXACT_NAME_SCORE = 0.98;
+    const double PREFIX_BASE_SCORE = 0.6;
+    const double PREFIX_COVERAGE_WEIGHT = 0.3;
+    const double FUZZY_MAX_SCORE = 0.9;
+
+    // One typo per four characters, never more than three
+    int allowedDistance(size_t queryLength) {
+        return static_cast<int>(min<size_t>(3, max<size_t>(1, queryLength / 4)));
+    }
+
+    // Query matches the start of the name or the start of any later token.
+    // Returns a score in [PREFIX_BASE_SCORE, 0.9], or -1 when it does not match.
+    double prefixScore(const string& query, const string& name) {
+        size_t position = 0;
+        while (position != string::npos) {
+            if (name.compare(position, query.size(), query) == 0) {
+                double coverage = static_cast<double>(query.size()) / static_cast<double>(name.size() - position);
+                return PREFIX_BASE_SCORE + PREFIX_COVERAGE_WEIGHT * min(1.0, coverage);
+            }
+            position = name.find(' ', position);
+            if (position != string::npos) position++;
+        }
+        return -1.0;
+    }
+
+    double fuzzyScore(int distance, size_t queryLength, size_t targetLength) {
+        double length = static_cast<double>(max(queryLength, targetLength));
+        return FUZZY_MAX_SCORE * (1.0 - static_cast<double>(distance) / length);
+    }
+}
+
+SearchIndex::SearchIndex() {
+    trie.push_back({'\0', NO_NODE, NO_NODE, -1});
+}
+
+void SearchIndex::rebuild(const std::vector<Student>& students) {
+    trie.assign(1, {'\0', NO_NODE, NO_NODE, -1});
+    tokenPostings.clear();
+    trigramPostings.clear();
+    idIndex.clear();
+    names.clear();
+    ids.clear();
+
+    names.reserve(students.size());
+    ids.reserve(students.size());
+    idIndex.reserve(students.size());
+    for (size_t row = 0; row < students.size(); ++row) {
+        add(static_cast<uint32_t>(row), students[row]);
+    }
+}
+
+void SearchIndex::add(std::uint32_t row, const Student& student) {
+    if (row >= names.size()) {
+        names.resize(row + 1);
+        ids.resize(row + 1);
+    }
+
+    ids[row] = normalize(student.getStudentId());
+    idIndex[ids[row]] = row;
+
+    names[row] = normalize(student.getName());
+    for (const auto& token : tokenize(names[row])) {
+        insertToken(token, row);
+    }
+    for (uint32_t gram : trigrams(names[row])) {
+        auto& postings = trigramPostings[gram];
+        if (postings.empty() || postings.back() != row) postings.push_back(row);
+    }
+}
+
+// Old postings are left in place; every candidate is checked against the
+// current normalized name, so stale entries only cost a comparison.
+void SearchIndex::update(std::uint32_t row, const Student& student) {
+    if (row >= names.size()) {
+        add(row, student);
+        return;
+    }
+
+    auto previous = idIndex.find(ids[row]);
+    if (previous != idIndex.end() && previous->second == row) {
+        idIndex.erase(previous);
+    }
+    if (names[row] == normalize(student.getName())) {
+        ids[row] = normalize(student.getStudentId());
+        idIndex[ids[row]] = row;
+        return;
+    }
+    add(row, student);
+}
+
+std::vector<SearchHit> SearchIndex::search(const std::string& term, size_t limit) const {
+    string query = normalize(term);
+    if (query.empty() || limit == 0) return {};
+
+    unordered_map<uint32_t, SearchHit> best;
+    auto offer = [&best](const SearchHit& hit) {
+        auto it = best.find(hit.row);
+        if (it == best.end()) {
+            best.emplace(hit.row, hit);
+        } else if (hit.score > it->second.score) {
+            it->second = hit;
+        }
+    };
+
+    // 1. Student ID
+    auto id = idIndex.find(query);
+    if (id != idIndex.end()) {
+        offer({id->second, MatchKind::ExactId, 1.0, 0});
+    }
+
+    // 2. Exact and prefix matches. Every query token is a prefix of some name
+    //    token, so walking the trie with the longest one gives the fewest rows.
+    vector<string> queryTokens = tokenize(query);
+    const string& anchor = *max_element(queryTokens.begin(), queryTokens.end(),
+        [](const string& a, const string& b) { return a.size() < b.size(); });
+    vector<uint32_t> candidates;
+    collectPrefix(anchor, candidates, PREFIX_CANDIDATE_LIMIT);
+    for (uint32_t row : candidates) {
+        const string& name = names[row];
+        if (name == query) {
+            offer({row, MatchKind::ExactName, EXACT_NAME_SCORE, 0});
+            continue;
+        }
+        double score = prefixScore(query, name);
+        if (score >= 0.0) {
+            offer({row, MatchKind::Prefix, score, 0});
+        }
+    }
+
+    // 3. Fuzzy matches: rows sharing the most trigrams with the query are the
+    //    only ones that pay for an edit distance.
+    vector<uint32_t> queryGrams = trigrams(query);
+    sort(queryGrams.begin(), queryGrams.end());
+    queryGrams.erase(unique(queryGrams.begin(), queryGrams.end()), queryGrams.end());
+
+    vector<uint16_t> shared(names.size(), 0);
+    vector<uint32_t> touched;
+    for (uint32_t gram : queryGrams) {
+        auto postings = trigramPostings.find(gram);
+        if (postings == trigramPostings.end()) continue;
+        for (uint32_t row : postings->second) {
+            if (shared[row]++ == 0) touched.push_back(row);
+        }
+    }
+
+    // A single edit destroys at most three trigrams
+    int maxDistance = allowedDistance(query.size());
+    size_t minShared = queryGrams.size() > static_cast<size_t>(3 * maxDistance)
+        ? queryGrams.size() - 3 * maxDistance : 1;
+    touched.erase(remove_if(touched.begin(), touched.end(),
+        [&](uint32_t row) { return shared[row] < minShared; }), touched.end());
+    if (touched.size() > FUZZY_CANDIDATE_LIMIT) {
+        nth_element(touched.begin(), touched.begin() + FUZZY_CANDIDATE_LIMIT, touched.end(),
+            [&shared](uint32_t a, uint32_t b) { return shared[a] > shared[b]; });
+        touched.resize(FUZZY_CANDIDATE_LIMIT);
+    }
+
+    for (uint32_t row : touched) {
+        if (best.count(row)) continue;   // already matched exactly or by prefix
+        const string& name = names[row];
+        int distance = min(editDistance(query, name, maxDistance),
+                           bestTokenDistance(query, name, maxDistance));
+        if (distance <= maxDistance) {
+            offer({row, MatchKind::Fuzzy, fuzzyScore(distance, query.size(), name.size()), distance});
+        }
+    }
+
+    vector<SearchHit> hits;
+    hits.reserve(best.size());
+    for (const auto& entry : best) hits.push_back(entry.second);
+    sort(hits.begin(), hits.end(), [](const SearchHit& a, const SearchHit& b) {
+        return a.score != b.score ? a.score > b.score : a.row < b.row;
+    });
+    if (hits.size() > limit) hits.resize(limit);
+    return hits;
+}
+
+size_t SearchIndex::size() const {
+    return names.size();
+}
+
+// Lowercase letters and digits; every run of anything else becomes one space
+std::string SearchIndex::normalize(const std::string& text) {
+    string normalized;
+    normalized.reserve(text.size());
+    bool pendingSpace = false;
+    for (char c : text) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (isalnum(byte) || byte >= 0x80) {
+            if (pendingSpace && !normalized.empty()) normalized.push_back(' ');
+            pendingSpace = false;
+            normalized.push_back(static_cast<char>(tolower(byte)));
+        } else {
+            pendingSpace = true;
+        }
+    }
+    return normalized;
+}
+
+// Levenshtein distance, giving up (returning maxDistance + 1) as soon as the
+// bound cannot be met
+int SearchIndex::editDistance(const std::string& a, const std::string& b, int maxDistance) {
+    int lengthA = static_cast<int>(a.size());
+    int lengthB = static_cast<int>(b.size());
+    if (abs(lengthA - lengthB) > maxDistance) return maxDistance + 1;
+
+    vector<int> previous(lengthB + 1), current(lengthB + 1);
+    for (int j = 0; j <= lengthB; ++j) previous[j] = j;
+
+    for (int i = 1; i <= lengthA; ++i) {
+        current[0] = i;
+        int rowMinimum = current[0];
+        for (int j = 1; j <= lengthB; ++j) {
+            int substitution = previous[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+            current[j] = min({previous[j] + 1, current[j - 1] + 1, substitution});
+            rowMinimum = min(rowMinimum, current[j]);
+        }
+        if (rowMinimum > maxDistance) return maxDistance + 1;
+        previous.swap(current);
+    }
+    return min(previous[lengthB], maxDistance + 1);
+}
+
+// Score for one term against one name, for callers without an index
+double SearchIndex::similarity(const std::string& term, const std::string& name) {
+    string query = normalize(term);
+    string target = normalize(name);
+    if (query.empty() || target.empty()) return 0.0;
+    if (query == target) return 1.0;
+
+    double score = prefixScore(query, target);
+    if (score >= 0.0) return score;
+
+    int maxDistance = allowedDistance(query.size());
+    int distance = min(editDistance(query, target, maxDistance),
+                       bestTokenDistance(query, target, maxDistance));
+    return distance <= maxDistance ? fuzzyScore(distance, query.size(), target.size()) : 0.0;
+}
+
+std::string SearchIndex::matchKindLabel(MatchKind kind) {
+    switch (kind) {
+        case MatchKind::ExactId: return "Student ID";
+        case MatchKind::ExactName: return "Exact name";
+        case MatchKind::Prefix: return "Prefix";
+        case MatchKind::Fuzzy: return "Similar name";
+    }
+    return "";
+}
+
+void SearchIndex::insertToken(const std::string& token, std::uint32_t row) {
+    uint32_t node = 0;
+    for (char c : token) {
+        uint32_t child = trie[node].firstChild;
+        while (child != NO_NODE && trie[child].label != c) {
+            child = trie[child].nextSibling;
+        }
+        if (child == NO_NODE) {
+            child = static_cast<uint32_t>(trie.size());
+            trie.push_back({c, NO_NODE, trie[node].firstChild, -1});
+            trie[node].firstChild = child;
+        }
+        node = child;
+    }
+
+    if (trie[node].postings < 0) {
+        trie[node].postings = static_cast<int32_t>(tokenPostings.size());
+        tokenPostings.emplace_back();
+    }
+    auto& postings = tokenPostings[trie[node].postings];
+    if (postings.empty() || postings.back() != row) postings.push_back(row);
+}
+
+// Rows with a token starting with prefix, stopping once limit rows are found
+void SearchIndex::collectPrefix(const std::string& prefix, std::vector<std::uint32_t>& rows, size_t limit) const {
+    uint32_t node = 0;
+    for (char c : prefix) {
+        node = trie[node].firstChild;
+        while (node != NO_NODE && trie[node].label != c) {
+            node = trie[node].nextSibling;
+        }
+        if (node == NO_NODE) return;
+    }
+
+    vector<uint32_t> stack = {node};
+    while (!stack.empty() && rows.size() < limit) {
+        uint32_t current = stack.back();
+        stack.pop_back();
+        if (trie[current].postings >= 0) {
+            for (uint32_t row : tokenPostings[trie[current].postings]) {
+                rows.push_back(row);
+                if (rows.size() >= limit) break;
+            }
+        }
+        for (uint32_t child = trie[current].firstChild; child != NO_NODE; child = trie[child].nextSibling) {
+            stack.push_back(child);
+        }
+    }
+}
+
+std::vector<std::string> SearchIndex::tokenize(const std::string& normalized) {
+    vector<string> tokens;
+    size_t start = 0;
+    while (start < normalized.size()) {
+        size_t end = normalized.find(' ', start);
+        if (end == string::npos) end = normalized.size();
+        if (end > start) tokens.push_back(normalized.substr(start, end - start));
+        start = end + 1;
+    }
+    return tokens;
+}
+
+// Trigrams of each token padded with '$' at both ends, packed into 24 bits
+std::vector<std::uint32_t> SearchIndex::trigrams(const std::string& normalized) {
+    vector<uint32_t> grams;
+    for (const auto& token : tokenize(normalized)) {
+        string padded = "$" + token + "$";
+        for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+            grams.push_back((static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16) |
+                            (static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8) |
+                             static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 2])));
+        }
+    }
+    return grams;
+}
+
+// Distance from the query to the closest run of the same number of name
+// tokens, so "sophany" still finds "nai sophanny"
+int SearchIndex::bestTokenDistance(const std::string& query, const std::string& name, int maxDistance) {
+    size_t queryTokenCount = tokenize(query).size();
+    vector<string> nameTokens = tokenize(name);
+    int best = maxDistance + 1;
+    for (size_t start = 0; start + queryTokenCount <= nameTokens.size(); ++start) {
+        string window = nameTokens[start];
+        for (size_t t = 1; t < queryTokenCount; ++t) {
+            window += " " + nameTokens[start + t];
+        }
+        best = min(best, editDistance(query, window, maxDistance));
+        if (best == 0) break;
+    }
+    return best;
+}
@@ -0,0 +1,235 @@
+#include "SortEngine.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <numeric>
+
+using namespace std;
+
+namespace {
+    // Below this size a comparison sort on the flat keys beats radix setup
+    const size_t RADIX_THRESHOLD = 2048;
+    const int RADIX_BITS = 11;
+    const int RADIX_PASSES = (64 + RADIX_BITS - 1) / RADIX_BITS;
+    const size_t RADIX_BUCKETS = size_t(1) << RADIX_BITS;
+
+    // Map a double onto an unsigned integer with the same ordering
+    uint64_t orderedBits(double value) {
+        if (value == 0.0) value = 0.0;   // fold -0.0 onto +0.0
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return (bits & (uint64_t(1) << 63)) ? ~bits : bits | (uint64_t(1) << 63);
+    }
+}
+
+std::vector<std::uint32_t> SortEngine::sortedPermutation(const std::vector<Student>& students,
+                                                         const std::vector<SortSpec>& order) {
+    vector<uint32_t> permutation(students.size());
+    iota(permutation.begin(), permutation.end(), 0u);
+    sortRows(students, permutation, order);
+    return permutation;
+}
+
+void SortEngine::sortRows(const std::vector<Student>& students, std::vector<std::uint32_t>& rows,
+                          const std::vector<SortSpec>& order) {
+    // Stable passes from the least significant key to the most significant
+    for (auto spec = order.rbegin(); spec != order.rend(); ++spec) {
+        radixSortByKey(rows, extractKeys(students, rows, *spec));
+    }
+}
+
+void SortEngine::applyPermutation(std::vector<Student>& students, const std::vector<std::uint32_t>& permutation) {
+    vector<Student> reordered;
+    reordered.reserve(permutation.size());
+    for (uint32_t index : permutation) {
+        reordered.push_back(std::move(students[index]));
+    }
+    students.swap(reordered);
+}
+
+// "STU012" -> 12; anything else sorts as 0 (same rule reorderStudentIds always used)
+int SortEngine::parseStudentNumber(const std::string& studentId) {
+    if (studentId.length() < 6 || studentId.compare(0, 3, "STU") != 0) return 0;
+
+    long long number = 0;
+    for (size_t i = 3; i < studentId.length() && isdigit(static_cast<unsigned char>(studentId[i])); ++i) {
+        number = number * 10 + (studentId[i] - '0');
+        if (number > 1000000000LL) return 0;
+    }
+    return static_cast<int>(number);
+}
+
+std::string SortEngine::collationKey(const std::string& name) {
+    string key;
+    key.reserve(name.size());
+    bool pendingSpace = false;
+    for (char c : name) {
+        if (isspace(static_cast<unsigned char>(c))) {
+            pendingSpace = !key.empty();
+            continue;
+        }
+        if (pendingSpace) {
+            key.push_back(' ');
+            pendingSpace = false;
+        }
+        key.push_back(static_cast<char>(tolower(static_cast<unsigned char>(c))));
+    }
+    return key;
+}
+
+std::vector<std::uint64_t> SortEngine::extractKeys(const std::vector<Student>& students,
+                                                   const std::vector<std::uint32_t>& rows, const SortSpec& spec) {
+    vector<uint64_t> keys(students.size());
+
+    switch (spec.key) {
+        case SortKey::AverageScore:
+            for (uint32_t row : rows) {
+                keys[row] = orderedBits(students[row].getAverageScore());
+            }
+            break;
+        case SortKey::StudentNumber:
+            for (uint32_t row : rows) {
+                keys[row] = static_cast<uint64_t>(parseStudentNumber(students[row].getStudentId()));
+            }
+            break;
+        case SortKey::Name: {
+            // Strings become dense ranks so the radix passes stay integer-only
+            vector<string> collation(rows.size());
+            for (size_t i = 0; i < rows.size(); ++i) {
+                collation[i] = collationKey(students[rows[i]].getName());
+            }
+            vector<uint64_t> ranks = rankStrings(collation);
+            for (size_t i = 0; i < rows.size(); ++i) {
+                keys[rows[i]] = ranks[i];
+            }
+            break;
+        }
+        case SortKey::Gpa:
+            for (uint32_t row : rows) {
+                keys[row] = orderedBits(students[row].getGpa());
+            }
+            break;
+        case SortKey::Age:
+            for (uint32_t row : rows) {
+                keys[row] = orderedBits(static_cast<double>(students[row].getAge()));
+            }
+            break;
+        case SortKey::SubjectScore:
+            // A subject not taken ranks below every real score
+            for (uint32_t row : rows) {
+                const Student& student = students[row];
+                keys[row] = orderedBits(student.hasScore(spec.subjectIndex) ? student.getSubjectScores()[spec.subjectIndex] : -1.0);
+            }
+            break;
+    }
+
+    if (spec.descending) {
+        for (uint32_t row : rows) keys[row] = ~keys[row];
+    }
+    return keys;
+}
+
+// MSD refinement: radix-sort on bytes [0, 8), then re-sort each run of equal
+// chunks on bytes [8, 16), and so on. Only genuinely tied prefixes are revisited.
+std::vector<std::uint64_t> SortEngine::rankStrings(const std::vector<std::string>& values) {
+    size_t n = values.size();
+    vector<uint32_t> order(n);
+    iota(order.begin(), order.end(), 0u);
+    vector<uint64_t> chunks(n);
+
+    struct Run { size_t begin; size_t end; size_t offset; };
+    vector<Run> pending = {{0, n, 0}};
+    while (!pending.empty()) {
+        Run run = pending.back();
+        pending.pop_back();
+
+        if (run.end - run.begin < RADIX_THRESHOLD / 16) {
+            sort(order.begin() + run.begin, order.begin() + run.end,
+                [&values](uint32_t a, uint32_t b) { return values[a] < values[b]; });
+            continue;
+        }
+
+        for (size_t i = run.begin; i < run.end; ++i) {
+            chunks[order[i]] = stringChunk(values[order[i]], run.offset);
+        }
+        vector<uint32_t> slice(order.begin() + run.begin, order.begin() + run.end);
+        radixSortByKey(slice, chunks);
+        copy(slice.begin(), slice.end(), order.begin() + run.begin);
+
+        // Runs sharing all 8 bytes continue only if the strings go on past them
+        for (size_t begin = run.begin; begin < run.end;) {
+            size_t end = begin + 1;
+            uint64_t chunk = chunks[order[begin]];
+            while (end < run.end && chunks[order[end]] == chunk) end++;
+            if (end - begin > 1 && (chunk & 0xFF) != 0) {
+                pending.push_back({begin, end, run.offset + 8});
+            }
+            begin = end;
+        }
+    }
+
+    vector<uint64_t> ranks(n);
+    uint64_t rank = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (i > 0 && values[order[i]] != values[order[i - 1]]) rank++;
+        ranks[order[i]] = rank;
+    }
+    return ranks;
+}
+
+// Eight bytes of a string starting at offset, big-endian, zero padded
+std::uint64_t SortEngine::stringChunk(const std::string& value, size_t offset) {
+    uint64_t chunk = 0;
+    for (size_t b = 0; b < 8; ++b) {
+        size_t position = offset + b;
+        unsigned char c = position < value.size() ? static_cast<unsigned char>(value[position]) : 0;
+        chunk = (chunk << 8) | c;
+    }
+    return chunk;
+}
+
+void SortEngine::radixSortByKey(std::vector<std::uint32_t>& permutation, const std::vector<std::uint64_t>& keys) {
+    size_t n = permutation.size();
+    if (n < RADIX_THRESHOLD) {
+        stable_sort(permutation.begin(), permutation.end(),
+            [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+        return;
+    }
+
+    // Gather keys into permutation order so every pass streams sequentially
+    vector<uint64_t> current(n), scratchKeys(n);
+    vector<uint32_t> scratchIndex(n);
+    for (size_t i = 0; i < n; ++i) current[i] = keys[permutation[i]];
+
+    // All digit histograms in one read of the keys
+    vector<array<size_t, RADIX_BUCKETS>> counts(RADIX_PASSES);
+    for (auto& histogram : counts) histogram.fill(0);
+    for (uint64_t key : current) {
+        for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+            counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+        auto& histogram = counts[pass];
+        int shift = pass * RADIX_BITS;
+
+        // Every key shares this digit: the pass would not move anything
+        if (histogram[(current[0] >> shift) & (RADIX_BUCKETS - 1)] == n) continue;
+
+        size_t offset = 0;
+        for (auto& bucket : histogram) {
+            size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            size_t target = histogram[(current[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            scratchKeys[target] = current[i];
+            scratchIndex[target] = permutation[i];
+        }
+        current.swap(scratchKeys);
+        permutation.swap(scratchIndex);
+    }
+}
@@ -0,0 +1,81 @@
+#include "StartupProfile.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    struct Phase {
+        string name;
+        double atMs;
+        double tookMs;
+        bool onUiThread;
+    };
+
+    using Clock = chrono::steady_clock;
+
+    Clock::time_point started = Clock::now();
+    thread::id uiThread = this_thread::get_id();
+    bool enabled = false;
+
+    mutex phaseMutex;
+    vector<Phase> phases;
+}
+
+void StartupProfile::begin() {
+    started = Clock::now();
+    uiThread = this_thread::get_id();
+    const char* value = getenv("SCOREME_STARTUP_REPORT");
+    if (value && *value && string(value) != "0") enabled = true;
+}
+
+double StartupProfile::elapsedMs() {
+    return chrono::duration<double, milli>(Clock::now() - started).count();
+}
+
+void StartupProfile::mark(const std::string& phase) {
+    double now = elapsedMs();
+    bool onUiThread = this_thread::get_id() == uiThread;
+
+    lock_guard<mutex> lock(phaseMutex);
+    // A phase took from the previous mark on the same thread (or from start)
+    double previous = 0.0;
+    for (auto it = phases.rbegin(); it != phases.rend(); ++it) {
+        if (it->onUiThread == onUiThread) {
+            previous = it->atMs;
+            break;
+        }
+    }
+    phases.push_back({phase, now, now - previous, onUiThread});
+}
+
+void StartupProfile::setEnabled(bool value) {
+    enabled = value;
+}
+
+bool StartupProfile::isEnabled() {
+    return enabled;
+}
+
+std::string StartupProfile::report() {
+    vector<Phase> snapshot;
+    {
+        lock_guard<mutex> lock(phaseMutex);
+        snapshot = phases;
+    }
+
+    ostringstream out;
+    out << fixed << setprecision(1);
+    out << "Startup timing (ms since start)\n";
+    out << "  " << left << setw(34) << "Phase" << right << setw(10) << "At" << setw(10) << "Took" << "  Thread\n";
+    for (const auto& phase : snapshot) {
+        out << "  " << left << setw(34) << phase.name << right << setw(10) << phase.atMs << setw(10) << phase.tookMs
+            << "  " << (phase.onUiThread ? "ui" : "loader") << "\n";
+    }
+    return out.str();
+}
@@ -2,46 +2,67 @@
 #include "GradeUtil.hpp"
 #include "MenuUtils.hpp"
 #include "ExcelUtil.hpp"
+#include "SearchIndex.hpp"
 #include <iostream>
 #include <algorithm>
+#include <cctype>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
 
 // Constructors
-Student::Student(const std::string& name, int age) : age(age), averageScore(0.0), gpa(0.0) {
+Student::Student(const std::string& name, int age) : age(age) {
     this->name = name;
     subjectScores.resize(7, 0.0);
+    recomputeGrades();
     updateTimestamp();
 }
 
 Student::Student(const std::string& studentId, const std::string& name, int age,
     const std::string& gender, const std::string& dateOfBirth,
-    const std::string& email, const std::vector<double>& scores) : studentId(studentId), age(age), gender(gender), dateOfBirth(dateOfBirth),email(email), subjectScores(scores) {
+    const std::string& email, const std::vector<double>& scores) : studentId(studentId), age(age), gender(gender), dateOfBirth(dateOfBirth),email(email), subjectScores(scores), scoreMask(fullScoreMask(scores.size())) {
     this->name = name;
-    updateAllGrades();
+    recomputeGrades();
     updateTimestamp();
 }
 
 Student::Student(const std::string& username, const std::string& password,
     const std::string& studentId, const std::string& name, int age,
     const std::string& gender, const std::string& dateOfBirth,
-    const std::string& email, const std::vector<double>& scores) : Person(username, password, name), studentId(studentId), age(age),gender(gender), dateOfBirth(dateOfBirth), email(email), subjectScores(scores) {
-    updateAllGrades();
+    const std::string& email, const std::vector<double>& scores)
+    : Student(username, password, studentId, name, age, gender, dateOfBirth, email, scores, fullScoreMask(scores.size())) {}
+
+Student::Student(const std::string& username, const std::string& password,
+    const std::string& studentId, const std::string& name, int age,
+    const std::string& gender, const std::string& dateOfBirth,
+    const std::string& email, const std::vector<double>& scores, std::uint32_t presentMask) : Person(username, password, name), studentId(studentId), age(age),gender(gender), dateOfBirth(dateOfBirth), email(email), subjectScores(scores), scoreMask(presentMask & fullScoreMask(scores.size())) {
+    // Absent slots hold 0.0 so unmasked sums over them add nothing
+    for (size_t i = 0; i < subjectScores.size(); ++i) {
+        if (!hasScore(i)) subjectScores[i] = 0.0;
+    }
+    recomputeGrades();
     updateTimestamp();
 }
 
 // Getters
-std::string Student::getStudentId() const { return studentId; }
+const std::string& Student::getStudentId() const { return studentId; }
 int Student::getAge() const { return age; }
-std::string Student::getGender() const { return gender; }
-std::string Student::getDateOfBirth() const { return dateOfBirth; }
-std::string Student::getEmail() const { return email; }
-std::vector<double> Student::getSubjectScores() const { return subjectScores; }
+const std::string& Student::getGender() const { return gender; }
+const std::string& Student::getDateOfBirth() const { return dateOfBirth; }
+const std::string& Student::getEmail() const { return email; }
+const std::vector<double>& Student::getSubjectScores() const { return subjectScores; }
+std::uint32_t Student::getScoreMask() const { return scoreMask; }
+bool Student::hasScore(size_t subjectIndex) const {
+    return subjectIndex < subjectScores.size() && (scoreMask >> subjectIndex) & 1u;
+}
+const std::string& Student::getClassName() const { return className; }
+double Student::getCumulativeCredits() const { return cumulativeCredits; }
+double Student::getCumulativeGpa() const { return cumulativeGpa; }
 double Student::getAverageScore() const { return averageScore; }
-std::string Student::getLetterGrade() const { return letterGrade; }
+const std::string& Student::getLetterGrade() const { return letterGrade; }
 double Student::getGpa() const { return gpa; }
-std::string Student::getRemark() const { return remark; }
+const std::string& Student::getRemark() const { return remark; }
+
 std::time_t Student::getLastUpdated() const { return lastUpdated; }
 
 // Setters
@@ -71,33 +92,57 @@ void Student::setEmail(const std::string& email) {
 }
 
 void Student::setSubjectScores(const std::vector<double>& scores) {
+    setSubjectScores(scores, fullScoreMask(scores.size()));
+}
+
+void Student::setSubjectScores(const std::vector<double>& scores, std::uint32_t presentMask) {
     subjectScores = scores;
-    updateAllGrades();
+    scoreMask = presentMask & fullScoreMask(scores.size());
+    // Absent slots hold 0.0 so unmasked sums over them add nothing
+    for (size_t i = 0; i < subjectScores.size(); ++i) {
+        if (!hasScore(i)) subjectScores[i] = 0.0;
+    }
+    recomputeGrades();
+    updateTimestamp();
+}
+
+void Student::setClassName(const std::string& className) {
+    this->className = className;
     updateTimestamp();
 }
 
+// Not a score edit, so lastUpdated is left alone
+void Student::setCumulativeRecord(double credits, double gpa) {
+    cumulativeCredits = credits;
+    cumulativeGpa = gpa;
+}
+
 // Calculation methods
 void Student::calculateAverageScore() {
-    averageScore = GradeUtil::calculateAverage(subjectScores);
+    averageScore = GradeUtil::calculateAverage(subjectScores, scoreMask);
 }
 
 void Student::assignLetterGrade() {
-    letterGrade = GradeUtil::assignLetterGrade(averageScore);
+    letterGrade = GradeUtil::assignLetterGrade(getAverageScore());
 }
 
 void Student::calculateGpa() {
-    gpa = GradeUtil::calculateGpa(averageScore);
+    gpa = GradeUtil::calculateGpa(getAverageScore());
 }
 
 void Student::assignRemark() {
-    remark = GradeUtil::assignRemark(averageScore);
+    remark = GradeUtil::assignRemark(getAverageScore());
 }
 
 void Student::updateAllGrades() {
-    calculateAverageScore();
-    assignLetterGrade();
-    calculateGpa();
-    assignRemark();
+    recomputeGrades();
+}
+
+void Student::recomputeGrades() {
+    averageScore = GradeUtil::calculateAverage(subjectScores, scoreMask);
+    letterGrade = GradeUtil::assignLetterGrade(averageScore);
+    gpa = GradeUtil::calculateGpa(averageScore);
+    remark = GradeUtil::assignRemark(averageScore);
 }
 
 // Override virtual methods
@@ -128,7 +173,8 @@ void Student::showMenu() {
                 MenuUtils::printHeader("SEARCH YOUR DATA");
                 std::string searchTerm = MenuUtils::getStringInput("Enter your Student ID or Name: ");
                 
-                if (searchTerm == studentId || searchTerm == name) {
+                if (searchTerm == studentId ||
+                    SearchIndex::similarity(searchTerm, name) >= SearchIndex::FUZZY_ACCEPT_SCORE) {
                     MenuUtils::displayStudentDetails(*this);
                 } else {
                     MenuUtils::printError("No matching record found!");
@@ -160,14 +206,45 @@ void Student::updateTimestamp() {
 }
 
 std::string Student::getFormattedTimestamp() const {
-    std::tm* tm = std::localtime(&lastUpdated);
+    // Reentrant conversion: exports format rows on several threads at once
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &lastUpdated);
+#else
+    localtime_r(&lastUpdated, &tm);
+#endif
     std::ostringstream oss;
-    oss << std::put_time(tm, "%Y-%m-%d %H:%M:%S");
+    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
     return oss.str();
 }
 
 bool Student::hasPassingGrade() const {
-    return GradeUtil::isPassingGrade(averageScore);
+    return GradeUtil::isPassingGrade(getAverageScore());
+}
+
+bool Student::sameRecord(const Student& other) const {
+    return studentId == other.studentId && name == other.name && age == other.age && gender == other.gender
+        && dateOfBirth == other.dateOfBirth && email == other.email && subjectScores == other.subjectScores
+        && scoreMask == other.scoreMask && className == other.className
+        && cumulativeCredits == other.cumulativeCredits && cumulativeGpa == other.cumulativeGpa
+        && getUsername() == other.getUsername() && getPassword() == other.getPassword();
+}
+
+std::string Student::identityKey() const {
+    auto lowered = [](const std::string& text) {
+        std::string out;
+        for (unsigned char c : text) {
+            if (!std::isspace(c)) out.push_back(static_cast<char>(std::tolower(c)));
+        }
+        return out;
+    };
+    std::string address = lowered(email);
+    if (!address.empty()) return "email:" + address;
+    return "name:" + lowered(name) + "|" + dateOfBirth;
+}
+
+std::uint32_t Student::fullScoreMask(size_t subjectCount) {
+    return subjectCount >= MAX_SUBJECTS ? ~0u : (1u << subjectCount) - 1u;
 }
 
 // Static method for sample data
@@ -195,10 +272,5 @@ std::vector<Student> Student::createSampleData() {
         students.emplace_back("STU010", "Phy Sovanna", 21, "Female", "2004-06-12", "physovanna@email.com",
                             std::vector<double>{57.4, 45.9, 39.2, 46.7, 58.5, 47.1, 46.8});
     
-    // Update all grades for sample data
-    for (auto& student : students) {
-        student.updateAllGrades();
-    }
-    
     return students;
 }
\ No newline at end of file
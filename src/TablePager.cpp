@@ -0,0 +1,202 @@
+#include "TablePager.hpp"
+#include "MenuUtils.hpp"
+#include "Screen.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+    // Title, borders, header, legend, key help and prompt around the rows
+    const int SCREEN_CHROME_LINES = 9;
+    const size_t MIN_PAGE_ROWS = 5;
+    const size_t PAGES_KEPT = 8;
+
+    bool containsIgnoringCase(const string& text, const string& needle) {
+        auto found = search(text.begin(), text.end(), needle.begin(), needle.end(), [](unsigned char a, unsigned char b) {
+            return tolower(a) == tolower(b);
+        });
+        return found != text.end();
+    }
+
+    string trim(const string& text) {
+        size_t first = text.find_first_not_of(" \t");
+        if (first == string::npos) return "";
+        size_t last = text.find_last_not_of(" \t");
+        return text.substr(first, last - first + 1);
+    }
+}
+
+TablePager::TablePager(const std::vector<Student>& students, std::vector<std::uint32_t> rows)
+    : students(students), originalRows(rows), rows(std::move(rows)), pageSize(rowsPerPage()) {
+}
+
+TablePager::~TablePager() {
+    finishPrefetch();
+}
+
+size_t TablePager::rowsPerPage() {
+    // One line per student
+    int available = Screen::rows() - SCREEN_CHROME_LINES;
+    return max(MIN_PAGE_ROWS, static_cast<size_t>(max(0, available)));
+}
+
+size_t TablePager::pageCount() const {
+    return max<size_t>(1, (rows.size() + pageSize - 1) / pageSize);
+}
+
+std::string TablePager::render(size_t pageIndex) const {
+    size_t begin = pageIndex * pageSize;
+    return MenuUtils::formatTable(students, rows, begin, min(rows.size(), begin + pageSize));
+}
+
+void TablePager::startPrefetch(size_t pageIndex) {
+    if (pageIndex >= pageCount() || rendered.count(pageIndex) || prefetch.valid()) return;
+    // The UI thread only waits for input meanwhile, so the roster is read
+    // by one thread at a time
+    prefetchPage = pageIndex;
+    prefetch = async(launch::async, [this, pageIndex] { return render(pageIndex); });
+}
+
+void TablePager::finishPrefetch() {
+    if (!prefetch.valid()) return;
+    string text = prefetch.get();
+    rendered.emplace(prefetchPage, move(text));
+}
+
+const std::string& TablePager::pageText(size_t pageIndex) {
+    finishPrefetch();
+    auto found = rendered.find(pageIndex);
+    if (found == rendered.end()) {
+        found = rendered.emplace(pageIndex, render(pageIndex)).first;
+    }
+    // Keep only pages near this one, so paging through 100k rows stays small
+    while (rendered.size() > PAGES_KEPT) {
+        auto farthest = max_element(rendered.begin(), rendered.end(), [pageIndex](const auto& a, const auto& b) {
+            auto distance = [pageIndex](size_t p) { return p > pageIndex ? p - pageIndex : pageIndex - p; };
+            return distance(a.first) < distance(b.first);
+        });
+        rendered.erase(farthest);
+    }
+    return rendered.find(pageIndex)->second;
+}
+
+void TablePager::invalidate() {
+    finishPrefetch();
+    rendered.clear();
+}
+
+void TablePager::show() {
+    // Paging mostly changes the rows; borders, legend and help stay put,
+    // so Screen only rewrites the lines that differ
+    string frame = pageFrame();
+    screen.present(frame);
+    status.clear();
+    startPrefetch(page + 1);
+}
+
+std::string TablePager::pageFrame() {
+    size_t first = page * pageSize;
+    size_t last = min(rows.size(), first + pageSize);
+    string frame = MenuUtils::BOLD + "Students " + to_string(first + 1) + "-" + to_string(last) + " of " +
+                   to_string(rows.size()) + "  (page " + to_string(page + 1) + "/" + to_string(pageCount()) + ")" +
+                   MenuUtils::RESET;
+    if (!sortLabel.empty()) frame += "  sorted by " + sortLabel;
+    frame += "\n";
+    frame += pageText(page);
+    frame += MenuUtils::GREEN + "A-C " + MenuUtils::YELLOW + "D-E " + MenuUtils::RED + "F" + MenuUtils::RESET;
+    if (!status.empty()) frame += "   " + status;
+    frame += "\n" + MenuUtils::CYAN + "[Enter] next  p prev  g N page  /text find  s avg|gpa|name|id|age|off sort  q quit" +
+             MenuUtils::RESET + "\n> ";
+    return frame;
+}
+
+void TablePager::run() {
+    while (true) {
+        show();
+        string command;
+        if (!getline(cin, command)) break;
+        command = trim(command);
+        finishPrefetch();
+
+        if (command.empty() || command == "n") {
+            if (page + 1 < pageCount()) goTo(page + 1);
+            else status = "Last page.";
+        } else if (command == "p") {
+            if (page > 0) goTo(page - 1);
+            else status = "First page.";
+        } else if (command == "q") {
+            break;
+        } else if (command[0] == '/') {
+            search(trim(command.substr(1)));
+        } else if (command[0] == 'g') {
+            try {
+                goTo(stoll(trim(command.substr(1))) - 1);
+            } catch (const exception&) {
+                status = "Usage: g <page number>";
+            }
+        } else if (command[0] == 's' && (command.size() == 1 || command[1] == ' ')) {
+            sort(trim(command.substr(1)));
+        } else {
+            status = "Unknown command '" + command + "'.";
+        }
+    }
+    cout << endl;
+}
+
+void TablePager::goTo(long long pageIndex) {
+    if (pageIndex < 0 || static_cast<size_t>(pageIndex) >= pageCount()) {
+        status = "No page " + to_string(pageIndex + 1) + "; there are " + to_string(pageCount()) + ".";
+        return;
+    }
+    page = static_cast<size_t>(pageIndex);
+    searchFrom = page * pageSize;   // finds continue from what is on screen
+}
+
+void TablePager::search(const std::string& text) {
+    if (text.empty()) {
+        status = "Usage: /<text>";
+        return;
+    }
+    // Continue after the previous match, wrapping around once
+    for (size_t step = 0; step < rows.size(); ++step) {
+        size_t position = (searchFrom + step) % rows.size();
+        const Student& student = students[rows[position]];
+        if (containsIgnoringCase(student.getName(), text) || containsIgnoringCase(student.getStudentId(), text)) {
+            page = position / pageSize;
+            searchFrom = position + 1;
+            status = "Found " + student.getStudentId() + " " + student.getName() + " (row " + to_string(position + 1) + ")";
+            return;
+        }
+    }
+    status = "No student matches '" + text + "'.";
+}
+
+void TablePager::sort(const std::string& key) {
+    if (key == "off") {
+        rows = originalRows;
+        sortLabel.clear();
+    } else {
+        SortKey requested;
+        bool descending;
+        if (key == "avg") { requested = SortKey::AverageScore; descending = true; }
+        else if (key == "gpa") { requested = SortKey::Gpa; descending = true; }
+        else if (key == "name") { requested = SortKey::Name; descending = false; }
+        else if (key == "id") { requested = SortKey::StudentNumber; descending = false; }
+        else if (key == "age") { requested = SortKey::Age; descending = false; }
+        else {
+            status = "Sort by avg, gpa, name, id or age, or 's off'.";
+            return;
+        }
+        // The same key again flips the direction
+        if (!sortLabel.empty() && requested == sortKey) descending = !sortDescending;
+        sortKey = requested;
+        sortDescending = descending;
+        SortEngine::sortRows(students, rows, {{sortKey, sortDescending}});
+        sortLabel = key + (sortDescending ? " (descending)" : " (ascending)");
+    }
+    invalidate();
+    page = 0;
+    searchFrom = 0;
+}
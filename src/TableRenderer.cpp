@@ -0,0 +1,186 @@
+#include "TableRenderer.hpp"
+#include <array>
+#include <charconv>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+    enum Column { ID, NAME, AGE, GENDER, EMAIL, AVERAGE, GRADE, GPA, REMARK, COLUMN_COUNT };
+    const char* const HEADERS[COLUMN_COUNT] = {"ID", "Name", "Age", "Gender", "Email", "Average", "Grade", "GPA", "Remark"};
+    const bool RIGHT_ALIGNED[COLUMN_COUNT] = {false, false, true, false, false, true, false, true, false};
+
+    const char* const ANSI_RESET = "\033[0m";
+    const char* const ANSI_BOLD = "\033[1m";
+    const char* const ANSI_HEADER = "\033[1;36m";
+
+    size_t intWidth(long long value) {
+        char buffer[24];
+        return static_cast<size_t>(to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer);
+    }
+
+    // Width appendTruncated2 will use, without formatting the text. Numbers
+    // are normally at most "100.00" and "4.00", but measuring keeps odd data
+    // (negative values, NaN) aligned too.
+    size_t decimalWidth(double value) {
+        if (!isfinite(value)) return 1;
+        long long hundredths = static_cast<long long>(value * 100.0);
+        return (hundredths < 0 ? 1 : 0) + intWidth((hundredths < 0 ? -hundredths : hundredths) / 100) + 3;
+    }
+
+    double roundedForFixed2(double value) {
+        return value < 0 ? value - 0.005 : value + 0.005;
+    }
+
+    void appendPadding(string& out, size_t count) {
+        out.append(count, ' ');
+    }
+
+    void appendBorder(string& out, const array<size_t, COLUMN_COUNT>& widths) {
+        out += '+';
+        for (size_t width : widths) {
+            out.append(width + 2, '-');
+            out += '+';
+        }
+        out += '\n';
+    }
+
+    // "| text   " with the cell padded to width; alignment by column
+    void appendCell(string& out, const char* text, size_t length, size_t shown, size_t width, bool right) {
+        out += "| ";
+        if (right) appendPadding(out, width - shown);
+        out.append(text, length);
+        if (!right) appendPadding(out, width - shown);
+        out += ' ';
+    }
+
+    void appendCell(string& out, const string& text, size_t width, bool right) {
+        appendCell(out, text.data(), text.size(), TableRenderer::displayWidth(text), width, right);
+    }
+}
+
+size_t TableRenderer::displayWidth(const std::string& text) {
+    size_t width = 0;
+    for (unsigned char c : text) {
+        if ((c & 0xC0) != 0x80) width++;   // continuation bytes add nothing
+    }
+    return width;
+}
+
+void TableRenderer::appendInt(std::string& out, long long value) {
+    char buffer[24];
+    char* end = to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    out.append(buffer, static_cast<size_t>(end - buffer));
+}
+
+void TableRenderer::appendTruncated2(std::string& out, double value) {
+    if (!isfinite(value)) {
+        out += "-";
+        return;
+    }
+    long long hundredths = static_cast<long long>(value * 100.0);
+    if (hundredths < 0) {
+        out += '-';
+        hundredths = -hundredths;
+    }
+    appendInt(out, hundredths / 100);
+    out += '.';
+    long long fraction = hundredths % 100;
+    out += static_cast<char>('0' + fraction / 10);
+    out += static_cast<char>('0' + fraction % 10);
+}
+
+void TableRenderer::appendFixed2(std::string& out, double value) {
+    if (!isfinite(value)) {
+        out += "-";
+        return;
+    }
+    appendTruncated2(out, roundedForFixed2(value));
+}
+
+const char* TableRenderer::gradeColor(const std::string& letterGrade) {
+    switch (letterGrade.empty() ? '\0' : letterGrade[0]) {
+        case 'A': case 'B': case 'C': return "\033[32m";
+        case 'D': case 'E': return "\033[33m";
+        case 'F': return "\033[31m";
+        default: return "";
+    }
+}
+
+void TableRenderer::appendStudents(std::string& out, const std::vector<Student>& students,
+                                   const std::vector<std::uint32_t>& rows, size_t begin, size_t end, bool color) {
+    end = min(end, rows.size());
+    begin = min(begin, end);
+
+    // Pass 1: widths
+    array<size_t, COLUMN_COUNT> widths;
+    for (size_t c = 0; c < COLUMN_COUNT; ++c) {
+        widths[c] = char_traits<char>::length(HEADERS[c]);
+    }
+    for (size_t r = begin; r < end; ++r) {
+        const Student& student = students[rows[r]];
+        widths[ID] = max(widths[ID], displayWidth(student.getStudentId()));
+        widths[NAME] = max(widths[NAME], displayWidth(student.getName()));
+        widths[AGE] = max(widths[AGE], intWidth(student.getAge()));
+        widths[GENDER] = max(widths[GENDER], displayWidth(student.getGender()));
+        widths[EMAIL] = max(widths[EMAIL], displayWidth(student.getEmail()));
+        widths[AVERAGE] = max(widths[AVERAGE], decimalWidth(student.getAverageScore()));
+        widths[GRADE] = max(widths[GRADE], displayWidth(student.getLetterGrade()));
+        widths[GPA] = max(widths[GPA], decimalWidth(roundedForFixed2(student.getGpa())));
+        widths[REMARK] = max(widths[REMARK], displayWidth(student.getRemark()));
+    }
+
+    // Pass 2: one reservation, then appends only
+    size_t lineLength = 2;
+    for (size_t width : widths) {
+        lineLength += width + 3;
+    }
+    size_t colorBytes = color ? 16 : 0;
+    out.reserve(out.size() + (end - begin + 5) * (lineLength + colorBytes));
+
+    appendBorder(out, widths);
+    if (color) out += ANSI_HEADER;
+    for (size_t c = 0; c < COLUMN_COUNT; ++c) {
+        appendCell(out, HEADERS[c], char_traits<char>::length(HEADERS[c]), char_traits<char>::length(HEADERS[c]),
+                   widths[c], false);
+    }
+    if (color) out += ANSI_RESET;
+    out += "|\n";
+    appendBorder(out, widths);
+
+    string number;
+    for (size_t r = begin; r < end; ++r) {
+        const Student& student = students[rows[r]];
+        const char* rowColor = color ? gradeColor(student.getLetterGrade()) : "";
+        bool failing = color && student.getRemark() == "Fail";
+        if (*rowColor) out += rowColor;
+        if (failing) out += ANSI_BOLD;
+
+        appendCell(out, student.getStudentId(), widths[ID], RIGHT_ALIGNED[ID]);
+        appendCell(out, student.getName(), widths[NAME], RIGHT_ALIGNED[NAME]);
+        number.clear();
+        appendInt(number, student.getAge());
+        appendCell(out, number, widths[AGE], RIGHT_ALIGNED[AGE]);
+        appendCell(out, student.getGender(), widths[GENDER], RIGHT_ALIGNED[GENDER]);
+        appendCell(out, student.getEmail(), widths[EMAIL], RIGHT_ALIGNED[EMAIL]);
+        number.clear();
+        appendTruncated2(number, student.getAverageScore());
+        appendCell(out, number, widths[AVERAGE], RIGHT_ALIGNED[AVERAGE]);
+        appendCell(out, student.getLetterGrade(), widths[GRADE], RIGHT_ALIGNED[GRADE]);
+        number.clear();
+        appendFixed2(number, student.getGpa());
+        appendCell(out, number, widths[GPA], RIGHT_ALIGNED[GPA]);
+        appendCell(out, student.getRemark(), widths[REMARK], RIGHT_ALIGNED[REMARK]);
+
+        if (*rowColor || failing) out += ANSI_RESET;
+        out += "|\n";
+    }
+    appendBorder(out, widths);
+}
+
+std::string TableRenderer::renderStudents(const std::vector<Student>& students, const std::vector<std::uint32_t>& rows,
+                                          size_t begin, size_t end, bool color) {
+    string out;
+    appendStudents(out, students, rows, begin, end, color);
+    return out;
+}
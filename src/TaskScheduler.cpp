@@ -0,0 +1,291 @@
+#include "TaskScheduler.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+using namespace std;
+
+size_t TaskScheduler::overrideThreads = 0;
+
+namespace {
+    // More chunks than threads lets idle workers steal the tail of an uneven split
+    const size_t CHUNKS_PER_THREAD = 4;
+
+    // A waiting thread with nothing to steal re-checks this often, so a task
+    // pushed by a worker is picked up even if its wake-up went elsewhere
+    const auto IDLE_POLL = chrono::microseconds(200);
+
+    thread_local const TaskScheduler* currentPool = nullptr;
+    thread_local size_t currentIndex = 0;
+
+    size_t environmentThreadCount() {
+        const char* value = getenv("SCOREME_THREADS");
+        if (!value) return 0;
+        try {
+            return stoul(value);
+        } catch (const exception&) {
+            return 0;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// TaskGroup
+// ---------------------------------------------------------------------------
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler, const CancellationToken* token)
+    : scheduler(scheduler), token(token) {}
+
+TaskGroup::~TaskGroup() {
+    // Tasks reference this group; never let it go out of scope under them
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    pending.fetch_add(1, memory_order_relaxed);
+    scheduler.push([this, task = move(task)] {
+        if (token && token->isCancelled()) {
+            skipped.store(true, memory_order_relaxed);
+        } else {
+            try {
+                task();
+            } catch (...) {
+                lock_guard<mutex> lock(doneMutex);
+                if (!error) error = current_exception();
+            }
+        }
+        // Under the lock, so the waiter cannot see zero and destroy the
+        // group while this task is still touching it
+        lock_guard<mutex> lock(doneMutex);
+        if (pending.fetch_sub(1, memory_order_acq_rel) == 1) {
+            done.notify_all();
+        }
+    });
+}
+
+bool TaskGroup::wait(const std::function<void()>& onIdle) {
+    while (pending.load(memory_order_acquire) > 0) {
+        if (scheduler.runOne()) {
+            if (onIdle) onIdle();
+            continue;
+        }
+        if (onIdle) onIdle();
+        unique_lock<mutex> lock(doneMutex);
+        done.wait_for(lock, IDLE_POLL, [this] { return pending.load(memory_order_acquire) == 0; });
+    }
+
+    exception_ptr failure;
+    {
+        lock_guard<mutex> lock(doneMutex);
+        swap(failure, error);
+    }
+    if (failure) rethrow_exception(failure);
+    return !skipped.load(memory_order_relaxed);
+}
+
+void TaskGroup::waitBelow(size_t limit) {
+    limit = max<size_t>(1, limit);
+    while (pending.load(memory_order_acquire) >= limit) {
+        if (scheduler.runOne()) continue;
+        unique_lock<mutex> lock(doneMutex);
+        done.wait_for(lock, IDLE_POLL, [this, limit] { return pending.load(memory_order_acquire) < limit; });
+    }
+}
+
+// ---------------------------------------------------------------------------
+// JobQueue
+// ---------------------------------------------------------------------------
+
+JobQueue::JobQueue() : scheduler(nullptr) {}
+
+JobQueue::JobQueue(TaskScheduler& scheduler) : scheduler(&scheduler) {}
+
+JobQueue::~JobQueue() {
+    wait();
+}
+
+TaskScheduler& JobQueue::pool() {
+    if (!scheduler) scheduler = &TaskScheduler::shared();
+    return *scheduler;
+}
+
+bool JobQueue::runsInBackground() {
+    return !pool().workers.empty();
+}
+
+void JobQueue::submit(std::function<void()> job) {
+    TaskScheduler& target = pool();
+    {
+        lock_guard<mutex> lock(queueMutex);
+        jobs.push_back(move(job));
+        unfinished++;
+        if (draining) return;   // the running drain task picks it up
+        draining = true;
+    }
+    target.push([this] { drain(); });
+}
+
+void JobQueue::drain() {
+    // A thread waiting on its own group may have stolen this task; a long
+    // job must not block it, so hand it back to the pool's workers
+    TaskScheduler& target = pool();
+    if (!target.workers.empty() && target.currentWorker() == target.workers.size()) {
+        target.push([this] { drain(); });
+        return;
+    }
+
+    function<void()> job;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        job = move(jobs.front());   // submit queues a job before it starts a drain
+        jobs.pop_front();
+    }
+    while (true) {
+        try {
+            job();
+        } catch (...) {
+        }
+        // The last touch of the queue is under the lock, so a waiter cannot
+        // return and destroy it while this task is still using it
+        lock_guard<mutex> lock(queueMutex);
+        unfinished--;
+        if (jobs.empty()) {
+            draining = false;
+            idle.notify_all();
+            return;
+        }
+        job = move(jobs.front());
+        jobs.pop_front();
+    }
+}
+
+void JobQueue::wait() {
+    unique_lock<mutex> lock(queueMutex);
+    idle.wait(lock, [this] { return unfinished == 0; });
+}
+
+size_t JobQueue::pending() const {
+    lock_guard<mutex> lock(queueMutex);
+    return unfinished;
+}
+
+// ---------------------------------------------------------------------------
+// TaskScheduler
+// ---------------------------------------------------------------------------
+
+TaskScheduler& TaskScheduler::shared() {
+    static TaskScheduler scheduler(configuredThreadCount());
+    return scheduler;
+}
+
+void TaskScheduler::setThreadCount(size_t threads) {
+    overrideThreads = threads;
+}
+
+size_t TaskScheduler::configuredThreadCount() {
+    size_t threads = overrideThreads ? overrideThreads : environmentThreadCount();
+    return threads ? threads : max(1u, thread::hardware_concurrency());
+}
+
+TaskScheduler::TaskScheduler(size_t threads) {
+    // The thread that waits on a group works too, so one fewer is spawned
+    size_t background = threads > 1 ? threads - 1 : 0;
+    for (size_t i = 0; i < background; ++i) {
+        workers.push_back(make_unique<Worker>());
+    }
+    for (size_t i = 0; i < background; ++i) {
+        workers[i]->thread = thread(&TaskScheduler::workerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+size_t TaskScheduler::threadCount() const {
+    return workers.size() + 1;
+}
+
+size_t TaskScheduler::chunkCount(size_t count, size_t grain) const {
+    if (workers.empty() || count <= max<size_t>(grain, 1)) return 1;
+    size_t byGrain = (count + grain - 1) / max<size_t>(grain, 1);
+    return min(byGrain, threadCount() * CHUNKS_PER_THREAD);
+}
+
+void TaskScheduler::push(std::function<void()> task) {
+    if (workers.empty()) {
+        task();   // single-threaded: nothing would ever take it off a queue
+        return;
+    }
+
+    size_t self = currentWorker();
+    size_t target = self < workers.size() ? self : nextWorker.fetch_add(1, memory_order_relaxed) % workers.size();
+    {
+        lock_guard<mutex> lock(workers[target]->mutex);
+        workers[target]->tasks.push_back(move(task));
+    }
+    queued.fetch_add(1, memory_order_release);
+    {
+        lock_guard<mutex> lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+bool TaskScheduler::runOne(size_t self) {
+    function<void()> task;
+
+    // Own deque from the back: the most recently split, smallest piece
+    if (self < workers.size()) {
+        Worker& own = *workers[self];
+        lock_guard<mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+
+    // Otherwise steal from the front of another deque: the oldest, largest piece
+    for (size_t offset = 1; !task && offset <= workers.size(); ++offset) {
+        Worker& victim = *workers[(self + offset) % workers.size()];
+        lock_guard<mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+
+    if (!task) return false;
+    queued.fetch_sub(1, memory_order_relaxed);
+    task();
+    return true;
+}
+
+bool TaskScheduler::runOne() {
+    return runOne(currentWorker());
+}
+
+void TaskScheduler::workerLoop(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+    while (true) {
+        if (runOne(index)) continue;
+
+        unique_lock<mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queued.load(memory_order_acquire) > 0; });
+        if (stopping && queued.load(memory_order_acquire) == 0) return;
+    }
+}
+
+size_t TaskScheduler::currentWorker() const {
+    return currentPool == this ? currentIndex : workers.size();
+}
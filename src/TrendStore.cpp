@@ -0,0 +1,384 @@
+#include "TrendStore.hpp"
+#include "ExcelUtil.hpp"
+#include "GradeUtil.hpp"
+#include "MenuUtils.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    const string TREND_FILE_MAGIC = "SCOREME-TREND 2\n";
+    const string ID_KEYED_FILE_MAGIC = "SCOREME-TREND 1\n";   // rows keyed by positional student ID
+    const string TREND_FILE_NAME = "trends.store";
+    const double VALUE_SCALE = 100.0;     // values are stored in hundredths of a point
+    const int32_t ABSENT_VALUE = -1;      // subject not taken; real scores are never negative
+    const double SECONDS_PER_MONTH = 30.0 * 24.0 * 60.0 * 60.0;
+
+    void writeVarint(string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    int32_t quantize(double value) {
+        return static_cast<int32_t>(llround(value * VALUE_SCALE));
+    }
+
+    // Bounds-checked cursor over an encoded buffer
+    class Reader {
+    public:
+        Reader(const string& data, size_t position = 0) : data(data), position(position) {}
+
+        bool atEnd() const { return position >= data.size(); }
+        size_t offset() const { return position; }
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (position >= data.size()) throw runtime_error("Truncated trend block");
+                uint8_t byte = static_cast<uint8_t>(data[position++]);
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return value;
+            }
+            throw runtime_error("Malformed varint in trend block");
+        }
+
+        string bytes(size_t length) {
+            if (length > data.size() - position) throw runtime_error("Truncated trend block");
+            string result = data.substr(position, length);
+            position += length;
+            return result;
+        }
+
+    private:
+        const string& data;
+        size_t position;
+    };
+
+    bool startsWith(const string& filename, const string& magic) {
+        ifstream in(filename, ios::binary);
+        string head(magic.size(), '\0');
+        return in.read(&head[0], static_cast<streamsize>(head.size())) && head == magic;
+    }
+
+    // "backup_students_2024-05-01_12-30-00.xlsx" -> time of the backup; falls
+    // back to the file's modification time for names without a timestamp
+    int64_t backupTimestamp(const std::filesystem::path& path) {
+        string stem = path.stem().string();
+        const size_t TIMESTAMP_LENGTH = 19;
+        if (stem.size() >= TIMESTAMP_LENGTH) {
+            tm parsed = {};
+            istringstream in(stem.substr(stem.size() - TIMESTAMP_LENGTH));
+            in >> get_time(&parsed, "%Y-%m-%d_%H-%M-%S");
+            if (!in.fail()) {
+                parsed.tm_isdst = -1;
+                return static_cast<int64_t>(mktime(&parsed));
+            }
+        }
+        auto fileTime = std::filesystem::last_write_time(path);
+        auto systemTime = chrono::time_point_cast<chrono::system_clock::duration>(
+            fileTime - std::filesystem::file_time_type::clock::now() + chrono::system_clock::now());
+        return static_cast<int64_t>(chrono::system_clock::to_time_t(systemTime));
+    }
+}
+
+TrendStore TrendStore::open(const std::string& filename) {
+    TrendStore store;
+    store.filename = filename;
+    if (!ExcelUtils::fileExists(filename)) {
+        return store;
+    }
+
+    ifstream in(filename, ios::binary);
+    if (!in) {
+        throw runtime_error("Cannot open trend store: " + filename);
+    }
+    string data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    if (data.compare(0, TREND_FILE_MAGIC.size(), TREND_FILE_MAGIC) != 0) {
+        throw runtime_error("Not a ScoreME trend store: " + filename);
+    }
+
+    size_t position = TREND_FILE_MAGIC.size();
+    store.validBytes = position;
+    while (position < data.size()) {
+        Reader reader(data, position);
+        string block;
+        try {
+            block = reader.bytes(reader.varint());
+        } catch (const exception&) {
+            MenuUtils::printWarning("Ignoring incomplete snapshot at the end of " + filename);
+            break;
+        }
+        store.decodeBlock(block);
+        position = reader.offset();
+        store.validBytes = position;
+    }
+    return store;
+}
+
+TrendStore TrendStore::openArchive(const std::string& backupDirectory, const std::string& pendingBackup) {
+    string storeFile = archiveFilename(backupDirectory);
+    if (ExcelUtils::fileExists(storeFile) && startsWith(storeFile, ID_KEYED_FILE_MAGIC)) {
+        std::filesystem::rename(storeFile, storeFile + ".v1");
+        MenuUtils::printInfo("Rebuilding the score history by student identity; the old store was kept as " +
+                             storeFile + ".v1");
+    }
+    if (ExcelUtils::fileExists(storeFile) || !std::filesystem::exists(backupDirectory)) {
+        return open(storeFile);
+    }
+
+    // One-time backfill for backups taken before the store existed
+    vector<pair<int64_t, string>> workbooks;
+    for (const auto& entry : std::filesystem::directory_iterator(backupDirectory)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".xlsx") continue;
+        if (entry.path().filename().string().find("credentials") != string::npos) continue;
+        std::error_code unrelated;
+        if (!pendingBackup.empty() && std::filesystem::equivalent(entry.path(), pendingBackup, unrelated)) continue;
+        workbooks.emplace_back(backupTimestamp(entry.path()), entry.path().string());
+    }
+    sort(workbooks.begin(), workbooks.end());
+
+    TrendStore store = open(storeFile);
+    for (const auto& workbook : workbooks) {
+        try {
+            store.append(ExcelUtils::readStudentRows(workbook.second), workbook.first);
+        } catch (const exception& e) {
+            MenuUtils::printWarning("Skipping " + workbook.second + ": " + e.what());
+        }
+    }
+    return store;
+}
+
+std::string TrendStore::archiveFilename(const std::string& backupDirectory) {
+    return (std::filesystem::path(backupDirectory) / TREND_FILE_NAME).string();
+}
+
+void TrendStore::append(const std::vector<Student>& students, std::int64_t timestamp) {
+    // Sorted by key so neighbouring keys share prefixes; a duplicated key keeps its first row
+    vector<pair<string, const Student*>> rows;
+    rows.reserve(students.size());
+    for (const auto& student : students) {
+        rows.emplace_back(student.identityKey(), &student);
+    }
+    stable_sort(rows.begin(), rows.end(),
+                [](const pair<string, const Student*>& a, const pair<string, const Student*>& b) { return a.first < b.first; });
+    rows.erase(unique(rows.begin(), rows.end(),
+                      [](const pair<string, const Student*>& a, const pair<string, const Student*>& b) { return a.first == b.first; }),
+               rows.end());
+
+    size_t columns = 1 + GradeUtil::getSubjectNames().size();
+    int64_t previousTime = snapshotTimes.empty() ? 0 : snapshotTimes.back();
+
+    string block;
+    writeVarint(block, zigzag(timestamp - previousTime));
+    writeVarint(block, rows.size());
+    writeVarint(block, columns);
+
+    const string* previousKey = nullptr;
+    for (const auto& row : rows) {
+        size_t shared = 0;
+        if (previousKey) {
+            size_t limit = min(previousKey->size(), row.first.size());
+            while (shared < limit && (*previousKey)[shared] == row.first[shared]) shared++;
+        }
+        writeVarint(block, shared);
+        writeVarint(block, row.first.size() - shared);
+        block.append(row.first, shared, string::npos);
+        previousKey = &row.first;
+    }
+
+    // Column-major, each value relative to the same student's previous snapshot
+    vector<const Series*> previousSeries(rows.size(), nullptr);
+    for (size_t r = 0; r < rows.size(); ++r) {
+        auto found = seriesIndex.find(rows[r].first);
+        if (found != seriesIndex.end()) previousSeries[r] = &series[found->second];
+    }
+    for (size_t c = 0; c < columns; ++c) {
+        for (size_t r = 0; r < rows.size(); ++r) {
+            const Student& student = *rows[r].second;
+            int32_t value = ABSENT_VALUE;
+            if (c == 0) {
+                value = quantize(student.getAverageScore());
+            } else if (student.hasScore(c - 1)) {
+                value = quantize(student.getSubjectScores()[c - 1]);
+            }
+
+            int32_t baseline = 0;
+            if (const Series* previous = previousSeries[r]) {
+                uint32_t start = previous->offsets[previous->offsets.size() - 2];
+                if (start + c < previous->offsets.back()) baseline = previous->values[start + c];
+            }
+            writeVarint(block, zigzag(static_cast<int64_t>(value) - baseline));
+        }
+    }
+
+    std::filesystem::path storePath(filename);
+    if (storePath.has_parent_path()) {
+        std::filesystem::create_directories(storePath.parent_path());
+    }
+    if (ExcelUtils::fileExists(filename) && std::filesystem::file_size(storePath) > validBytes) {
+        // Drop a partial block left by an interrupted append
+        std::filesystem::resize_file(storePath, validBytes);
+    }
+
+    string framed;
+    if (validBytes == 0) {
+        framed = TREND_FILE_MAGIC;
+    }
+    writeVarint(framed, block.size());
+    framed += block;
+
+    ofstream out(filename, ios::binary | ios::app);
+    if (!out || !out.write(framed.data(), static_cast<streamsize>(framed.size())) || !out.flush()) {
+        throw runtime_error("Cannot write trend store: " + filename);
+    }
+    validBytes += framed.size();
+
+    decodeBlock(block);
+}
+
+void TrendStore::decodeBlock(const std::string& block) {
+    Reader reader(block);
+    int64_t previousTime = snapshotTimes.empty() ? 0 : snapshotTimes.back();
+    int64_t timestamp = previousTime + unzigzag(reader.varint());
+    uint64_t rowCount = reader.varint();
+    uint64_t columns = reader.varint();
+    if (columns == 0 || rowCount > block.size() || columns > block.size()) {
+        throw runtime_error("Corrupt trend store: " + filename);
+    }
+
+    vector<uint32_t> rowSeries(rowCount);
+    string key;
+    for (uint64_t r = 0; r < rowCount; ++r) {
+        uint64_t shared = reader.varint();
+        if (shared > key.size()) throw runtime_error("Corrupt trend store: " + filename);
+        key.resize(shared);
+        key += reader.bytes(reader.varint());
+        rowSeries[r] = seriesFor(key);
+    }
+
+    // Decode every column before touching the series so baselines still
+    // refer to each student's previous snapshot
+    vector<int32_t> decoded(rowCount * columns);
+    for (uint64_t c = 0; c < columns; ++c) {
+        for (uint64_t r = 0; r < rowCount; ++r) {
+            const Series& previous = series[rowSeries[r]];
+            int32_t baseline = 0;
+            if (!previous.snapshots.empty()) {
+                uint32_t start = previous.offsets[previous.offsets.size() - 2];
+                if (start + c < previous.offsets.back()) baseline = previous.values[start + c];
+            }
+            decoded[r * columns + c] = static_cast<int32_t>(baseline + unzigzag(reader.varint()));
+        }
+    }
+    if (!reader.atEnd()) {
+        throw runtime_error("Corrupt trend store: " + filename);
+    }
+
+    uint32_t snapshot = static_cast<uint32_t>(snapshotTimes.size());
+    snapshotTimes.push_back(timestamp);
+    for (uint64_t r = 0; r < rowCount; ++r) {
+        Series& target = series[rowSeries[r]];
+        target.snapshots.push_back(snapshot);
+        target.values.insert(target.values.end(), decoded.begin() + r * columns, decoded.begin() + (r + 1) * columns);
+        target.offsets.push_back(static_cast<uint32_t>(target.values.size()));
+    }
+    valueCount += rowCount * columns;
+}
+
+std::uint32_t TrendStore::seriesFor(const std::string& identity) {
+    auto inserted = seriesIndex.emplace(identity, static_cast<uint32_t>(series.size()));
+    if (inserted.second) {
+        series.emplace_back();
+        series.back().offsets.push_back(0);
+    }
+    return inserted.first->second;
+}
+
+std::vector<TrendPoint> TrendStore::history(const Student& student) const {
+    vector<TrendPoint> points;
+    auto found = seriesIndex.find(student.identityKey());
+    if (found == seriesIndex.end()) {
+        return points;
+    }
+
+    const Series& stored = series[found->second];
+    points.reserve(stored.snapshots.size());
+    for (size_t p = 0; p < stored.snapshots.size(); ++p) {
+        TrendPoint point;
+        point.timestamp = snapshotTimes[stored.snapshots[p]];
+        point.average = stored.values[stored.offsets[p]] / VALUE_SCALE;
+        for (uint32_t v = stored.offsets[p] + 1; v < stored.offsets[p + 1]; ++v) {
+            point.subjectScores.push_back(stored.values[v] == ABSENT_VALUE ? numeric_limits<double>::quiet_NaN()
+                                                                            : stored.values[v] / VALUE_SCALE);
+        }
+        points.push_back(move(point));
+    }
+    return points;
+}
+
+TrendSummary TrendStore::summarize(const std::vector<TrendPoint>& points) {
+    TrendSummary summary;
+    summary.points = points.size();
+    if (points.empty()) {
+        return summary;
+    }
+
+    summary.firstAverage = points.front().average;
+    summary.lastAverage = points.back().average;
+    summary.lowestAverage = summary.highestAverage = points.front().average;
+
+    // Least-squares slope of average against time, centred on the first point
+    double sumT = 0.0, sumA = 0.0, sumTT = 0.0, sumTA = 0.0;
+    for (const auto& point : points) {
+        double t = static_cast<double>(point.timestamp - points.front().timestamp) / SECONDS_PER_MONTH;
+        sumT += t;
+        sumA += point.average;
+        sumTT += t * t;
+        sumTA += t * point.average;
+        summary.lowestAverage = min(summary.lowestAverage, point.average);
+        summary.highestAverage = max(summary.highestAverage, point.average);
+    }
+    double n = static_cast<double>(points.size());
+    double denominator = n * sumTT - sumT * sumT;
+    if (denominator > 0.0) {
+        summary.slopePerMonth = (n * sumTA - sumT * sumA) / denominator;
+    }
+    return summary;
+}
+
+size_t TrendStore::snapshotCount() const {
+    return snapshotTimes.size();
+}
+
+size_t TrendStore::studentCount() const {
+    return series.size();
+}
+
+std::uint64_t TrendStore::storedBytes() const {
+    return validBytes;
+}
+
+std::uint64_t TrendStore::storedValues() const {
+    return valueCount;
+}
@@ -0,0 +1,190 @@
+#include "TestHarness.hpp"
+#include "BatchCli.hpp"
+#include "ExcelUtil.hpp"
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    struct CliRun {
+        int exitCode;
+        string output;
+    };
+
+    // BatchCli::run with its JSON line captured instead of printed
+    CliRun runCli(const vector<string>& arguments) {
+        ostringstream captured;
+        streambuf* terminal = cout.rdbuf(captured.rdbuf());
+        int code = 0;
+        try {
+            code = BatchCli::run(arguments);
+        } catch (...) {
+            cout.rdbuf(terminal);
+            throw;
+        }
+        cout.rdbuf(terminal);
+        return {code, captured.str()};
+    }
+
+    bool contains(const string& text, const string& part) {
+        return text.find(part) != string::npos;
+    }
+
+    Student withLogin(Student student, const string& username) {
+        student.setUsername(username);
+        student.setPassword(username + "123");
+        return student;
+    }
+
+    // Username by student ID, as student_credentials.xlsx records it
+    map<string, string> usernames(const string& credentialsFile) {
+        map<string, pair<string, string>> credentials;
+        ExcelUtils::loadCredentialsFromFile(credentialsFile, credentials);
+        map<string, string> byId;
+        for (const auto& entry : credentials) byId[entry.first] = entry.second.first;
+        return byId;
+    }
+
+    // A roster of two students with logins, and its credentials workbook
+    string writeRosterWithLogins(const TestDirectory& directory) {
+        string roster = directory.file("students.xlsx");
+        vector<Student> students = {
+            withLogin(makeStudent("STU001", "Sokha Chan", "sokha@gmail.com", 60), "sokha"),
+            withLogin(makeStudent("STU002", "Dara Keo", "dara@gmail.com", 70), "dara")
+        };
+        ExcelUtils::writeExcel(roster, students);
+        ExcelUtils::writeCredentialsExcel(directory.file("student_credentials.xlsx"), students);
+        return roster;
+    }
+}
+
+TEST(BatchCli, mergeMatchesStudentsByIdentityAndRenumbers) {
+    TestDirectory directory;
+    string roster = directory.file("students.xlsx");
+    ExcelUtils::writeExcel(roster, {
+        makeStudent("STU001", "Sokha Chan", "sokha@gmail.com", 60),
+        makeStudent("STU002", "Dara Keo", "dara@gmail.com", 70)
+    });
+
+    // A later export numbered the same students differently, and added one
+    string update = directory.file("update.xlsx");
+    ExcelUtils::writeExcel(update, {
+        makeStudent("STU001", "Lisa Heng", "lisa@gmail.com", 88),
+        makeStudent("STU002", "Sokha Chan", " Sokha@Gmail.com ", 95)
+    });
+
+    CliRun run = runCli({"merge", update, "--data", roster});
+    CHECK_EQ(run.exitCode, 0);
+    CHECK(contains(run.output, "\"added\":1"));
+    CHECK(contains(run.output, "\"updated\":1"));
+    CHECK(contains(run.output, "\"students\":3"));
+
+    // Renumbered in ID order, as an interactive import does: Sokha keeps
+    // STU001, and Lisa's STU001 from the update sorts after her
+    vector<Student> merged = ExcelUtils::readStudentRows(roster);
+    CHECK_EQ(merged.size(), size_t(3));
+    CHECK_EQ(merged[0].getName(), string("Sokha Chan"));
+    CHECK_NEAR(merged[0].getAverageScore(), 95.0, 1e-9);
+    CHECK_EQ(merged[1].getName(), string("Lisa Heng"));
+    CHECK_EQ(merged[2].getName(), string("Dara Keo"));
+    for (size_t i = 0; i < merged.size(); ++i) {
+        CHECK_EQ(merged[i].getStudentId(), "STU00" + to_string(i + 1));
+    }
+}
+
+TEST(BatchCli, mergeLaterWorkbooksWin) {
+    TestDirectory directory;
+    string roster = directory.file("students.xlsx");
+    string first = directory.file("first.xlsx");
+    string second = directory.file("second.xlsx");
+    ExcelUtils::writeExcel(first, {makeStudent("STU001", "Dara Keo", "dara@gmail.com", 50)});
+    ExcelUtils::writeExcel(second, {makeStudent("STU001", "Dara Keo", "dara@gmail.com", 75)});
+
+    // No roster yet: the merge creates it
+    CliRun run = runCli({"merge", first, second, "--data", roster});
+    CHECK_EQ(run.exitCode, 0);
+    CHECK(contains(run.output, "\"added\":1"));
+    CHECK(contains(run.output, "\"updated\":1"));
+
+    vector<Student> merged = ExcelUtils::readStudentRows(roster);
+    CHECK_EQ(merged.size(), size_t(1));
+    CHECK_NEAR(merged[0].getAverageScore(), 75.0, 1e-9);
+}
+
+TEST(BatchCli, mergeWithoutWorkbooksIsAUsageError) {
+    TestDirectory directory;
+    CliRun run = runCli({"merge", "--data", directory.file("students.xlsx")});
+    CHECK_EQ(run.exitCode, static_cast<int>(BatchExitCode::Usage));
+    CHECK(contains(run.output, "\"status\":\"error\""));
+}
+
+TEST(BatchCli, mergeOfAMissingWorkbookIsAnInputError) {
+    TestDirectory directory;
+    CliRun run = runCli({"merge", directory.file("absent.xlsx"), "--data", directory.file("students.xlsx")});
+    CHECK_EQ(run.exitCode, static_cast<int>(BatchExitCode::InputError));
+    CHECK(!ExcelUtils::fileExists(directory.file("students.xlsx")));
+}
+
+TEST(BatchCli, mergeKeepsLoginsAcrossRenumbering) {
+    TestDirectory directory;
+    string roster = writeRosterWithLogins(directory);
+    string update = directory.file("update.xlsx");
+    ExcelUtils::writeExcel(update, {
+        makeStudent("STU001", "Lisa Heng", "lisa@gmail.com", 88),
+        makeStudent("STU002", "Dara Keo", "dara@gmail.com", 95)
+    });
+
+    CliRun run = runCli({"merge", update, "--data", roster});
+    CHECK_EQ(run.exitCode, 0);
+
+    // Sokha, Lisa, Dara: Dara moved from STU002 to STU003 with the same login
+    map<string, string> logins = usernames(directory.file("student_credentials.xlsx"));
+    CHECK_EQ(logins.size(), size_t(3));
+    CHECK_EQ(logins["STU001"], string("sokha"));
+    CHECK_EQ(logins["STU002"], string(""));
+    CHECK_EQ(logins["STU003"], string("dara"));
+}
+
+TEST(BatchCli, importKeepsLoginsOfKnownStudents) {
+    TestDirectory directory;
+    string roster = writeRosterWithLogins(directory);
+
+    // The new workbook lists Dara first and adds Vanna
+    string input = directory.file("class.xlsx");
+    ExcelUtils::writeExcel(input, {
+        makeStudent("STU001", "Dara Keo", "dara@gmail.com", 72),
+        makeStudent("STU002", "Sokha Chan", "sokha@gmail.com", 64),
+        makeStudent("STU003", "Vanna Pen", "vanna@gmail.com", 58)
+    });
+
+    CliRun run = runCli({"import", input, "--data", roster});
+    CHECK_EQ(run.exitCode, 0);
+    CHECK(contains(run.output, "\"loginsKept\":2"));
+
+    vector<Student> imported = ExcelUtils::readStudentRows(roster);
+    CHECK_EQ(imported.size(), size_t(3));
+    CHECK_EQ(imported[0].getName(), string("Dara Keo"));
+    map<string, string> logins = usernames(directory.file("student_credentials.xlsx"));
+    CHECK_EQ(logins["STU001"], string("dara"));
+    CHECK_EQ(logins["STU002"], string("sokha"));
+    CHECK_EQ(logins["STU003"], string(""));
+}
+
+TEST(BatchCli, backupKeepsLogins) {
+    TestDirectory directory;
+    string roster = writeRosterWithLogins(directory);
+
+    // The backup is stamped to the second; look under both possible names
+    string before = "data/backups/backup_" + ExcelUtils::generateTimestampFilename("student_credentials.xlsx");
+    CliRun run = runCli({"backup", "--data", roster});
+    string after = "data/backups/backup_" + ExcelUtils::generateTimestampFilename("student_credentials.xlsx");
+    CHECK_EQ(run.exitCode, 0);
+    CHECK(contains(run.output, "\"logins\":2"));
+
+    map<string, string> logins = usernames(ExcelUtils::fileExists(after) ? after : before);
+    CHECK_EQ(logins["STU001"], string("sokha"));
+    CHECK_EQ(logins["STU002"], string("dara"));
+}
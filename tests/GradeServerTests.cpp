@@ -0,0 +1,149 @@
+#include "TestHarness.hpp"
+#include "ExcelUtil.hpp"
+#include "GradeServer.hpp"
+#include "JsonUtil.hpp"
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    // Roster plus credentials workbook, as the interactive app saves them.
+    // Two students share the auto-generated username "sokha".
+    struct ServerFixture {
+        TestDirectory directory;
+        vector<Student> students;
+        unique_ptr<GradeServer> server;
+
+        ServerFixture() {
+            students = {
+                makeStudent("STU001", "Sokha Chan", "sokha.chan@gmail.com", 81),
+                makeStudent("STU002", "Sokha Keo", "sokha.keo@gmail.com", 58),
+                makeStudent("STU003", "Dara Heng", "dara@gmail.com", 73)
+            };
+            const char* credentials[][2] = {{"sokha", "first"}, {"sokha", "second"}, {"dara", "third"}};
+            for (size_t i = 0; i < students.size(); ++i) {
+                students[i].setUsername(credentials[i][0]);
+                students[i].setPassword(credentials[i][1]);
+            }
+            save();
+
+            ServerOptions options;
+            options.rosterFile = directory.file("students.xlsx");
+            server.reset(new GradeServer(options));
+            server->loadRoster();
+        }
+
+        void save() {
+            ExcelUtils::writeExcel(directory.file("students.xlsx"), students);
+            ExcelUtils::writeCredentialsExcel(directory.file("student_credentials.xlsx"), students);
+        }
+
+        HttpResponse request(const string& method, const string& path, const string& token = "",
+                             const string& body = "") {
+            HttpRequest request;
+            request.method = method;
+            request.path = path;
+            request.body = body;
+            if (!token.empty()) request.headers["authorization"] = "Bearer " + token;
+            return server->handle(request);
+        }
+
+        // The token from a successful login, or a test failure
+        string login(const string& username, const string& password) {
+            HttpResponse response = request("POST", "/api/login", "",
+                JsonObject().add("username", username).add("password", password).str());
+            if (response.status != 200) TEST_FAIL("login as " << username << " returned " << response.status);
+            string token = JsonUtil::parseObject(response.body)["token"];
+            if (token.empty()) TEST_FAIL("login as " << username << " returned no token");
+            return token;
+        }
+    };
+
+    // Responses with nested objects are matched as text; JsonObject writes
+    // them compactly, "key":value
+    bool hasField(const HttpResponse& response, const string& key, const string& json) {
+        return response.body.find(JsonUtil::quote(key) + ":" + json) != string::npos;
+    }
+}
+
+TEST(GradeServer, healthNeedsNoSession) {
+    ServerFixture fixture;
+    CHECK_EQ(fixture.request("GET", "/api/health").status, 200);
+}
+
+TEST(GradeServer, adminSignsInAndListsStudents) {
+    ServerFixture fixture;
+    string token = fixture.login("scoreme.pro", "prome@123");
+    HttpResponse students = fixture.request("GET", "/api/students", token);
+    CHECK_EQ(students.status, 200);
+    CHECK(hasField(students, "count", "3,"));
+    CHECK_EQ(fixture.request("GET", "/api/students/STU003", token).status, 200);
+    CHECK_EQ(fixture.request("GET", "/api/students/STU999", token).status, 404);
+}
+
+TEST(GradeServer, wrongPasswordIsRejected) {
+    ServerFixture fixture;
+    HttpResponse response = fixture.request("POST", "/api/login", "",
+        JsonObject().add("username", "dara").add("password", "wrong").str());
+    CHECK_EQ(response.status, 401);
+    response = fixture.request("POST", "/api/login", "",
+        JsonObject().add("username", "nobody").add("password", "third").str());
+    CHECK_EQ(response.status, 401);
+    CHECK_EQ(fixture.request("POST", "/api/login", "", "not json").status, 400);
+}
+
+TEST(GradeServer, sharedUsernameSignsInTheStudentWhosePasswordMatches) {
+    ServerFixture fixture;
+    HttpResponse second = fixture.request("POST", "/api/login", "",
+        JsonObject().add("username", "sokha").add("password", "second").str());
+    CHECK_EQ(second.status, 200);
+    CHECK(hasField(second, "studentId", "\"STU002\""));
+
+    string token = JsonUtil::parseObject(second.body)["token"];
+    HttpResponse me = fixture.request("GET", "/api/me", token);
+    CHECK_EQ(me.status, 200);
+    CHECK(hasField(me, "studentId", "\"STU002\""));
+
+    string first = fixture.login("sokha", "first");
+    CHECK(hasField(fixture.request("GET", "/api/me", first), "studentId", "\"STU001\""));
+}
+
+TEST(GradeServer, studentsReadOnlyTheirOwnRecord) {
+    ServerFixture fixture;
+    string token = fixture.login("dara", "third");
+    CHECK_EQ(fixture.request("GET", "/api/students/STU003", token).status, 200);
+    CHECK_EQ(fixture.request("GET", "/api/students/STU001", token).status, 403);
+    CHECK_EQ(fixture.request("GET", "/api/students", token).status, 403);
+    CHECK_EQ(fixture.request("POST", "/api/reload", token).status, 403);
+}
+
+TEST(GradeServer, missingOrUnknownTokenIsUnauthorized) {
+    ServerFixture fixture;
+    CHECK_EQ(fixture.request("GET", "/api/me").status, 401);
+    CHECK_EQ(fixture.request("GET", "/api/me", "0123456789abcdef").status, 401);
+    CHECK_EQ(fixture.request("GET", "/api/stats").status, 401);
+}
+
+TEST(GradeServer, reloadEndsStudentSessionsButNotAdminSessions) {
+    ServerFixture fixture;
+    string admin = fixture.login("scoreme.pro", "prome@123");
+    string student = fixture.login("dara", "third");
+    CHECK_EQ(fixture.request("GET", "/api/me", student).status, 200);
+
+    // The reload renumbers the roster: Dara moves from STU003 to STU001
+    swap(fixture.students[0], fixture.students[2]);
+    for (size_t i = 0; i < fixture.students.size(); ++i) {
+        fixture.students[i].setStudentId("STU00" + to_string(i + 1));
+    }
+    fixture.save();
+    HttpResponse reload = fixture.request("POST", "/api/reload", admin);
+    CHECK_EQ(reload.status, 200);
+    CHECK(hasField(reload, "students", "3,"));
+
+    CHECK_EQ(fixture.request("GET", "/api/me", student).status, 401);
+    CHECK_EQ(fixture.request("GET", "/api/students", admin).status, 200);
+
+    string again = fixture.login("dara", "third");
+    CHECK(hasField(fixture.request("GET", "/api/me", again), "studentId", "\"STU001\""));
+}
@@ -0,0 +1,161 @@
+#include "TestHarness.hpp"
+#include "Gradebook.hpp"
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    vector<Student> roster(double sokha, double dara) {
+        return {
+            makeStudent("STU001", "Sokha Chan", "sokha@gmail.com", sokha),
+            makeStudent("STU002", "Dara Keo", "dara@gmail.com", dara)
+        };
+    }
+
+    // Credit-weighted mean of term GPAs, computed from scratch
+    double expectedGpa(const vector<pair<double, double>>& gpaAndCredits) {
+        double points = 0.0, credits = 0.0;
+        for (const auto& term : gpaAndCredits) {
+            points += term.first * term.second;
+            credits += term.second;
+        }
+        return credits > 0.0 ? points / credits : 0.0;
+    }
+}
+
+TEST(Gradebook, cumulativeGpaWeighsTermsByCredits) {
+    TestDirectory directory;
+    Gradebook book = Gradebook::open(directory.path().string());
+    vector<Student> first = roster(92, 55);
+    vector<Student> second = roster(68, 81);
+    second[0].setSubjectScores(vector<double>(7, 68.0), 0x0F);   // four subjects taken
+    CHECK(!book.recordTerm("2025 S1", first));
+    CHECK(!book.recordTerm("2025 S2", second));
+
+    const CumulativeRecord* sokha = book.cumulative(first[0]);
+    CHECK(sokha != nullptr);
+    CHECK_EQ(sokha->terms, size_t(2));
+    CHECK_NEAR(sokha->credits, 21.0 + 12.0, 1e-9);
+    CHECK_NEAR(sokha->gpa(), expectedGpa({{first[0].getGpa(), 21.0}, {second[0].getGpa(), 12.0}}), 1e-9);
+
+    const CumulativeRecord* dara = book.cumulative(first[1]);
+    CHECK(dara != nullptr);
+    CHECK_NEAR(dara->gpa(), expectedGpa({{first[1].getGpa(), 21.0}, {second[1].getGpa(), 21.0}}), 1e-9);
+    CHECK(book.cumulative(makeStudent("STU009", "Vanna Pen", "vanna@gmail.com", 70)) == nullptr);
+}
+
+TEST(Gradebook, correctionReplacesTheTermOnly) {
+    TestDirectory directory;
+    Gradebook book = Gradebook::open(directory.path().string());
+    vector<Student> first = roster(92, 55);
+    vector<Student> second = roster(68, 81);
+    book.recordTerm("2025 S1", first);
+    book.recordTerm("2025 S2", second);
+
+    vector<Student> corrected = roster(95, 40);
+    CHECK(book.recordTerm("2025 S1", corrected));
+    CHECK_EQ(book.terms().size(), size_t(2));
+    CHECK_NEAR(book.cumulative(first[0])->gpa(),
+               expectedGpa({{corrected[0].getGpa(), 21.0}, {second[0].getGpa(), 21.0}}), 1e-9);
+
+    // A student dropped from the corrected term keeps only their other terms
+    CHECK(book.recordTerm("2025 S1", {corrected[0]}));
+    const CumulativeRecord* dara = book.cumulative(first[1]);
+    CHECK(dara != nullptr);
+    CHECK_EQ(dara->terms, size_t(1));
+    CHECK_NEAR(dara->gpa(), second[1].getGpa(), 1e-9);
+
+    CHECK(book.recordTerm("2025 S2", {corrected[0]}));
+    CHECK(book.cumulative(first[1]) == nullptr);
+}
+
+TEST(Gradebook, ledgerReopensWithTheSameTotals) {
+    TestDirectory directory;
+    vector<Student> first = roster(92, 55);
+    vector<Student> second = roster(68, 81);
+    double sokhaGpa;
+    {
+        Gradebook book = Gradebook::open(directory.path().string());
+        book.recordTerm("2025 S1", first);
+        book.recordTerm("2025 S2", second);
+        book.recordTerm("2025 S1", roster(90, 60));
+        sokhaGpa = book.cumulative(first[0])->gpa();
+    }
+    Gradebook book = Gradebook::open(directory.path().string());
+    CHECK(book.hasTerm("2025 S1") && book.hasTerm("2025 S2"));
+    CHECK_NEAR(book.cumulative(first[0])->gpa(), sokhaGpa, 1e-6);
+
+    vector<TermSummary> summaries = book.termSummaries();
+    CHECK_EQ(summaries.size(), size_t(2));
+    CHECK_EQ(summaries[1].students, size_t(2));
+    CHECK_NEAR(summaries[1].meanAverage, (68.0 + 81.0) / 2.0, 1e-6);
+}
+
+TEST(Gradebook, studentsAreMatchedByIdentityNotId) {
+    TestDirectory directory;
+    Gradebook book = Gradebook::open(directory.path().string());
+    vector<Student> first = roster(92, 55);
+    book.recordTerm("2025 S1", first);
+
+    // Renumbered roster: the IDs swap, the people do not
+    vector<Student> second = roster(92, 55);
+    second[0].setStudentId("STU002");
+    second[1].setStudentId("STU001");
+    book.recordTerm("2025 S2", second);
+
+    book.applyTo(second);
+    CHECK_NEAR(second[0].getCumulativeGpa(), first[0].getGpa(), 1e-9);
+    CHECK_NEAR(second[1].getCumulativeGpa(), first[1].getGpa(), 1e-9);
+    CHECK_NEAR(second[0].getCumulativeCredits(), 42.0, 1e-9);
+
+    vector<Student> newcomer = {makeStudent("STU003", "Vanna Pen", "vanna@gmail.com", 70)};
+    book.applyTo(newcomer);
+    CHECK_EQ(newcomer[0].getCumulativeCredits(), 0.0);
+}
+
+TEST(Gradebook, idKeyedLedgerIsRekeyedFromWorkbooks) {
+    TestDirectory directory;
+    vector<Student> first = roster(92, 55);
+    {
+        Gradebook book = Gradebook::open(directory.path().string());
+        book.recordTerm("2025 S1", first);
+    }
+    // Rewrite the ledger as the first format would have: keyed by student ID
+    {
+        ofstream out(directory.file("gradebook.ledger"));
+        out << "SCOREME-GRADEBOOK 1\nT\t2025 S1\n"
+            << "E\t0\tSTU001\t92\t4\t21\nE\t0\tSTU002\t55\t1\t21\n";
+    }
+    Gradebook book = Gradebook::open(directory.path().string());
+    const CumulativeRecord* sokha = book.cumulative(first[0]);
+    CHECK(sokha != nullptr);
+    CHECK_NEAR(sokha->gpa(), first[0].getGpa(), 1e-9);
+
+    ifstream in(directory.file("gradebook.ledger"));
+    string magic;
+    getline(in, magic);
+    CHECK_EQ(magic, string("SCOREME-GRADEBOOK 2"));
+}
+
+TEST(Gradebook, badInputIsRejected) {
+    TestDirectory directory;
+    Gradebook book = Gradebook::open(directory.path().string());
+    CHECK_THROWS(book.recordTerm("", roster(70, 70)));
+    CHECK_THROWS(book.recordTerm("2025\tS1", roster(70, 70)));
+    CHECK(book.terms().empty());
+
+    {
+        ofstream out(directory.file("gradebook.ledger"));
+        out << "not a ledger\n";
+    }
+    CHECK_THROWS(Gradebook::open(directory.path().string()));
+}
+
+TEST(Gradebook, creditsCountOnlySubjectsTaken) {
+    Student student = makeStudent("STU001", "Sokha Chan", "sokha@gmail.com", 70);
+    CHECK_EQ(Gradebook::termCredits(student), 21.0);
+    student.setSubjectScores(vector<double>(7, 70.0), 0x05);
+    CHECK_EQ(Gradebook::termCredits(student), 6.0);
+}
@@ -0,0 +1,127 @@
+#include "TestHarness.hpp"
+#include "ExcelUtil.hpp"
+#include "ImportPipeline.hpp"
+#include <fstream>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    // Enough rows for many small batches, so batches finish out of order
+    vector<Student> numberedRoster(size_t count) {
+        static const vector<string> names = {"Sokha", "Dara", "Lisa", "Malis", "Vanna", "Piseth", "Chenda"};
+        vector<Student> students;
+        for (size_t i = 0; i < count; ++i) {
+            string name = names[i % names.size()] + " " + string(1, char('A' + i % 26)) + "ang";
+            students.push_back(makeStudent("STU" + to_string(1000 + i), name,
+                                           "student" + to_string(i) + "@gmail.com", 40.0 + double(i % 60)));
+        }
+        return students;
+    }
+}
+
+TEST(ImportPipeline, studentsComeBackInSheetOrder) {
+    TestDirectory directory;
+    string roster = directory.file("students.xlsx");
+    vector<Student> written = numberedRoster(300);
+    ExcelUtils::writeExcel(roster, written);
+
+    ImportOptions options;
+    options.filename = roster;
+    options.batchRows = 7;
+    options.queueDepth = 2;
+    ImportResult result = ImportPipeline::run(options);
+
+    CHECK(result.rejected.empty());
+    CHECK_EQ(result.students.size(), written.size());
+    CHECK_EQ(result.sheetRows.size(), written.size());
+    for (size_t i = 0; i < written.size(); ++i) {
+        CHECK_EQ(result.students[i].getStudentId(), written[i].getStudentId());
+        CHECK_EQ(result.sheetRows[i], uint32_t(i + 2));
+        CHECK_NEAR(result.students[i].getAverageScore(), written[i].getAverageScore(), 1e-9);
+    }
+    CHECK(result.validation.clean());
+    CHECK_EQ(result.validation.rowsChecked, written.size());
+}
+
+TEST(ImportPipeline, rowWithoutNameIsRejectedAndOthersKept) {
+    TestDirectory directory;
+    string roster = directory.file("students.xlsx");
+    vector<Student> written = numberedRoster(20);
+    written[5].setName("");
+    ExcelUtils::writeExcel(roster, written);
+
+    ImportOptions options;
+    options.filename = roster;
+    options.batchRows = 4;
+    ImportResult result = ImportPipeline::run(options);
+
+    CHECK_EQ(result.rejected.size(), size_t(1));
+    CHECK_EQ(result.rejected[0].row, 7);
+    CHECK_EQ(result.rejected[0].reason, string("missing name"));
+    CHECK_EQ(result.students.size(), size_t(19));
+    CHECK_EQ(result.students[5].getStudentId(), written[6].getStudentId());
+    CHECK_EQ(result.sheetRows[5], uint32_t(8));
+}
+
+TEST(ImportPipeline, rulesFlagRowsWithoutDroppingThem) {
+    TestDirectory directory;
+    string roster = directory.file("students.xlsx");
+    vector<Student> written = numberedRoster(12);
+    written[3].setEmail("student3@example.com");
+    written[9].setStudentId(written[2].getStudentId());
+    ExcelUtils::writeExcel(roster, written);
+
+    ImportOptions options;
+    options.filename = roster;
+    options.batchRows = 3;
+    ImportResult result = ImportPipeline::run(options);
+
+    CHECK_EQ(result.students.size(), size_t(12));
+    CHECK_EQ(result.validation.count(ValidationRule::Email), size_t(1));
+    CHECK_EQ(result.validation.count(ValidationRule::DuplicateId), size_t(1));
+    for (const auto& issue : result.validation.issues) {
+        if (issue.rule == ValidationRule::Email) CHECK_EQ(issue.row, uint32_t(5));
+        if (issue.rule == ValidationRule::DuplicateId) CHECK_EQ(issue.row, uint32_t(11));
+    }
+}
+
+TEST(ImportPipeline, credentialsAreAttachedById) {
+    TestDirectory directory;
+    string roster = directory.file("students.xlsx");
+    string credentials = directory.file("student_credentials.xlsx");
+    vector<Student> written = numberedRoster(10);
+    for (size_t i = 0; i < written.size(); ++i) {
+        written[i].setUsername("user" + to_string(i));
+        written[i].setPassword("secret" + to_string(i));
+    }
+    ImportPipeline::persist(written, roster, credentials);
+
+    ImportOptions options;
+    options.filename = roster;
+    options.credentialsFile = credentials;
+    options.batchRows = 3;
+    ImportResult result = ImportPipeline::run(options);
+
+    CHECK_EQ(result.students.size(), written.size());
+    for (size_t i = 0; i < written.size(); ++i) {
+        CHECK_EQ(result.students[i].getUsername(), written[i].getUsername());
+        CHECK_EQ(result.students[i].getPassword(), written[i].getPassword());
+    }
+}
+
+TEST(ImportPipeline, missingWorkbookThrows) {
+    TestDirectory directory;
+    ImportOptions options;
+    options.filename = directory.file("absent.xlsx");
+    CHECK_THROWS(ImportPipeline::run(options));
+}
+
+TEST(ImportPipeline, corruptWorkbookThrows) {
+    TestDirectory directory;
+    string roster = directory.file("students.xlsx");
+    ofstream(roster, ios::binary) << "not a zip archive";
+    ImportOptions options;
+    options.filename = roster;
+    CHECK_THROWS(ImportPipeline::run(options));
+}
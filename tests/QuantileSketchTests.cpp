@@ -0,0 +1,133 @@
+#include "TestHarness.hpp"
+#include "QuantileSketch.hpp"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    // 0..count-1 in a fixed shuffled order
+    vector<double> shuffledValues(size_t count, unsigned seed) {
+        vector<double> values(count);
+        for (size_t i = 0; i < count; ++i) values[i] = static_cast<double>(i);
+        shuffle(values.begin(), values.end(), mt19937(seed));
+        return values;
+    }
+
+    // The true rank of the sketch's answer must be within the error bound
+    void checkQuantiles(const QuantileSketch& sketch, size_t count) {
+        double tolerance = 2.0 * sketch.rankErrorBound();
+        for (double fraction : {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99}) {
+            double value = sketch.quantile(fraction);
+            double trueRank = (value + 1.0) / static_cast<double>(count);
+            CHECK_NEAR(trueRank, fraction, tolerance);
+        }
+    }
+}
+
+TEST(QuantileSketch, smallInputIsExact) {
+    QuantileSketch sketch;
+    for (double value : shuffledValues(101, 1)) sketch.update(value);
+    CHECK_EQ(sketch.count(), uint64_t(101));
+    CHECK_EQ(sketch.retainedItems(), size_t(101));
+    CHECK_EQ(sketch.quantile(0.5), 50.0);
+    CHECK_EQ(sketch.quantile(0.0), 0.0);
+    CHECK_EQ(sketch.quantile(1.0), 100.0);
+    CHECK_NEAR(sketch.rank(49.0), 50.0 / 101.0, 1e-12);
+}
+
+TEST(QuantileSketch, emptySketchAnswersZero) {
+    QuantileSketch sketch;
+    CHECK_EQ(sketch.count(), uint64_t(0));
+    CHECK_EQ(sketch.quantile(0.5), 0.0);
+    CHECK_EQ(sketch.rank(10.0), 0.0);
+    CHECK_EQ(sketch.minimum(), 0.0);
+    CHECK_EQ(sketch.maximum(), 0.0);
+}
+
+TEST(QuantileSketch, largeStreamStaysWithinTheErrorBound) {
+    const size_t count = 200000;
+    QuantileSketch sketch;
+    for (double value : shuffledValues(count, 7)) sketch.update(value);
+    CHECK_EQ(sketch.count(), uint64_t(count));
+    CHECK(sketch.retainedItems() < count / 50);
+    CHECK_EQ(sketch.minimum(), 0.0);
+    CHECK_EQ(sketch.maximum(), double(count - 1));
+    checkQuantiles(sketch, count);
+}
+
+TEST(QuantileSketch, mergedSketchesMatchOneStream) {
+    const size_t count = 120000;
+    vector<double> values = shuffledValues(count, 11);
+    QuantileSketch merged;
+    for (size_t part = 0; part < 12; ++part) {
+        QuantileSketch sketch;
+        for (size_t i = part * 10000; i < (part + 1) * 10000; ++i) sketch.update(values[i]);
+        merged.merge(sketch);
+    }
+    merged.merge(QuantileSketch());   // an empty sketch changes nothing
+    CHECK_EQ(merged.count(), uint64_t(count));
+    CHECK_EQ(merged.minimum(), 0.0);
+    CHECK_EQ(merged.maximum(), double(count - 1));
+    checkQuantiles(merged, count);
+}
+
+TEST(QuantileSketch, writeAndReadRoundTrip) {
+    QuantileSketch sketch(64);
+    for (double value : shuffledValues(30000, 3)) sketch.update(value / 7.0);
+
+    stringstream text;
+    sketch.write(text);
+    QuantileSketch copy = QuantileSketch::read(text);
+
+    CHECK_EQ(copy.count(), sketch.count());
+    CHECK_EQ(copy.retainedItems(), sketch.retainedItems());
+    CHECK_EQ(copy.minimum(), sketch.minimum());
+    CHECK_EQ(copy.maximum(), sketch.maximum());
+    for (double fraction : {0.1, 0.5, 0.9}) CHECK_EQ(copy.quantile(fraction), sketch.quantile(fraction));
+}
+
+TEST(QuantileSketch, malformedBlockThrows) {
+    stringstream text("sketch 200 5 1 2");
+    CHECK_THROWS(QuantileSketch::read(text));
+    stringstream truncated("sketch 200 3 1 3 1\n3 1 2");
+    CHECK_THROWS(QuantileSketch::read(truncated));
+}
+
+TEST(ScoreSketches, saveAndLoadKeepEveryColumn) {
+    TestDirectory directory;
+    vector<Student> students;
+    for (int i = 0; i < 50; ++i) {
+        students.push_back(makeStudent("STU" + to_string(i), "Student Name", "s" + to_string(i) + "@gmail.com", 40 + i));
+    }
+    ScoreSketches sketches = ScoreSketches::fromStudents(students);
+    string filename = ScoreSketches::sketchFilenameFor(directory.file("backup_students.xlsx"));
+    CHECK_EQ(filename, directory.file("backup_students.sketch"));
+    sketches.save(filename);
+
+    ScoreSketches loaded = ScoreSketches::load(filename);
+    CHECK(loaded.columnNames == sketches.columnNames);
+    const QuantileSketch* average = loaded.find(ScoreSketches::AVERAGE_COLUMN);
+    CHECK(average != nullptr);
+    CHECK_EQ(average->count(), uint64_t(50));
+    CHECK_EQ(average->quantile(0.5), sketches.find(ScoreSketches::AVERAGE_COLUMN)->quantile(0.5));
+    CHECK(loaded.find("No Such Subject") == nullptr);
+}
+
+TEST(ScoreSketches, mergeAddsCounts) {
+    vector<Student> students = {makeStudent("STU1", "Dara Keo", "dara@gmail.com", 70)};
+    ScoreSketches total = ScoreSketches::fromStudents(students);
+    total.merge(ScoreSketches::fromStudents(students));
+    CHECK_EQ(total.find(ScoreSketches::AVERAGE_COLUMN)->count(), uint64_t(2));
+}
+
+TEST(ScoreSketches, loadRejectsOtherFiles) {
+    TestDirectory directory;
+    CHECK_THROWS(ScoreSketches::load(directory.file("absent.sketch")));
+    string other = directory.file("other.sketch");
+    ofstream(other) << "SOMETHING-ELSE 1\n0\n";
+    CHECK_THROWS(ScoreSketches::load(other));
+}
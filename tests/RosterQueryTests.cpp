@@ -0,0 +1,97 @@
+#include "TestHarness.hpp"
+#include "RosterQuery.hpp"
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    vector<Student> roster() {
+        vector<Student> students = {
+            makeStudent("STU001", "Sokha Chan", "sokha@gmail.com", 45),
+            makeStudent("STU002", "Dara Keo", "dara@gmail.com", 92),
+            makeStudent("STU003", "Lisa Heng", "lisa@gmail.com", 67),
+            makeStudent("STU004", "Vanna Pen", "vanna@yahoo.com", 30),
+            makeStudent("STU005", "Malis Sok", "malis@gmail.com", 81)
+        };
+        students[1].setGender("Male");
+        students[3].setGender("Male");
+        students[2].setAge(23);
+        vector<double> scores(7, 81.0);
+        scores[0] = 99.0;   // Mathematics
+        students[4].setSubjectScores(scores);
+        return students;
+    }
+
+    vector<uint32_t> rows(const string& text) {
+        return RosterQuery::parse(text).run(roster());
+    }
+
+    // The parse error for text, or a test failure when it parses
+    string parseError(const string& text) {
+        try {
+            RosterQuery::parse(text);
+        } catch (const invalid_argument& e) {
+            return e.what();
+        }
+        TEST_FAIL("'" << text << "' parsed");
+        return "";
+    }
+}
+
+TEST(RosterQuery, emptyQueryMatchesEveryone) {
+    CHECK(rows("") == vector<uint32_t>({0, 1, 2, 3, 4}));
+}
+
+TEST(RosterQuery, numericComparisons) {
+    CHECK(rows("avg < 50") == vector<uint32_t>({0, 3}));
+    CHECK(rows("average >= 81") == vector<uint32_t>({1, 4}));
+    CHECK(rows("age = 23") == vector<uint32_t>({2}));
+    CHECK(rows("age != 20") == vector<uint32_t>({2}));
+    CHECK(rows("Mathematics > 90") == vector<uint32_t>({1, 4}));
+    CHECK(rows("physics<=45") == vector<uint32_t>({0, 3}));
+}
+
+TEST(RosterQuery, textFieldsIgnoreCase) {
+    CHECK(rows("gender = male") == vector<uint32_t>({1, 3}));
+    CHECK(rows("name contains SO") == vector<uint32_t>({0, 4}));
+    CHECK(rows("email ~ yahoo") == vector<uint32_t>({3}));
+    CHECK(rows("name = 'lisa heng'") == vector<uint32_t>({2}));
+    CHECK(rows("id = stu005") == vector<uint32_t>({4}));
+    CHECK(rows("dob = 2004-03-15 and gender <> Female") == vector<uint32_t>({1, 3}));
+}
+
+TEST(RosterQuery, andBindsTighterThanOr) {
+    CHECK(rows("gender = Male and avg > 90 or name ~ lisa") == vector<uint32_t>({1, 2}));
+    CHECK(rows("avg < 40 or avg > 90 or age = 23") == vector<uint32_t>({1, 2, 3}));
+    CHECK(rows("gender = Male and avg > 95").empty());
+}
+
+TEST(RosterQuery, orderByAndLimit) {
+    CHECK(rows("order by avg desc") == vector<uint32_t>({1, 4, 2, 0, 3}));
+    CHECK(rows("gender = Female order by name") == vector<uint32_t>({2, 4, 0}));
+    CHECK(rows("order by age desc, id desc limit 2") == vector<uint32_t>({2, 4}));
+    CHECK(rows("avg > 40 order by Mathematics desc limit 1") == vector<uint32_t>({4}));
+    CHECK(rows("limit 0").empty());
+}
+
+TEST(RosterQuery, errorsNameTheProblem) {
+    CHECK_EQ(parseError("height > 3"), string("Unknown field 'height'"));
+    CHECK_EQ(parseError("avg 50"), string("Expected an operator after 'avg', found '50'"));
+    CHECK_EQ(parseError("avg <"), string("Expected a value after 'avg' at end of query"));
+    CHECK_EQ(parseError("avg < high"), string("Expected a number for 'avg', found 'high'"));
+    CHECK_EQ(parseError("avg ~ 5"), string("'contains' only applies to text fields, not 'avg'"));
+    CHECK_EQ(parseError("avg < 50 gender = Male"), string("Expected 'and', 'or', 'order by' or 'limit', found 'gender'"));
+    CHECK_EQ(parseError("avg < 50 and"), string("Expected a condition after 'and' at end of query"));
+    CHECK_EQ(parseError("name = 'Sokha"), string("Unterminated quote at position 8"));
+    CHECK_EQ(parseError("order avg"), string("Expected 'by' after 'order'"));
+    CHECK_EQ(parseError("order by gender"), string("Cannot order by 'gender'"));
+    CHECK_EQ(parseError("limit ten"), string("Expected a whole number after 'limit', found 'ten'"));
+    CHECK_EQ(parseError("limit 5 avg > 3"), string("Unexpected 'avg' at end of query"));
+}
+
+TEST(RosterQuery, helpListsEverySubject) {
+    string help = RosterQuery::syntaxHelp();
+    CHECK(help.find("Mathematics") != string::npos);
+    CHECK(help.find("contains") != string::npos);
+}
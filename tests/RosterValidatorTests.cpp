@@ -0,0 +1,146 @@
+#include "TestHarness.hpp"
+#include "Admin.hpp"
+#include "RosterValidator.hpp"
+#include <vector>
+
+using namespace std;
+
+namespace {
+    vector<Student> cleanRoster() {
+        return {
+            makeStudent("STU001", "Sokha Chan", "sokha@gmail.com", 81),
+            makeStudent("STU002", "Dara Keo", "dara@gmail.com", 64),
+            makeStudent("STU003", "Lisa Heng", "lisa@gmail.com", 92)
+        };
+    }
+
+    // The only issue in the report, or a test failure
+    ValidationIssue onlyIssue(const ValidationReport& report) {
+        if (report.issues.size() != 1) TEST_FAIL("expected one issue, got " << report.issues.size());
+        return report.issues.front();
+    }
+}
+
+TEST(RosterValidator, cleanRosterHasNoIssues) {
+    ValidationReport report = RosterValidator::validate(cleanRoster());
+    CHECK(report.clean());
+    CHECK_EQ(report.rowsChecked, size_t(3));
+    CHECK_EQ(report.rowsWithIssues(), size_t(0));
+}
+
+TEST(RosterValidator, nameWithDigitsIsReported) {
+    vector<Student> students = cleanRoster();
+    students[1].setName("Dara 2");
+    ValidationReport report = RosterValidator::validate(students);
+    ValidationIssue issue = onlyIssue(report);
+    CHECK(issue.rule == ValidationRule::Name);
+    CHECK_EQ(issue.row, uint32_t(3));   // sheet rows start below the header
+    CHECK_EQ(report.count(ValidationRule::Name), size_t(1));
+}
+
+TEST(RosterValidator, emailOutsideGmailIsReported) {
+    vector<Student> students = cleanRoster();
+    students[0].setEmail("sokha@example.com");
+    ValidationReport report = RosterValidator::validate(students);
+    CHECK(onlyIssue(report).rule == ValidationRule::Email);
+    CHECK_EQ(onlyIssue(report).row, uint32_t(2));
+}
+
+TEST(RosterValidator, unknownGenderIsReported) {
+    vector<Student> students = cleanRoster();
+    students[2].setGender("Unknown");
+    ValidationReport report = RosterValidator::validate(students);
+    CHECK(onlyIssue(report).rule == ValidationRule::Gender);
+    CHECK_EQ(RosterValidator::columnName(onlyIssue(report)), string("Gender"));
+}
+
+TEST(RosterValidator, badDatesOfBirthAreReported) {
+    vector<Student> students = cleanRoster();
+    students[0].setDateOfBirth("15/03/2004");
+    students[1].setDateOfBirth("2031-01-01");
+    students[2].setDateOfBirth("2004-13-01");
+    ValidationReport report = RosterValidator::validate(students);
+    CHECK_EQ(report.count(ValidationRule::DateOfBirth), size_t(3));
+    CHECK_EQ(report.issues.size(), size_t(3));
+}
+
+TEST(RosterValidator, daysPastTheEndOfTheMonthAreReported) {
+    vector<Student> students = cleanRoster();
+    students[0].setDateOfBirth("2023-02-31");
+    students[1].setDateOfBirth("2023-04-31");
+    students[2].setDateOfBirth("2023-02-29");
+    CHECK_EQ(RosterValidator::validate(students).count(ValidationRule::DateOfBirth), size_t(3));
+
+    students[0].setDateOfBirth("2024-02-29");   // leap year
+    students[1].setDateOfBirth("2023-04-30");
+    students[2].setDateOfBirth("2000-02-29");   // divisible by 400
+    CHECK(RosterValidator::validate(students).clean());
+
+    CHECK(!Admin::isValidDate("1900-02-29"));   // divisible by 100, not 400
+    CHECK(Admin::isValidDate("2004-12-31"));
+}
+
+TEST(RosterValidator, datesWithNonDigitsAreReported) {
+    vector<Student> students = cleanRoster();
+    students[0].setDateOfBirth("2000-1a-05");
+    students[1].setDateOfBirth("2000-01-0x");
+    students[2].setDateOfBirth("+200-01-05");
+    CHECK_EQ(RosterValidator::validate(students).count(ValidationRule::DateOfBirth), size_t(3));
+
+    CHECK(!Admin::isValidDate("2000- 1-05"));
+    CHECK(!Admin::isValidDate("2000-01-5 "));
+}
+
+TEST(RosterValidator, scoreOutOfRangeIsReportedPerSubject) {
+    vector<Student> students = cleanRoster();
+    vector<double> scores(7, 70.0);
+    scores[2] = 104.0;
+    scores[5] = -1.0;
+    students[1].setSubjectScores(scores);
+    ValidationReport report = RosterValidator::validate(students);
+    CHECK_EQ(report.count(ValidationRule::Score), size_t(2));
+    CHECK_EQ(report.rowsWithIssues(), size_t(1));
+    CHECK(report.issues[0].column < report.issues[1].column);
+}
+
+TEST(RosterValidator, subjectNotTakenIsNotAScoreIssue) {
+    vector<Student> students = cleanRoster();
+    vector<double> scores(7, 55.0);
+    scores[6] = 500.0;
+    students[0].setSubjectScores(scores, 0x3F);   // the out-of-range subject was not taken
+    CHECK(RosterValidator::validate(students).clean());
+}
+
+TEST(RosterValidator, duplicateIdsAndEmailsPointAtLaterRows) {
+    vector<Student> students = cleanRoster();
+    students.push_back(makeStudent("STU002", "Malis Sok", "malis@gmail.com", 70));
+    students.push_back(makeStudent("STU005", "Vanna Pen", "SOKHA@gmail.com", 70));
+    ValidationReport report = RosterValidator::validate(students);
+    CHECK_EQ(report.count(ValidationRule::DuplicateId), size_t(1));
+    CHECK_EQ(report.count(ValidationRule::DuplicateEmail), size_t(1));
+    for (const auto& issue : report.issues) {
+        if (issue.rule == ValidationRule::DuplicateId) CHECK_EQ(issue.row, uint32_t(5));
+        if (issue.rule == ValidationRule::DuplicateEmail) CHECK_EQ(issue.row, uint32_t(6));
+    }
+}
+
+TEST(RosterValidator, sheetRowsNumberTheIssues) {
+    vector<Student> students = cleanRoster();
+    students[2].setGender("?");
+    ValidationReport report = RosterValidator::validate(students, {4, 9, 17});
+    CHECK_EQ(onlyIssue(report).row, uint32_t(17));
+}
+
+TEST(RosterValidator, issuesAreSortedByRowThenColumn) {
+    vector<Student> students = cleanRoster();
+    students[2].setName("L1sa");
+    students[2].setEmail("lisa@yahoo.com");
+    students[0].setGender("?");
+    ValidationReport report = RosterValidator::validate(students);
+    CHECK_EQ(report.issues.size(), size_t(3));
+    for (size_t i = 1; i < report.issues.size(); ++i) {
+        const auto& a = report.issues[i - 1];
+        const auto& b = report.issues[i];
+        CHECK(a.row < b.row || (a.row == b.row && a.column < b.column));
+    }
+}
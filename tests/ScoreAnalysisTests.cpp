@@ -0,0 +1,95 @@
+#include "TestHarness.hpp"
+#include "ScoreAnalysis.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    double sortedMedian(vector<double> values) {
+        sort(values.begin(), values.end());
+        size_t middle = values.size() / 2;
+        return values.size() % 2 == 1 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+    }
+}
+
+TEST(ScoreAnalysis, medianOfSmallInputs) {
+    CHECK_EQ(ScoreAnalysis::median({}), 0.0);
+    CHECK_EQ(ScoreAnalysis::median({7.0}), 7.0);
+    CHECK_EQ(ScoreAnalysis::median({3.0, 1.0}), 2.0);
+    CHECK_EQ(ScoreAnalysis::median({5.0, 1.0, 9.0, 3.0, 7.0}), 5.0);
+}
+
+// Above 4096 values the median goes through the histogram path
+TEST(ScoreAnalysis, histogramMedianMatchesSorting) {
+    mt19937 random(42);
+    for (size_t count : {size_t(4096), size_t(4097), size_t(10000), size_t(10001), size_t(65536)}) {
+        uniform_real_distribution<double> uniform(-50.0, 150.0);
+        vector<double> values(count);
+        for (auto& value : values) value = uniform(random);
+        CHECK_EQ(ScoreAnalysis::median(values), sortedMedian(values));
+
+        // Whole-number scores: long runs of ties inside one bucket
+        uniform_int_distribution<int> scores(0, 100);
+        for (auto& value : values) value = scores(random);
+        CHECK_EQ(ScoreAnalysis::median(values), sortedMedian(values));
+    }
+}
+
+TEST(ScoreAnalysis, histogramMedianHandlesSkewAndTies) {
+    // One extreme value squeezes everything else into the first bucket
+    vector<double> skewed(9000, 0.0);
+    for (size_t i = 0; i < skewed.size(); ++i) skewed[i] = static_cast<double>(i % 97) / 1000.0;
+    skewed[123] = 1e9;
+    CHECK_EQ(ScoreAnalysis::median(skewed), sortedMedian(skewed));
+
+    // The two middle values fall in different buckets
+    vector<double> split(5000, 0.0);
+    fill(split.begin() + 2500, split.end(), 100.0);
+    CHECK_EQ(ScoreAnalysis::median(split), 50.0);
+
+    vector<double> constant(8000, 64.5);
+    CHECK_EQ(ScoreAnalysis::median(constant), 64.5);
+}
+
+TEST(ScoreAnalysis, flagsAScoreFarFromTheCohortAndTheStudent) {
+    vector<Student> students;
+    mt19937 random(3);
+    normal_distribution<double> score(70.0, 6.0);
+    for (int i = 0; i < 400; ++i) {
+        vector<double> scores(7);
+        for (auto& value : scores) value = round(min(99.0, max(30.0, score(random))));
+        Student student = makeStudent("STU" + to_string(i), "Student Name", "s" + to_string(i) + "@gmail.com", 0);
+        student.setSubjectScores(scores);
+        students.push_back(student);
+    }
+    vector<double> odd = students[17].getSubjectScores();
+    odd[2] = 2.0;
+    students[17].setSubjectScores(odd);
+
+    AnomalyReport report = ScoreAnalysis::analyze(students, 5);
+    CHECK(!report.outliers.empty());
+    CHECK(report.outliers.size() <= 5);
+    CHECK_EQ(report.outliers[0].row, uint32_t(17));
+    CHECK_EQ(report.outliers[0].subjectIndex, size_t(2));
+    CHECK(report.flaggedScores >= report.outliers.size());
+    CHECK_EQ(report.correlation.size(), report.subjects.size());
+    for (size_t s = 0; s < report.subjects.size(); ++s) CHECK_NEAR(report.correlation[s][s], 1.0, 1e-9);
+}
+
+TEST(ScoreAnalysis, perfectScoreSpikeIsReported) {
+    vector<Student> students;
+    for (int i = 0; i < 200; ++i) {
+        vector<double> scores(7, 60.0 + i % 30);
+        if (i % 4 == 0) scores[1] = 100.0;
+        Student student = makeStudent("STU" + to_string(i), "Student Name", "s" + to_string(i) + "@gmail.com", 0);
+        student.setSubjectScores(scores);
+        students.push_back(student);
+    }
+    AnomalyReport report = ScoreAnalysis::analyze(students);
+    CHECK_EQ(report.spikes.size(), size_t(1));
+    CHECK_EQ(report.spikes[0].subjectIndex, size_t(1));
+    CHECK_EQ(report.spikes[0].perfectCount, size_t(50));
+}
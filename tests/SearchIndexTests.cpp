@@ -0,0 +1,127 @@
+#include "TestHarness.hpp"
+#include "SearchIndex.hpp"
+#include <vector>
+
+using namespace std;
+
+namespace {
+    vector<Student> roster() {
+        return {
+            makeStudent("STU001", "Sokha Chan", "sokha@gmail.com", 70),
+            makeStudent("STU002", "Sophanny Nai", "sophanny@gmail.com", 70),
+            makeStudent("STU003", "Dara Keo", "dara@gmail.com", 70),
+            makeStudent("STU004", "Chantrea Longname", "chantrea@gmail.com", 70),
+            makeStudent("STU005", "Sokha Heng", "sokha.heng@gmail.com", 70)
+        };
+    }
+
+    SearchIndex indexOf(const vector<Student>& students) {
+        SearchIndex index;
+        index.rebuild(students);
+        return index;
+    }
+
+    bool hasRow(const vector<SearchHit>& hits, uint32_t row) {
+        for (const auto& hit : hits) {
+            if (hit.row == row) return true;
+        }
+        return false;
+    }
+}
+
+TEST(SearchIndex, studentIdMatchesExactly) {
+    SearchIndex index = indexOf(roster());
+    CHECK_EQ(index.size(), size_t(5));
+    vector<SearchHit> hits = index.search("stu003");
+    CHECK(!hits.empty());
+    CHECK_EQ(hits[0].row, uint32_t(2));
+    CHECK(hits[0].kind == MatchKind::ExactId);
+    CHECK_EQ(hits[0].score, 1.0);
+}
+
+TEST(SearchIndex, exactNameRanksAboveAPrefix) {
+    SearchIndex index = indexOf(roster());
+    vector<SearchHit> hits = index.search("  SOKHA   chan ");
+    CHECK(!hits.empty());
+    CHECK_EQ(hits[0].row, uint32_t(0));
+    CHECK(hits[0].kind == MatchKind::ExactName);
+}
+
+TEST(SearchIndex, prefixOfAnyTokenMatches) {
+    SearchIndex index = indexOf(roster());
+    vector<SearchHit> hits = index.search("sok");
+    CHECK_EQ(hits.size(), size_t(2));
+    CHECK(hasRow(hits, 0) && hasRow(hits, 4));
+    for (const auto& hit : hits) CHECK(hit.kind == MatchKind::Prefix);
+
+    hits = index.search("longn");   // second token
+    CHECK_EQ(hits.size(), size_t(1));
+    CHECK_EQ(hits[0].row, uint32_t(3));
+    CHECK(hits[0].kind == MatchKind::Prefix);
+}
+
+TEST(SearchIndex, longerPrefixScoresHigher) {
+    SearchIndex index = indexOf(roster());
+    double shortScore = index.search("cha")[0].score;
+    double longScore = index.search("chantrea long")[0].score;
+    CHECK(longScore > shortScore);
+}
+
+TEST(SearchIndex, typosFindFuzzyMatches) {
+    SearchIndex index = indexOf(roster());
+    vector<SearchHit> hits = index.search("Chantraa Longnme");
+    CHECK(!hits.empty());
+    CHECK_EQ(hits[0].row, uint32_t(3));
+    CHECK(hits[0].kind == MatchKind::Fuzzy);
+    CHECK_EQ(hits[0].distance, 2);
+
+    hits = index.search("Sophany");   // one missing letter of a single token
+    CHECK(!hits.empty());
+    CHECK_EQ(hits[0].row, uint32_t(1));
+}
+
+TEST(SearchIndex, unrelatedTermFindsNothing) {
+    SearchIndex index = indexOf(roster());
+    CHECK(index.search("Zzyzx Qwerty").empty());
+    CHECK(index.search("").empty());
+    CHECK(index.search("!!!").empty());
+    CHECK(index.search("sokha", 0).empty());
+}
+
+TEST(SearchIndex, limitKeepsTheBestHits) {
+    vector<Student> students;
+    for (int i = 0; i < 40; ++i) {
+        students.push_back(makeStudent("STU" + to_string(100 + i), "Vanna Student", "v" + to_string(i) + "@gmail.com", 70));
+    }
+    students.push_back(makeStudent("STU200", "Vanna", "vanna@gmail.com", 70));
+    SearchIndex index = indexOf(students);
+    vector<SearchHit> hits = index.search("vanna", 5);
+    CHECK_EQ(hits.size(), size_t(5));
+    CHECK_EQ(hits[0].row, uint32_t(40));
+    for (size_t i = 1; i < hits.size(); ++i) CHECK(hits[i - 1].score >= hits[i].score);
+}
+
+TEST(SearchIndex, updateFollowsRenamesAndNewIds) {
+    vector<Student> students = roster();
+    SearchIndex index = indexOf(students);
+    students[2].setName("Malis Sok");
+    students[2].setStudentId("STU010");
+    index.update(2, students[2]);
+
+    CHECK(!hasRow(index.search("dara"), 2));
+    CHECK(hasRow(index.search("malis"), 2));
+    CHECK(index.search("stu003").empty());
+    CHECK_EQ(index.search("stu010")[0].row, uint32_t(2));
+
+    index.add(5, makeStudent("STU006", "Dara Ouk", "ouk@gmail.com", 70));
+    CHECK_EQ(index.size(), size_t(6));
+    CHECK_EQ(index.search("dara")[0].row, uint32_t(5));
+}
+
+TEST(SearchIndex, normalizeAndEditDistance) {
+    CHECK_EQ(SearchIndex::normalize("  O'Neil--Sok  Chan "), string("o neil sok chan"));
+    CHECK_EQ(SearchIndex::editDistance("kitten", "sitting", 5), 3);
+    CHECK_EQ(SearchIndex::editDistance("kitten", "sitting", 2), 3);   // gives up past the bound
+    CHECK_EQ(SearchIndex::editDistance("dara", "dara", 1), 0);
+    CHECK_EQ(SearchIndex::editDistance("a", "abcdef", 2), 3);
+}
@@ -0,0 +1,164 @@
+#include "TestHarness.hpp"
+#include "SortEngine.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    // Large enough for the radix path, with many ties on every key
+    vector<Student> randomRoster(size_t count, unsigned seed) {
+        static const vector<string> names = {
+            "Sokha Chan", "sokha chan", "Dara  Keo", "Lisa Heng", "Chantrea Longname A", "Chantrea Longname B",
+            "Chantrea Longname", "Malis", "Vanna Pen", "Piseth Ouk"
+        };
+        mt19937 random(seed);
+        uniform_int_distribution<int> score(0, 20);
+        vector<Student> students;
+        students.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            Student student = makeStudent("STU" + to_string(100 + random() % 900), names[random() % names.size()],
+                                          "s" + to_string(i) + "@gmail.com", 0);
+            vector<double> scores(7);
+            for (auto& value : scores) value = score(random) * 5.0;
+            student.setSubjectScores(scores, random() % 4 == 0 ? 0x7E : 0x7F);
+            student.setAge(17 + static_cast<int>(random() % 8));
+            students.push_back(student);
+        }
+        return students;
+    }
+
+    // std::stable_sort with a comparator built from the same order
+    vector<uint32_t> referenceOrder(const vector<Student>& students, const vector<SortSpec>& order) {
+        auto compare = [&](uint32_t a, uint32_t b) {
+            for (const auto& spec : order) {
+                const Student& x = students[spec.descending ? b : a];
+                const Student& y = students[spec.descending ? a : b];
+                switch (spec.key) {
+                    case SortKey::AverageScore:
+                        if (x.getAverageScore() != y.getAverageScore()) return x.getAverageScore() < y.getAverageScore();
+                        break;
+                    case SortKey::Name: {
+                        string p = SortEngine::collationKey(x.getName()), q = SortEngine::collationKey(y.getName());
+                        if (p != q) return p < q;
+                        break;
+                    }
+                    case SortKey::StudentNumber: {
+                        int p = SortEngine::parseStudentNumber(x.getStudentId());
+                        int q = SortEngine::parseStudentNumber(y.getStudentId());
+                        if (p != q) return p < q;
+                        break;
+                    }
+                    case SortKey::Age:
+                        if (x.getAge() != y.getAge()) return x.getAge() < y.getAge();
+                        break;
+                    case SortKey::Gpa:
+                        if (x.getGpa() != y.getGpa()) return x.getGpa() < y.getGpa();
+                        break;
+                    case SortKey::SubjectScore: {
+                        double p = x.hasScore(spec.subjectIndex) ? x.getSubjectScores()[spec.subjectIndex] : -1.0;
+                        double q = y.hasScore(spec.subjectIndex) ? y.getSubjectScores()[spec.subjectIndex] : -1.0;
+                        if (p != q) return p < q;
+                        break;
+                    }
+                }
+            }
+            return false;
+        };
+        vector<uint32_t> rows(students.size());
+        iota(rows.begin(), rows.end(), 0u);
+        stable_sort(rows.begin(), rows.end(), compare);
+        return rows;
+    }
+
+    void checkMatchesReference(const vector<Student>& students, const vector<SortSpec>& order) {
+        vector<uint32_t> sorted = SortEngine::sortedPermutation(students, order);
+        vector<uint32_t> expected = referenceOrder(students, order);
+        CHECK_EQ(sorted.size(), expected.size());
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            if (sorted[i] != expected[i]) TEST_FAIL("rows differ at position " << i);
+        }
+    }
+}
+
+TEST(SortEngine, singleKeysMatchAStableSort) {
+    for (size_t count : {size_t(50), size_t(6000)}) {
+        vector<Student> students = randomRoster(count, 5);
+        checkMatchesReference(students, {{SortKey::AverageScore, true}});
+        checkMatchesReference(students, {{SortKey::AverageScore, false}});
+        checkMatchesReference(students, {{SortKey::Name, false}});
+        checkMatchesReference(students, {{SortKey::StudentNumber, true}});
+        checkMatchesReference(students, {{SortKey::Age, false}});
+        checkMatchesReference(students, {{SortKey::Gpa, true}});
+    }
+}
+
+TEST(SortEngine, multiKeyOrdersMatchAStableSort) {
+    vector<Student> students = randomRoster(7000, 9);
+    checkMatchesReference(students, {{SortKey::AverageScore, true}, {SortKey::Name, false}});
+    checkMatchesReference(students, {{SortKey::Age, false}, {SortKey::Gpa, true}, {SortKey::StudentNumber, false}});
+    checkMatchesReference(students, {{SortKey::Name, true}, {SortKey::AverageScore, false}});
+}
+
+TEST(SortEngine, tiesKeepRosterOrder) {
+    vector<Student> students = randomRoster(5000, 13);
+    vector<uint32_t> sorted = SortEngine::sortedPermutation(students, {{SortKey::Age, true}});
+    for (size_t i = 1; i < sorted.size(); ++i) {
+        if (students[sorted[i - 1]].getAge() == students[sorted[i]].getAge()) CHECK(sorted[i - 1] < sorted[i]);
+    }
+}
+
+TEST(SortEngine, subjectNotTakenSortsBelowZero) {
+    vector<Student> students = randomRoster(3000, 17);
+    students[10].setSubjectScores(vector<double>(7, 0.0));
+    checkMatchesReference(students, {{SortKey::SubjectScore, false, 0}, {SortKey::Name, false}});
+    vector<uint32_t> sorted = SortEngine::sortedPermutation(students, {{SortKey::SubjectScore, false, 0}});
+    CHECK(!students[sorted.front()].hasScore(0));
+    CHECK(students[sorted.back()].hasScore(0));
+}
+
+TEST(SortEngine, negativeAndZeroKeysOrderNumerically) {
+    vector<Student> students = randomRoster(4, 19);
+    vector<double> scores(7, 0.0);
+    scores[0] = -5.0;
+    students[0].setSubjectScores(scores);
+    scores[0] = -0.0;
+    students[1].setSubjectScores(scores);
+    scores[0] = 0.5;
+    students[2].setSubjectScores(scores);
+    scores[0] = -0.25;
+    students[3].setSubjectScores(scores);
+    vector<uint32_t> sorted = SortEngine::sortedPermutation(students, {{SortKey::SubjectScore, false, 0}});
+    CHECK(sorted == vector<uint32_t>({0, 3, 1, 2}));
+}
+
+TEST(SortEngine, sortRowsReordersOnlyTheSelection) {
+    vector<Student> students = randomRoster(3000, 23);
+    vector<uint32_t> rows;
+    for (uint32_t i = 0; i < students.size(); i += 3) rows.push_back(i);
+    SortEngine::sortRows(students, rows, {{SortKey::AverageScore, true}, {SortKey::Name, false}});
+    CHECK_EQ(rows.size(), size_t(1000));
+    for (size_t i = 0; i < rows.size(); ++i) CHECK_EQ(rows[i] % 3, 0u);
+    for (size_t i = 1; i < rows.size(); ++i) {
+        CHECK(students[rows[i - 1]].getAverageScore() >= students[rows[i]].getAverageScore());
+    }
+}
+
+TEST(SortEngine, applyPermutationMovesStudents) {
+    vector<Student> students = randomRoster(6, 29);
+    vector<string> emails;
+    for (const auto& student : students) emails.push_back(student.getEmail());
+    SortEngine::applyPermutation(students, {5, 4, 3, 2, 1, 0});
+    for (size_t i = 0; i < students.size(); ++i) CHECK_EQ(students[i].getEmail(), emails[5 - i]);
+}
+
+TEST(SortEngine, studentNumbersAndCollationKeys) {
+    CHECK_EQ(SortEngine::parseStudentNumber("STU012"), 12);
+    CHECK_EQ(SortEngine::parseStudentNumber("STU1234"), 1234);
+    CHECK_EQ(SortEngine::parseStudentNumber("STU01"), 0);
+    CHECK_EQ(SortEngine::parseStudentNumber("ABC123"), 0);
+    CHECK_EQ(SortEngine::collationKey("  Sokha   CHAN "), string("sokha chan"));
+    CHECK_EQ(SortEngine::collationKey(""), string(""));
+}
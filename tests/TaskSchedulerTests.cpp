@@ -0,0 +1,112 @@
+#include "TestHarness.hpp"
+#include "TaskScheduler.hpp"
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST(TaskScheduler, parallelForVisitsEveryIndexOnce) {
+    TaskScheduler scheduler(4);
+    vector<atomic<int>> visits(10007);
+    bool finished = scheduler.parallelFor(visits.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) visits[i]++;
+    });
+    CHECK(finished);
+    for (auto& count : visits) CHECK_EQ(count.load(), 1);
+}
+
+TEST(TaskScheduler, parallelForSmallCountRunsInline) {
+    TaskScheduler scheduler(4);
+    thread::id caller = this_thread::get_id();
+    bool inlineOnly = true;
+    scheduler.parallelFor(10, 100, [&](size_t begin, size_t end) {
+        CHECK_EQ(begin, size_t(0));
+        CHECK_EQ(end, size_t(10));
+        if (this_thread::get_id() != caller) inlineOnly = false;
+    });
+    CHECK(inlineOnly);
+}
+
+TEST(TaskScheduler, parallelForReportsProgressToTheTotal) {
+    TaskScheduler scheduler(3);
+    size_t last = 0, total = 0;
+    bool monotonic = true;
+    scheduler.parallelFor(5000, 100, [](size_t, size_t) {}, nullptr, [&](size_t completed, size_t count) {
+        if (completed < last) monotonic = false;
+        last = completed;
+        total = count;
+    });
+    CHECK(monotonic);
+    CHECK_EQ(last, size_t(5000));
+    CHECK_EQ(total, size_t(5000));
+}
+
+TEST(TaskScheduler, parallelForStopsWhenCancelled) {
+    TaskScheduler scheduler(2);
+    CancellationToken token;
+    token.cancel();
+    atomic<size_t> ran{0};
+    bool finished = scheduler.parallelFor(100000, 10, [&](size_t begin, size_t end) { ran += end - begin; }, &token);
+    CHECK(!finished);
+    CHECK_EQ(ran.load(), size_t(0));
+}
+
+TEST(TaskScheduler, parallelForRethrowsTaskExceptions) {
+    TaskScheduler scheduler(4);
+    CHECK_THROWS(scheduler.parallelFor(1000, 10, [](size_t begin, size_t) {
+        if (begin >= 500) throw runtime_error("boom");
+    }));
+}
+
+TEST(TaskScheduler, parallelReduceMatchesSerialSum) {
+    TaskScheduler scheduler(4);
+    vector<long long> values(100003);
+    iota(values.begin(), values.end(), 1);
+    long long total = scheduler.parallelReduce(values.size(), 1000, 0LL,
+        [&](size_t begin, size_t end) { return accumulate(values.begin() + begin, values.begin() + end, 0LL); },
+        [](long long& sum, long long part) { sum += part; });
+    CHECK_EQ(total, accumulate(values.begin(), values.end(), 0LL));
+}
+
+TEST(TaskScheduler, parallelReduceCombinesChunksInIndexOrder) {
+    TaskScheduler scheduler(4);
+    vector<size_t> order = scheduler.parallelReduce(20000, 100, vector<size_t>(),
+        [](size_t begin, size_t) { return vector<size_t>{begin}; },
+        [](vector<size_t>& all, const vector<size_t>& part) { all.insert(all.end(), part.begin(), part.end()); });
+    CHECK(order.size() > 1);
+    for (size_t i = 1; i < order.size(); ++i) CHECK(order[i - 1] < order[i]);
+}
+
+TEST(TaskScheduler, nestedParallelForCompletes) {
+    TaskScheduler scheduler(2);
+    atomic<size_t> inner{0};
+    scheduler.parallelFor(8, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            scheduler.parallelFor(1000, 10, [&](size_t b, size_t e) { inner += e - b; });
+        }
+    });
+    CHECK_EQ(inner.load(), size_t(8000));
+}
+
+TEST(TaskScheduler, jobQueueRunsJobsInOrderOneAtATime) {
+    TaskScheduler scheduler(4);
+    JobQueue jobs(scheduler);
+    atomic<int> running{0};
+    bool overlapped = false;
+    vector<int> order;
+    for (int i = 0; i < 20; ++i) {
+        jobs.submit([&, i] {
+            if (running.fetch_add(1) != 0) overlapped = true;
+            order.push_back(i);
+            this_thread::sleep_for(chrono::microseconds(200));
+            running--;
+        });
+    }
+    jobs.wait();
+    CHECK(!overlapped);
+    CHECK_EQ(order.size(), size_t(20));
+    for (int i = 0; i < 20; ++i) CHECK_EQ(order[i], i);
+    CHECK_EQ(jobs.pending(), size_t(0));
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Student.hpp"
+
+// Minimal test registry for scoreme_tests. A test is a function declared
+// with TEST(Suite, name); the CHECK macros throw TestFailure, which ends
+// that test only. scoreme_tests [Suite] runs every test, or one suite.
+struct TestFailure : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+struct TestCase {
+    std::string suite;
+    std::string name;
+    void (*body)();
+};
+
+std::vector<TestCase>& testRegistry();
+
+struct TestRegistrar {
+    TestRegistrar(const char* suite, const char* name, void (*body)()) {
+        testRegistry().push_back({suite, name, body});
+    }
+};
+
+#define TEST(suite, name)                                                  \
+    static void suite##_##name();                                          \
+    static TestRegistrar suite##_##name##_registrar(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+
+#define TEST_FAIL(message)                                                  \
+    do {                                                                   \
+        std::ostringstream testMessage;                                    \
+        testMessage << __FILE__ << ":" << __LINE__ << ": " << message;     \
+        throw TestFailure(testMessage.str());                              \
+    } while (false)
+
+#define CHECK(condition)                                                    \
+    do {                                                                   \
+        if (!(condition)) TEST_FAIL("CHECK(" #condition ") failed");       \
+    } while (false)
+
+#define CHECK_EQ(actual, expected)                                          \
+    do {                                                                   \
+        auto testActual = (actual);        /* copies: actual may name part of a temporary */ \
+        auto testExpected = (expected);                                    \
+        if (!(testActual == testExpected)) {                               \
+            TEST_FAIL(#actual " == " #expected " failed: got " << testActual << ", expected " << testExpected); \
+        }                                                                  \
+    } while (false)
+
+#define CHECK_NEAR(actual, expected, tolerance)                             \
+    do {                                                                   \
+        double testActual = (actual);                                      \
+        double testExpected = (expected);                                  \
+        if (!(testActual >= testExpected - (tolerance) && testActual <= testExpected + (tolerance))) { \
+            TEST_FAIL(#actual " ~ " #expected " failed: got " << testActual << ", expected " << testExpected); \
+        }                                                                  \
+    } while (false)
+
+#define CHECK_THROWS(expression)                                            \
+    do {                                                                   \
+        bool testThrew = false;                                            \
+        try {                                                              \
+            (void)(expression);                                            \
+        } catch (const std::exception&) {                                  \
+            testThrew = true;                                              \
+        }                                                                  \
+        if (!testThrew) TEST_FAIL(#expression " did not throw");           \
+    } while (false)
+
+// Fresh directory under the system temp directory, removed afterwards
+class TestDirectory {
+public:
+    TestDirectory();
+    ~TestDirectory();
+
+    TestDirectory(const TestDirectory&) = delete;
+    TestDirectory& operator=(const TestDirectory&) = delete;
+
+    std::string file(const std::string& name) const;
+    const std::filesystem::path& path() const { return root; }
+
+private:
+    std::filesystem::path root;
+};
+
+// A student that passes every RosterValidator rule
+Student makeStudent(const std::string& id, const std::string& name, const std::string& email, double score);
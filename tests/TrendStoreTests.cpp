@@ -0,0 +1,104 @@
+#include "TestHarness.hpp"
+#include "TrendStore.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    const int64_t DAY = 24 * 60 * 60;
+}
+
+TEST(TrendStore, missingFileOpensEmpty) {
+    TestDirectory directory;
+    TrendStore store = TrendStore::open(directory.file("trends.store"));
+    CHECK_EQ(store.snapshotCount(), size_t(0));
+    CHECK_EQ(store.studentCount(), size_t(0));
+    CHECK(store.history(makeStudent("STU001", "Sokha Chan", "sokha@gmail.com", 70)).empty());
+}
+
+TEST(TrendStore, appendedSnapshotsSurviveReopening) {
+    TestDirectory directory;
+    string filename = directory.file("trends.store");
+    vector<Student> first = {
+        makeStudent("STU001", "Sokha Chan", "sokha@gmail.com", 70.25),
+        makeStudent("STU002", "Dara Keo", "dara@gmail.com", 55.5)
+    };
+    vector<double> scores(7, 71.0);
+    scores[3] = 88.75;
+    first[0].setSubjectScores(scores);
+    {
+        TrendStore store = TrendStore::open(filename);
+        store.append(first, 1000 * DAY);
+    }
+
+    // The next backup renumbers the roster: IDs swap, identities do not
+    vector<Student> second = first;
+    second[0].setStudentId("STU002");
+    second[1].setStudentId("STU001");
+    second[1].setSubjectScores(vector<double>(7, 61.0));
+    {
+        TrendStore store = TrendStore::open(filename);
+        store.append(second, 1030 * DAY);
+    }
+
+    TrendStore store = TrendStore::open(filename);
+    CHECK_EQ(store.snapshotCount(), size_t(2));
+    CHECK_EQ(store.studentCount(), size_t(2));
+
+    vector<TrendPoint> sokha = store.history(second[0]);
+    CHECK_EQ(sokha.size(), size_t(2));
+    CHECK_EQ(sokha[0].timestamp, 1000 * DAY);
+    CHECK_EQ(sokha[1].timestamp, 1030 * DAY);
+    CHECK_NEAR(sokha[0].average, first[0].getAverageScore(), 0.005);
+    CHECK_EQ(sokha[1].subjectScores.size(), size_t(7));
+    CHECK_NEAR(sokha[1].subjectScores[3], 88.75, 0.005);
+
+    vector<TrendPoint> dara = store.history(second[1]);
+    CHECK_EQ(dara.size(), size_t(2));
+    CHECK_NEAR(dara[0].average, 55.5, 0.005);
+    CHECK_NEAR(dara[1].average, 61.0, 0.005);
+
+    TrendSummary summary = TrendStore::summarize(dara);
+    CHECK_EQ(summary.points, size_t(2));
+    CHECK_NEAR(summary.slopePerMonth, 5.5, 0.01);
+}
+
+TEST(TrendStore, subjectNotTakenReadsBackAsNaN) {
+    TestDirectory directory;
+    string filename = directory.file("trends.store");
+    Student student = makeStudent("STU001", "Sokha Chan", "sokha@gmail.com", 80);
+    student.setSubjectScores(vector<double>(7, 80.0), 0x7D);   // subject 1 not taken
+    {
+        TrendStore store = TrendStore::open(filename);
+        store.append({student}, 500 * DAY);
+    }
+    vector<TrendPoint> points = TrendStore::open(filename).history(student);
+    CHECK_EQ(points.size(), size_t(1));
+    CHECK(std::isnan(points[0].subjectScores[1]));
+    CHECK_NEAR(points[0].subjectScores[0], 80.0, 0.005);
+}
+
+TEST(TrendStore, truncatedAppendIsIgnored) {
+    TestDirectory directory;
+    string filename = directory.file("trends.store");
+    Student student = makeStudent("STU001", "Sokha Chan", "sokha@gmail.com", 64);
+    {
+        TrendStore store = TrendStore::open(filename);
+        store.append({student}, 100 * DAY);
+        store.append({student}, 101 * DAY);
+    }
+    // Cut the second block short, as an interrupted backup would
+    auto size = filesystem::file_size(filename);
+    filesystem::resize_file(filename, size - 3);
+
+    TrendStore store = TrendStore::open(filename);
+    CHECK_EQ(store.snapshotCount(), size_t(1));
+    store.append({student}, 102 * DAY);
+
+    vector<TrendPoint> points = TrendStore::open(filename).history(student);
+    CHECK_EQ(points.size(), size_t(2));
+    CHECK_EQ(points[1].timestamp, 102 * DAY);
+}
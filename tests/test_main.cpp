@@ -0,0 +1,66 @@
+// scoreme_tests: runs every registered test, or the suite named on the
+// command line, and exits non-zero when any test fails.
+#include "TestHarness.hpp"
+#include "MenuUtils.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+std::vector<TestCase>& testRegistry() {
+    static vector<TestCase> tests;
+    return tests;
+}
+
+TestDirectory::TestDirectory() {
+    static atomic<unsigned> counter{0};
+    auto stamp = chrono::steady_clock::now().time_since_epoch().count();
+    root = filesystem::temp_directory_path() /
+           ("scoreme_test_" + to_string(stamp) + "_" + to_string(counter++) + "_" + to_string(random_device()()));
+    filesystem::create_directories(root);
+}
+
+TestDirectory::~TestDirectory() {
+    error_code ignored;
+    filesystem::remove_all(root, ignored);
+}
+
+std::string TestDirectory::file(const std::string& name) const {
+    return (root / name).string();
+}
+
+Student makeStudent(const std::string& id, const std::string& name, const std::string& email, double score) {
+    return Student(id, name, 20, "Female", "2004-03-15", email, vector<double>(7, score));
+}
+
+int main(int argc, char* argv[]) {
+    string suite = argc > 1 ? argv[1] : "";
+
+    // Status messages from the code under test go to stderr, without colors or screens
+    MenuUtils::setHeadless(true);
+
+    size_t ran = 0, failed = 0;
+    for (const auto& test : testRegistry()) {
+        if (!suite.empty() && test.suite != suite) continue;
+        ran++;
+        try {
+            test.body();
+            cout << "[ ok ] " << test.suite << "." << test.name << "\n";
+        } catch (const TestFailure& e) {
+            failed++;
+            cout << "[FAIL] " << test.suite << "." << test.name << "\n       " << e.what() << "\n";
+        } catch (const exception& e) {
+            failed++;
+            cout << "[FAIL] " << test.suite << "." << test.name << "\n       unexpected exception: " << e.what() << "\n";
+        }
+    }
+
+    if (ran == 0) {
+        cerr << "no tests" << (suite.empty() ? "" : " in suite " + suite) << "\n";
+        return 1;
+    }
+    cout << ran - failed << "/" << ran << " passed\n";
+    return failed > 0 ? 1 : 0;
+}